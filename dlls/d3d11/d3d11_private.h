@@ -21,6 +21,7 @@
 
 #include "wine/debug.h"
 #include "wine/heap.h"
+#include "wine/list.h"
 
 #include <assert.h>
 
@@ -529,6 +530,74 @@ struct d3d11_immediate_context
     struct wined3d_private_store private_store;
 };
 
+/* The state set on a deferred context, as returned by its Get methods. Every
+ * non-NULL object holds a reference. */
+struct d3d11_deferred_state
+{
+    IUnknown *shaders[WINED3D_SHADER_TYPE_COUNT];
+    IUnknown *constant_buffers[WINED3D_SHADER_TYPE_COUNT][D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT];
+    IUnknown *shader_resources[WINED3D_SHADER_TYPE_COUNT][D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT];
+    IUnknown *samplers[WINED3D_SHADER_TYPE_COUNT][D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT];
+    IUnknown *cs_uavs[D3D11_PS_CS_UAV_REGISTER_COUNT];
+
+    IUnknown *input_layout;
+    IUnknown *vertex_buffers[D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT];
+    UINT strides[D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT];
+    UINT offsets[D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT];
+    IUnknown *index_buffer;
+    DXGI_FORMAT index_format;
+    UINT index_offset;
+    D3D11_PRIMITIVE_TOPOLOGY topology;
+
+    IUnknown *rtvs[D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT];
+    IUnknown *dsv;
+    IUnknown *uavs[D3D11_PS_CS_UAV_REGISTER_COUNT];
+    IUnknown *blend_state;
+    float blend_factor[4];
+    UINT sample_mask;
+    IUnknown *depth_stencil_state;
+    UINT stencil_ref;
+
+    IUnknown *so_buffers[D3D11_SO_BUFFER_SLOT_COUNT];
+
+    IUnknown *rasterizer_state;
+    UINT viewport_count;
+    D3D11_VIEWPORT viewports[D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE];
+    UINT scissor_rect_count;
+    D3D11_RECT scissor_rects[D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE];
+
+    IUnknown *predicate;
+    BOOL predicate_value;
+};
+
+/* ID3D11DeviceContext - deferred context */
+struct d3d11_deferred_context
+{
+    ID3D11DeviceContext1 ID3D11DeviceContext1_iface;
+    LONG refcount;
+
+    struct wined3d_private_store private_store;
+    ID3D11Device2 *device;
+    UINT flags;
+
+    struct list commands;
+    struct list maps;
+    struct d3d11_deferred_state state;
+};
+
+/* ID3D11CommandList */
+struct d3d11_command_list
+{
+    ID3D11CommandList ID3D11CommandList_iface;
+    LONG refcount;
+
+    struct wined3d_private_store private_store;
+    ID3D11Device2 *device;
+    UINT flags;
+
+    struct list commands;
+};
+
 /* ID3D11Device, ID3D10Device1 */
 struct d3d_device
 {
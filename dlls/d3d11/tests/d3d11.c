@@ -28162,6 +28162,119 @@ static void test_staging_buffers(void)
     release_test_context(&test_context);
 }
 
+static void test_deferred_context(void)
+{
+    static const float green[] = {0.0f, 1.0f, 0.0f, 1.0f};
+    static const float red[] = {1.0f, 0.0f, 0.0f, 1.0f};
+
+    ID3D11DeviceContext *context, *deferred_context;
+    struct d3d11_test_context test_context;
+    ID3D11Buffer *dynamic_buffer, *buffer;
+    D3D11_MAPPED_SUBRESOURCE map_desc;
+    ID3D11RenderTargetView *tmp_rtv;
+    D3D11_BUFFER_DESC buffer_desc;
+    ID3D11CommandList *list;
+    struct resource_readback rb;
+    ID3D11Device *device;
+    unsigned int i;
+    float value;
+    HRESULT hr;
+
+    if (!init_test_context(&test_context, NULL))
+        return;
+    device = test_context.device;
+    context = test_context.immediate_context;
+
+    hr = ID3D11Device_CreateDeferredContext(device, 0, &deferred_context);
+    ok(hr == S_OK, "Failed to create deferred context, hr %#x.\n", hr);
+    ok(ID3D11DeviceContext_GetType(deferred_context) == D3D11_DEVICE_CONTEXT_DEFERRED,
+            "Got unexpected context type %#x.\n", ID3D11DeviceContext_GetType(deferred_context));
+
+    ID3D11DeviceContext_ClearRenderTargetView(context, test_context.backbuffer_rtv, red);
+    ID3D11DeviceContext_ClearRenderTargetView(deferred_context, test_context.backbuffer_rtv, green);
+    check_texture_color(test_context.backbuffer, 0xff0000ff, 0);
+
+    hr = ID3D11DeviceContext_FinishCommandList(deferred_context, FALSE, &list);
+    ok(hr == S_OK, "Failed to finish command list, hr %#x.\n", hr);
+    check_texture_color(test_context.backbuffer, 0xff0000ff, 0);
+
+    ID3D11DeviceContext_OMSetRenderTargets(context, 1, &test_context.backbuffer_rtv, NULL);
+    ID3D11DeviceContext_ExecuteCommandList(context, list, TRUE);
+    check_texture_color(test_context.backbuffer, 0xff00ff00, 0);
+    ID3D11DeviceContext_OMGetRenderTargets(context, 1, &tmp_rtv, NULL);
+    ok(tmp_rtv == test_context.backbuffer_rtv, "Got unexpected render target view %p.\n", tmp_rtv);
+    ID3D11RenderTargetView_Release(tmp_rtv);
+
+    ID3D11DeviceContext_ExecuteCommandList(context, list, FALSE);
+    ID3D11DeviceContext_OMGetRenderTargets(context, 1, &tmp_rtv, NULL);
+    ok(!tmp_rtv, "Got unexpected render target view %p.\n", tmp_rtv);
+    ID3D11CommandList_Release(list);
+
+    ID3D11DeviceContext_OMSetRenderTargets(deferred_context, 1, &test_context.backbuffer_rtv, NULL);
+    ID3D11DeviceContext_OMGetRenderTargets(deferred_context, 1, &tmp_rtv, NULL);
+    ok(tmp_rtv == test_context.backbuffer_rtv, "Got unexpected render target view %p.\n", tmp_rtv);
+    ID3D11RenderTargetView_Release(tmp_rtv);
+
+    hr = ID3D11DeviceContext_FinishCommandList(deferred_context, TRUE, &list);
+    ok(hr == S_OK, "Failed to finish command list, hr %#x.\n", hr);
+    ID3D11CommandList_Release(list);
+    ID3D11DeviceContext_OMGetRenderTargets(deferred_context, 1, &tmp_rtv, NULL);
+    ok(tmp_rtv == test_context.backbuffer_rtv, "Got unexpected render target view %p.\n", tmp_rtv);
+    ID3D11RenderTargetView_Release(tmp_rtv);
+
+    hr = ID3D11DeviceContext_FinishCommandList(deferred_context, FALSE, &list);
+    ok(hr == S_OK, "Failed to finish command list, hr %#x.\n", hr);
+    ID3D11CommandList_Release(list);
+    ID3D11DeviceContext_OMGetRenderTargets(deferred_context, 1, &tmp_rtv, NULL);
+    ok(!tmp_rtv, "Got unexpected render target view %p.\n", tmp_rtv);
+
+    buffer_desc.ByteWidth = 16 * sizeof(float);
+    buffer_desc.Usage = D3D11_USAGE_DYNAMIC;
+    buffer_desc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+    buffer_desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+    buffer_desc.MiscFlags = 0;
+    buffer_desc.StructureByteStride = 0;
+    hr = ID3D11Device_CreateBuffer(device, &buffer_desc, NULL, &dynamic_buffer);
+    ok(hr == S_OK, "Failed to create buffer, hr %#x.\n", hr);
+
+    buffer_desc.Usage = D3D11_USAGE_DEFAULT;
+    buffer_desc.CPUAccessFlags = 0;
+    hr = ID3D11Device_CreateBuffer(device, &buffer_desc, NULL, &buffer);
+    ok(hr == S_OK, "Failed to create buffer, hr %#x.\n", hr);
+
+    hr = ID3D11DeviceContext_Map(deferred_context, (ID3D11Resource *)dynamic_buffer,
+            0, D3D11_MAP_WRITE_DISCARD, 0, &map_desc);
+    ok(hr == S_OK, "Failed to map buffer, hr %#x.\n", hr);
+    for (i = 0; i < 8; ++i)
+        ((float *)map_desc.pData)[i] = i;
+    ID3D11DeviceContext_Unmap(deferred_context, (ID3D11Resource *)dynamic_buffer, 0);
+    hr = ID3D11DeviceContext_Map(deferred_context, (ID3D11Resource *)dynamic_buffer,
+            0, D3D11_MAP_WRITE_NO_OVERWRITE, 0, &map_desc);
+    ok(hr == S_OK, "Failed to map buffer, hr %#x.\n", hr);
+    for (i = 8; i < 16; ++i)
+        ((float *)map_desc.pData)[i] = i;
+    ID3D11DeviceContext_Unmap(deferred_context, (ID3D11Resource *)dynamic_buffer, 0);
+    ID3D11DeviceContext_CopyResource(deferred_context, (ID3D11Resource *)buffer, (ID3D11Resource *)dynamic_buffer);
+
+    hr = ID3D11DeviceContext_FinishCommandList(deferred_context, FALSE, &list);
+    ok(hr == S_OK, "Failed to finish command list, hr %#x.\n", hr);
+    ID3D11DeviceContext_ExecuteCommandList(context, list, FALSE);
+    ID3D11CommandList_Release(list);
+
+    get_buffer_readback(buffer, &rb);
+    for (i = 0; i < 16; ++i)
+    {
+        value = get_readback_float(&rb, i, 0);
+        ok(value == i, "Got unexpected value %.8e at %u.\n", value, i);
+    }
+    release_resource_readback(&rb);
+
+    ID3D11Buffer_Release(buffer);
+    ID3D11Buffer_Release(dynamic_buffer);
+    ID3D11DeviceContext_Release(deferred_context);
+    release_test_context(&test_context);
+}
+
 START_TEST(d3d11)
 {
     unsigned int argc, i;
@@ -28310,6 +28423,7 @@ START_TEST(d3d11)
     queue_test(test_sample_mask);
     queue_test(test_depth_clip);
     queue_test(test_staging_buffers);
+    queue_test(test_deferred_context);
 
     run_queued_tests();
 }
@@ -518,7 +518,8 @@ static const struct window_surface_funcs dib_surface_funcs =
     dib_surface_get_bounds,
     dib_surface_set_region,
     dib_surface_flush,
-    dib_surface_destroy
+    dib_surface_destroy,
+    NULL  /* add_damage */
 };
 
 /***********************************************************************
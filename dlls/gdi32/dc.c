@@ -50,10 +50,11 @@ static const struct gdi_obj_funcs dc_funcs =
 };
 
 
+/* the DC is only protected from being freed, its fields are owned by the thread holding a reference */
 static inline DC *get_dc_obj( HDC hdc )
 {
     WORD type;
-    DC *dc = get_any_obj_ptr( hdc, &type );
+    DC *dc = grab_gdi_handle( hdc, &type );
     if (!dc) return NULL;
 
     switch (type)
@@ -64,7 +65,7 @@ static inline DC *get_dc_obj( HDC hdc )
     case OBJ_ENHMETADC:
         return dc;
     default:
-        GDI_ReleaseObj( hdc );
+        release_gdi_handle();
         SetLastError( ERROR_INVALID_HANDLE );
         return NULL;
     }
@@ -205,7 +206,7 @@ DC *get_dc_ptr( HDC hdc )
     if (!dc) return NULL;
     if (dc->disabled)
     {
-        GDI_ReleaseObj( hdc );
+        release_gdi_handle();
         return NULL;
     }
 
@@ -216,12 +217,12 @@ DC *get_dc_ptr( HDC hdc )
     else if (dc->thread != GetCurrentThreadId())
     {
         WARN( "dc %p belongs to thread %04x\n", hdc, dc->thread );
-        GDI_ReleaseObj( hdc );
+        release_gdi_handle();
         return NULL;
     }
     else InterlockedIncrement( &dc->refcount );
 
-    GDI_ReleaseObj( hdc );
+    release_gdi_handle();
     return dc;
 }
 
@@ -1279,7 +1280,7 @@ WORD WINAPI SetHookFlags( HDC hdc, WORD flags )
     else if (flags & DCHF_ENABLEDC)
         ret = InterlockedExchange( &dc->disabled, 0 );
 
-    GDI_ReleaseObj( hdc );
+    release_gdi_handle();
 
     if (flags & DCHF_RESETDC) ret = reset_dc_state( hdc );
     return ret;
@@ -21,6 +21,7 @@
 #include <assert.h>
 
 #include "gdi_private.h"
+#include "winternl.h"
 #include "dibdrv.h"
 
 #include "wine/debug.h"
@@ -466,6 +467,285 @@ static int get_overlap( const dib_info *dst, const RECT *dst_rect,
     return ret;
 }
 
+/* Large operations are split into horizontal bands rendered in parallel on the
+ * thread pool. The primitives work from absolute coordinates and each band
+ * only touches its own scanlines, so the result is the same as a single pass.
+ * The calling thread renders every band no worker has picked up yet, and only
+ * waits for the bands being rendered, never for a worker to start: that could
+ * deadlock if the thread pool needs a lock the caller holds. */
+
+#define BAND_MIN_PIXELS (256 * 1024)
+#define BAND_MAX_COUNT  16
+
+enum band_op
+{
+    BAND_SOLID,
+    BAND_PATTERN,
+    BAND_COPY,
+    BAND_BLEND,
+    BAND_GRADIENT
+};
+
+struct band_work
+{
+    enum band_op         op;
+    const dib_info      *dst;
+    const dib_info      *src;
+    int                  count;
+    const RECT          *rects;
+    const RECT          *dst_rect;    /* copy and blend: maps rects to the source */
+    const RECT          *src_rect;
+    const POINT         *brush_org;
+    const rop_mask_bits *bits;
+    DWORD                and;
+    DWORD                xor;
+    int                  rop2;
+    BLENDFUNCTION        blend;
+    const TRIVERTEX     *vert;
+    int                  mode;
+    BOOL                 ret;
+    int                  top;
+    int                  bottom;
+    int                  band_height;
+};
+
+/* bands shared with the workers, which may only start once the caller has returned */
+struct band_queue
+{
+    struct band_work    *work;        /* only valid while there are bands left */
+    LONG                 refcount;
+    LONG                 next_band;
+    LONG                 band_count;
+    LONG                 done_bands;  /* protected by band_section */
+    CONDITION_VARIABLE   done;
+};
+
+static CRITICAL_SECTION band_section;
+static CRITICAL_SECTION_DEBUG band_critsect_debug =
+{
+    0, 0, &band_section,
+    { &band_critsect_debug.ProcessLocksList, &band_critsect_debug.ProcessLocksList },
+      0, 0, { (DWORD_PTR)(__FILE__ ": band_section") }
+};
+static CRITICAL_SECTION band_section = { &band_critsect_debug, -1, 0, 0, 0, 0 };
+
+static void render_band( struct band_work *work, int top, int bottom )
+{
+    const dib_info *dst = work->dst;
+    POINT origin;
+    RECT rc;
+    int i;
+
+    for (i = 0; i < work->count; i++)
+    {
+        rc = work->rects[i];
+        if (rc.top < top) rc.top = top;
+        if (rc.bottom > bottom) rc.bottom = bottom;
+        if (rc.top >= rc.bottom) continue;
+
+        if (work->op == BAND_COPY || work->op == BAND_BLEND)
+        {
+            origin.x = work->src_rect->left + rc.left - work->dst_rect->left;
+            origin.y = work->src_rect->top  + rc.top  - work->dst_rect->top;
+        }
+
+        switch (work->op)
+        {
+        case BAND_SOLID:
+            dst->funcs->solid_rects( dst, 1, &rc, work->and, work->xor );
+            break;
+        case BAND_PATTERN:
+            dst->funcs->pattern_rects( dst, 1, &rc, work->brush_org, work->src, work->bits );
+            break;
+        case BAND_COPY:
+            dst->funcs->copy_rect( dst, &rc, work->src, &origin, work->rop2, 0 );
+            break;
+        case BAND_BLEND:
+            dst->funcs->blend_rect( dst, &rc, work->src, &origin, work->blend );
+            break;
+        case BAND_GRADIENT:
+            if (!dst->funcs->gradient_rect( dst, &rc, work->vert, work->mode )) work->ret = FALSE;
+            break;
+        }
+    }
+}
+
+static void release_band_queue( struct band_queue *queue )
+{
+    if (!InterlockedDecrement( &queue->refcount )) HeapFree( GetProcessHeap(), 0, queue );
+}
+
+static void render_pending_bands( struct band_queue *queue )
+{
+    struct band_work *work;
+    LONG band;
+
+    while ((band = InterlockedIncrement( &queue->next_band ) - 1) < queue->band_count)
+    {
+        int top;
+
+        work = queue->work;
+        top = work->top + band * work->band_height;
+        render_band( work, top, min( top + work->band_height, work->bottom ));
+
+        EnterCriticalSection( &band_section );
+        if (++queue->done_bands == queue->band_count) WakeAllConditionVariable( &queue->done );
+        LeaveCriticalSection( &band_section );
+    }
+}
+
+static void CALLBACK band_worker( TP_CALLBACK_INSTANCE *instance, void *context )
+{
+    struct band_queue *queue = context;
+
+    render_pending_bands( queue );
+    release_band_queue( queue );
+}
+
+static int get_max_bands(void)
+{
+    static int max_bands;
+
+    if (!max_bands)
+    {
+        SYSTEM_INFO info;
+
+        GetSystemInfo( &info );
+        max_bands = max( 1, min( info.dwNumberOfProcessors, BAND_MAX_COUNT ));
+    }
+    return max_bands;
+}
+
+static BOOL render_banded( struct band_work *work )
+{
+    struct band_queue *queue;
+    ULONGLONG area = 0;
+    int i, height, bands, workers, submitted;
+
+    work->ret = TRUE;
+    if (!work->count) return TRUE;
+
+    work->top = work->rects[0].top;
+    work->bottom = work->rects[0].bottom;
+    for (i = 0; i < work->count; i++)
+    {
+        const RECT *rc = &work->rects[i];
+
+        if (rc->left >= rc->right || rc->top >= rc->bottom) continue;
+        area += (ULONGLONG)(rc->right - rc->left) * (rc->bottom - rc->top);
+        work->top = min( work->top, rc->top );
+        work->bottom = max( work->bottom, rc->bottom );
+    }
+
+    height = work->bottom - work->top;
+    bands = min( area / BAND_MIN_PIXELS, get_max_bands() );
+    if (bands > height) bands = height;
+    /* new thread pool threads can't start while the loader lock is held */
+    if (bands < 2 || RtlIsCriticalSectionLockedByThread( NtCurrentTeb()->Peb->LoaderLock ) ||
+        !(queue = HeapAlloc( GetProcessHeap(), 0, sizeof(*queue) )))
+    {
+        render_band( work, work->top, work->bottom );
+        return work->ret;
+    }
+
+    work->band_height = (height + bands - 1) / bands;
+    queue->work = work;
+    queue->next_band = 0;
+    queue->band_count = (height + work->band_height - 1) / work->band_height;
+    queue->done_bands = 0;
+    workers = queue->band_count - 1;
+    queue->refcount = workers + 1;
+    InitializeConditionVariable( &queue->done );
+
+    for (submitted = 0; submitted < workers; submitted++)
+        if (!TrySubmitThreadpoolCallback( band_worker, queue, NULL )) break;
+    while (submitted++ < workers) InterlockedDecrement( &queue->refcount );
+
+    render_pending_bands( queue );
+
+    EnterCriticalSection( &band_section );
+    while (queue->done_bands < queue->band_count)
+        SleepConditionVariableCS( &queue->done, &band_section, INFINITE );
+    LeaveCriticalSection( &band_section );
+
+    release_band_queue( queue );
+    return work->ret;
+}
+
+void banded_solid_rects( const dib_info *dib, int num, const RECT *rects, DWORD and, DWORD xor )
+{
+    struct band_work work;
+
+    work.op    = BAND_SOLID;
+    work.dst   = dib;
+    work.count = num;
+    work.rects = rects;
+    work.and   = and;
+    work.xor   = xor;
+    render_banded( &work );
+}
+
+void banded_pattern_rects( const dib_info *dib, int num, const RECT *rects, const POINT *brush_org,
+                           const dib_info *brush, const rop_mask_bits *bits )
+{
+    struct band_work work;
+
+    work.op        = BAND_PATTERN;
+    work.dst       = dib;
+    work.src       = brush;
+    work.count     = num;
+    work.rects     = rects;
+    work.brush_org = brush_org;
+    work.bits      = bits;
+    render_banded( &work );
+}
+
+static void banded_copy_rects( const dib_info *dst, const RECT *dst_rect, const dib_info *src,
+                               const RECT *src_rect, int num, const RECT *rects, int rop2 )
+{
+    struct band_work work;
+
+    work.op       = BAND_COPY;
+    work.dst      = dst;
+    work.src      = src;
+    work.count    = num;
+    work.rects    = rects;
+    work.dst_rect = dst_rect;
+    work.src_rect = src_rect;
+    work.rop2     = rop2;
+    render_banded( &work );
+}
+
+static void banded_blend_rects( const dib_info *dst, const RECT *dst_rect, const dib_info *src,
+                                const RECT *src_rect, int num, const RECT *rects, BLENDFUNCTION blend )
+{
+    struct band_work work;
+
+    work.op       = BAND_BLEND;
+    work.dst      = dst;
+    work.src      = src;
+    work.count    = num;
+    work.rects    = rects;
+    work.dst_rect = dst_rect;
+    work.src_rect = src_rect;
+    work.blend    = blend;
+    render_banded( &work );
+}
+
+static BOOL banded_gradient_rects( const dib_info *dib, int num, const RECT *rects,
+                                   const TRIVERTEX *v, int mode )
+{
+    struct band_work work;
+
+    work.op    = BAND_GRADIENT;
+    work.dst   = dib;
+    work.count = num;
+    work.rects = rects;
+    work.vert  = v;
+    work.mode  = mode;
+    return render_banded( &work );
+}
+
 static void copy_rect( dib_info *dst, const RECT *dst_rect, const dib_info *src, const RECT *src_rect,
                         const struct clipped_rects *clipped_rects, INT rop2 )
 {
@@ -492,7 +772,7 @@ static void copy_rect( dib_info *dst, const RECT *dst_rect, const dib_info *src,
     case R2_WHITE: xor = ~0u;
         /* fall through */
     case R2_BLACK:
-        dst->funcs->solid_rects( dst, count, rects, and, xor );
+        banded_solid_rects( dst, count, rects, and, xor );
         /* fall through */
     case R2_NOP:
         return;
@@ -541,6 +821,10 @@ static void copy_rect( dib_info *dst, const RECT *dst_rect, const dib_info *src,
             }
         }
     }
+    else if (!overlap)  /* no overlap, any order will do */
+    {
+        banded_copy_rects( dst, dst_rect, src, src_rect, count, rects, rop2 );
+    }
     else  /* left to right, top to bottom */
     {
         for (i = 0; i < count; i++)
@@ -589,7 +873,9 @@ static DWORD blend_rect( dib_info *dst, const RECT *dst_rect, const dib_info *sr
     int i;
 
     if (!get_clipped_rects( dst, dst_rect, clip, &clipped_rects )) return ERROR_SUCCESS;
-    for (i = 0; i < clipped_rects.count; i++)
+    if (!get_overlap( dst, dst_rect, src, src_rect ))
+        banded_blend_rects( dst, dst_rect, src, src_rect, clipped_rects.count, clipped_rects.rects, blend );
+    else for (i = 0; i < clipped_rects.count; i++)
     {
         origin.x = src_rect->left + clipped_rects.rects[i].left - dst_rect->left;
         origin.y = src_rect->top  + clipped_rects.rects[i].top  - dst_rect->top;
@@ -680,15 +966,11 @@ static void get_gradient_triangle_vertices( const GRADIENT_TRIANGLE *tri, const
 
 static BOOL gradient_rect( dib_info *dib, TRIVERTEX *v, int mode, HRGN clip, const RECT *bounds )
 {
-    int i;
     struct clipped_rects clipped_rects;
-    BOOL ret = TRUE;
+    BOOL ret;
 
     if (!get_clipped_rects( dib, bounds, clip, &clipped_rects )) return TRUE;
-    for (i = 0; i < clipped_rects.count; i++)
-    {
-        if (!(ret = dib->funcs->gradient_rect( dib, &clipped_rects.rects[i], v, mode ))) break;
-    }
+    ret = banded_gradient_rects( dib, clipped_rects.count, clipped_rects.rects, v, mode );
     free_clipped_rects( &clipped_rects );
     return ret;
 }
@@ -1195,6 +1477,222 @@ static DWORD calc_1d_stretch_params( INT dst_start, INT dst_length, INT dst_vis_
 }
 
 
+/***********************************************************************
+ *               get_stretch_map   (helper for stretch_bitmapinfo)
+ *
+ * Compute the first source pixel and the number of source pixels that end
+ * up in each destination pixel along one axis, following the same walk as
+ * the stretch_row and shrink_row primitives.  Source positions are counted
+ * in steps of src_inc.  Returns the number of destination pixels.
+ */
+static unsigned int get_stretch_map( const struct stretch_params *params, BOOL stretch,
+                                     int *src_pos, int *src_count )
+{
+    int err = params->err_start;
+    unsigned int i, dst = 0;
+
+    if (stretch)
+    {
+        int pos = 0;
+
+        for (i = 0; i < params->length; i++)
+        {
+            src_pos[i] = pos;
+            src_count[i] = 1;
+            if (err > 0)
+            {
+                pos++;
+                err += params->err_add_1;
+            }
+            else err += params->err_add_2;
+        }
+        return params->length;
+    }
+
+    src_pos[0] = 0;
+    src_count[0] = 0;
+    for (i = 0; i < params->length; i++)
+    {
+        src_count[dst]++;
+        if (err > 0)
+        {
+            if (i + 1 < params->length)
+            {
+                src_pos[++dst] = i + 1;
+                src_count[dst] = 0;
+            }
+            err += params->err_add_1;
+        }
+        else err += params->err_add_2;
+    }
+    return dst + 1;
+}
+
+static inline BYTE *get_stretch_row_ptr( const dib_info *dib, int y )
+{
+    return (BYTE *)dib->bits.ptr + (dib->rect.top + y) * dib->stride + dib->rect.left * dib->bit_count / 8;
+}
+
+/* whether the color channels of the format are whole bytes that can be averaged independently */
+static inline BOOL has_byte_channels( const dib_info *dib )
+{
+    if (dib->bit_count == 24) return TRUE;
+    if (dib->bit_count != 32) return FALSE;
+    if (dib->funcs == &funcs_8888) return TRUE;
+    return (dib->red_len == 8 && dib->green_len == 8 && dib->blue_len == 8 &&
+            !(dib->red_shift % 8) && !(dib->green_shift % 8) && !(dib->blue_shift % 8));
+}
+
+/***********************************************************************
+ *               stretch_rows_nearest   (helper for stretch_bitmapinfo)
+ *
+ * STRETCH_DELETESCANS stretching of formats with at least one byte per
+ * pixel, using the precomputed source pixel of each destination column and
+ * row instead of walking the Bresenham error terms for every row.
+ */
+static void stretch_rows_nearest( const dib_info *dst_dib, const POINT *dst_start, int dst_inc_x, int dst_inc_y,
+                                  const dib_info *src_dib, const int *src_x, unsigned int width,
+                                  const int *src_y, unsigned int height )
+{
+    unsigned int i, j, bpp = dst_dib->bit_count / 8;
+    int x, left = dst_inc_x > 0 ? dst_start->x : dst_start->x - (int)width + 1;
+    BYTE *dst_row, *prev_row = NULL;
+    const BYTE *src_row;
+
+    for (j = 0; j < height; j++, prev_row = dst_row)
+    {
+        dst_row = get_stretch_row_ptr( dst_dib, dst_start->y + (int)j * dst_inc_y );
+        if (j && src_y[j] == src_y[j - 1])
+        {
+            memcpy( dst_row + left * bpp, prev_row + left * bpp, width * bpp );
+            continue;
+        }
+        src_row = get_stretch_row_ptr( src_dib, src_y[j] );
+
+        switch (bpp)
+        {
+        case 4:
+            for (i = 0, x = dst_start->x; i < width; i++, x += dst_inc_x)
+                ((DWORD *)dst_row)[x] = ((const DWORD *)src_row)[src_x[i]];
+            break;
+        case 3:
+            for (i = 0, x = dst_start->x; i < width; i++, x += dst_inc_x)
+            {
+                dst_row[x * 3]     = src_row[src_x[i] * 3];
+                dst_row[x * 3 + 1] = src_row[src_x[i] * 3 + 1];
+                dst_row[x * 3 + 2] = src_row[src_x[i] * 3 + 2];
+            }
+            break;
+        case 2:
+            for (i = 0, x = dst_start->x; i < width; i++, x += dst_inc_x)
+                ((WORD *)dst_row)[x] = ((const WORD *)src_row)[src_x[i]];
+            break;
+        case 1:
+            for (i = 0, x = dst_start->x; i < width; i++, x += dst_inc_x)
+                dst_row[x] = src_row[src_x[i]];
+            break;
+        }
+    }
+}
+
+/***********************************************************************
+ *               stretch_rows_halftone   (helper for stretch_bitmapinfo)
+ *
+ * STRETCH_HALFTONE stretching: each destination pixel is the average of
+ * the box of source pixels that maps to it.
+ */
+static BOOL stretch_rows_halftone( const dib_info *dst_dib, const POINT *dst_start, int dst_inc_x, int dst_inc_y,
+                                   const dib_info *src_dib, const POINT *src_start, int src_inc_x, int src_inc_y,
+                                   const int *x_pos, const int *x_count, unsigned int width,
+                                   const int *y_pos, const int *y_count, unsigned int height )
+{
+    unsigned int i, j, c, bpp = dst_dib->bit_count / 8;
+    DWORD *sums, *sum, count;
+    const BYTE *src_row, *src_pixel;
+    BYTE *dst_row, *dst_pixel;
+    int row, k;
+
+    if (!(sums = HeapAlloc( GetProcessHeap(), 0, width * bpp * sizeof(*sums) ))) return FALSE;
+
+    for (j = 0; j < height; j++)
+    {
+        memset( sums, 0, width * bpp * sizeof(*sums) );
+        for (row = 0; row < y_count[j]; row++)
+        {
+            src_row = get_stretch_row_ptr( src_dib, src_start->y + (y_pos[j] + row) * src_inc_y );
+            for (i = 0, sum = sums; i < width; i++, sum += bpp)
+            {
+                src_pixel = src_row + (src_start->x + x_pos[i] * src_inc_x) * (int)bpp;
+                for (k = 0; k < x_count[i]; k++, src_pixel += src_inc_x * (int)bpp)
+                    for (c = 0; c < bpp; c++) sum[c] += src_pixel[c];
+            }
+        }
+
+        dst_row = get_stretch_row_ptr( dst_dib, dst_start->y + (int)j * dst_inc_y );
+        for (i = 0, sum = sums; i < width; i++, sum += bpp)
+        {
+            dst_pixel = dst_row + (dst_start->x + (int)i * dst_inc_x) * (int)bpp;
+            count = x_count[i] * y_count[j];
+            for (c = 0; c < bpp; c++) dst_pixel[c] = (sum[c] + count / 2) / count;
+        }
+    }
+
+    HeapFree( GetProcessHeap(), 0, sums );
+    return TRUE;
+}
+
+/***********************************************************************
+ *               stretch_mapped   (helper for stretch_bitmapinfo)
+ *
+ * Stretch through per-axis source maps where the mode and format allow it.
+ * Returns FALSE if the generic row functions need to be used instead.
+ */
+static BOOL stretch_mapped( const dib_info *dst_dib, const POINT *dst_start,
+                            const dib_info *src_dib, const POINT *src_start,
+                            const struct stretch_params *h_params, BOOL hstretch,
+                            const struct stretch_params *v_params, BOOL vstretch, int mode )
+{
+    unsigned int i, width, height;
+    int *x_pos, *x_count, *y_pos, *y_count;
+    BOOL ret = TRUE;
+
+    if (dst_dib->bit_count < 8 || dst_dib->bit_count != src_dib->bit_count) return FALSE;
+    if (!h_params->length || !v_params->length) return FALSE;
+    if (mode == STRETCH_HALFTONE && !(hstretch && vstretch))
+    {
+        if (!has_byte_channels( dst_dib )) return FALSE;
+    }
+    else if (mode != STRETCH_DELETESCANS && !(hstretch && vstretch)) return FALSE;
+
+    if (!(x_pos = HeapAlloc( GetProcessHeap(), 0, 2 * (h_params->length + v_params->length) * sizeof(int) )))
+        return FALSE;
+    x_count = x_pos + h_params->length;
+    y_pos = x_count + h_params->length;
+    y_count = y_pos + v_params->length;
+
+    width = get_stretch_map( h_params, hstretch, x_pos, x_count );
+    height = get_stretch_map( v_params, vstretch, y_pos, y_count );
+
+    if (mode == STRETCH_HALFTONE && !(hstretch && vstretch))
+        ret = stretch_rows_halftone( dst_dib, dst_start, h_params->dst_inc, v_params->dst_inc,
+                                     src_dib, src_start, h_params->src_inc, v_params->src_inc,
+                                     x_pos, x_count, width, y_pos, y_count, height );
+    else
+    {
+        /* same pixels as the row functions: the last source column
+         * and the first source row of each merged block */
+        for (i = 0; i < width; i++)
+            x_pos[i] = src_start->x + (x_pos[i] + x_count[i] - 1) * h_params->src_inc;
+        for (i = 0; i < height; i++)
+            y_pos[i] = src_start->y + y_pos[i] * v_params->src_inc;
+        stretch_rows_nearest( dst_dib, dst_start, h_params->dst_inc, v_params->dst_inc,
+                              src_dib, x_pos, width, y_pos, height );
+    }
+
+    HeapFree( GetProcessHeap(), 0, x_pos );
+    return ret;
+}
+
 DWORD stretch_bitmapinfo( const BITMAPINFO *src_info, void *src_bits, struct bitblt_coords *src,
                           const BITMAPINFO *dst_info, void *dst_bits, struct bitblt_coords *dst,
                           INT mode )
@@ -1246,6 +1744,10 @@ DWORD stretch_bitmapinfo( const BITMAPINFO *src_info, void *src_bits, struct bit
 
     row_fn = hstretch ? dst_dib.funcs->stretch_row : dst_dib.funcs->shrink_row;
 
+    if (stretch_mapped( &dst_dib, &dst_start, &src_dib, &src_start, &h_params, hstretch,
+                        &v_params, vstretch, mode ))
+        goto done;
+
     if (vstretch)
     {
         BOOL need_row = TRUE;
@@ -1301,6 +1803,7 @@ DWORD stretch_bitmapinfo( const BITMAPINFO *src_info, void *src_bits, struct bit
         }
     }
 
+done:
     /* update coordinates, the destination rectangle is always stored at 0,0 */
     *src = *dst;
     src->x -= src->visrect.left;
@@ -27,12 +27,6 @@
 
 WINE_DEFAULT_DEBUG_CHANNEL(dib);
 
-struct cached_glyph
-{
-    GLYPHMETRICS metrics;
-    BYTE         bits[1];
-};
-
 enum glyph_type
 {
     GLYPH_INDEX,
@@ -40,6 +34,18 @@ enum glyph_type
     GLYPH_NBTYPES
 };
 
+struct cached_glyph
+{
+    struct list         entry;      /* entry in the glyph_lru list */
+    struct cached_font *font;
+    enum glyph_type     type;
+    UINT                index;
+    DWORD               size;
+    BOOL                referenced; /* used since the last eviction pass */
+    GLYPHMETRICS        metrics;
+    BYTE                bits[1];
+};
+
 #define GLYPH_CACHE_PAGE_SIZE  0x100
 #define GLYPH_CACHE_PAGES      (0x10000 / GLYPH_CACHE_PAGE_SIZE)
 
@@ -47,6 +53,7 @@ struct cached_font
 {
     struct list           entry;
     LONG                  ref;
+    SRWLOCK               lock;  /* held shared while glyphs are in use, exclusive to evict them */
     DWORD                 hash;
     LOGFONTW              lf;
     XFORM                 xform;
@@ -65,6 +72,27 @@ static CRITICAL_SECTION_DEBUG critsect_debug =
 };
 static CRITICAL_SECTION font_cache_cs = { &critsect_debug, -1, 0, 0, 0, 0 };
 
+/* Glyph bitmaps of all the cached fonts share a size budget. Glyphs are kept
+ * in insertion order and evicted with a second chance for the ones that have
+ * been used since the last pass, so cache hits don't need any lock. */
+#define GLYPH_CACHE_MAX_SIZE  (4 * 1024 * 1024)
+#define FONT_CACHE_MAX_UNUSED 32
+
+static struct list glyph_lru = LIST_INIT( glyph_lru );
+static SIZE_T glyph_cache_size;
+static UINT glyph_cache_count;
+static LONG glyph_cache_hits, glyph_cache_misses;
+static ULONG glyph_cache_evictions;
+
+static CRITICAL_SECTION glyph_cache_cs;
+static CRITICAL_SECTION_DEBUG glyph_critsect_debug =
+{
+    0, 0, &glyph_cache_cs,
+    { &glyph_critsect_debug.ProcessLocksList, &glyph_critsect_debug.ProcessLocksList },
+      0, 0, { (DWORD_PTR)(__FILE__ ": glyph_cache_cs") }
+};
+static CRITICAL_SECTION glyph_cache_cs = { &glyph_critsect_debug, -1, 0, 0, 0, 0 };
+
 
 static BOOL brush_rect( dibdrv_physdev *pdev, dib_brush *brush, const RECT *rect, HRGN clip )
 {
@@ -93,6 +121,112 @@ static BOOL pen_region( dibdrv_physdev *pdev, HRGN region )
     return brush_rect( pdev, &pdev->pen_brush, NULL, region );
 }
 
+struct span_fill
+{
+    dibdrv_physdev *pdev;
+    DC             *dc;
+    RECT            clip;
+    BOOL            ret;
+    int             count;
+    int             band_start;   /* first rectangle of the previous scanline */
+    int             band_count;   /* number of rectangles in the previous scanline */
+    RECT            rects[128];
+};
+
+static void flush_span_fill( struct span_fill *fill )
+{
+    dib_brush *brush = &fill->pdev->brush;
+
+    if (fill->count && !brush->rects( fill->pdev, brush, &fill->pdev->dib, fill->count, fill->rects,
+                                      &fill->dc->brush_org, fill->dc->ROPmode ))
+        fill->ret = FALSE;
+    fill->count = fill->band_count = 0;
+}
+
+static void add_fill_spans( void *context, int y, const int *spans, unsigned int count )
+{
+    struct span_fill *fill = context;
+    int i, n, start, left, right;
+
+    if (fill->count + count > sizeof(fill->rects) / sizeof(fill->rects[0])) flush_span_fill( fill );
+
+    start = fill->count;
+    for (i = 0; i < (int)count; i++)
+    {
+        left = max( spans[2 * i], fill->clip.left );
+        right = min( spans[2 * i + 1], fill->clip.right );
+        if (left >= right) continue;
+        if (fill->count == sizeof(fill->rects) / sizeof(fill->rects[0]))
+        {
+            flush_span_fill( fill );
+            start = 0;
+        }
+        fill->rects[fill->count].left = left;
+        fill->rects[fill->count].top = y;
+        fill->rects[fill->count].right = right;
+        fill->rects[fill->count].bottom = y + 1;
+        fill->count++;
+    }
+
+    /* extend the previous scanline if the spans are the same */
+    n = fill->count - start;
+    if (n && n == fill->band_count && fill->band_start + n == start &&
+        fill->rects[fill->band_start].bottom == y)
+    {
+        for (i = 0; i < n; i++)
+            if (fill->rects[fill->band_start + i].left != fill->rects[start + i].left ||
+                fill->rects[fill->band_start + i].right != fill->rects[start + i].right) break;
+        if (i == n)
+        {
+            for (i = 0; i < n; i++) fill->rects[fill->band_start + i].bottom = y + 1;
+            fill->count = start;
+            return;
+        }
+    }
+    fill->band_start = start;
+    fill->band_count = n;
+}
+
+/* fill the interior of a polygon with the brush straight from its scanlines, without
+ * building a region; returns FALSE if the clipping is too complex and a region is needed */
+static BOOL fill_polygon_spans( dibdrv_physdev *pdev, const POINT *points, const INT *counts,
+                                DWORD polygons, INT mode, BOOL *ret )
+{
+    struct clipped_rects clipped_rects;
+    struct span_fill fill;
+    RECT bounds;
+    DWORD i, total;
+
+    for (i = total = 0; i < polygons; i++) total += counts[i];
+    reset_bounds( &bounds );
+    for (i = 0; i < total; i++)
+    {
+        bounds.left   = min( bounds.left, points[i].x );
+        bounds.top    = min( bounds.top, points[i].y );
+        bounds.right  = max( bounds.right, points[i].x );
+        bounds.bottom = max( bounds.bottom, points[i].y );
+    }
+
+    *ret = TRUE;
+    if (!get_clipped_rects( &pdev->dib, &bounds, pdev->clip, &clipped_rects )) return TRUE;
+    fill.clip = clipped_rects.rects[0];
+    i = clipped_rects.count;
+    free_clipped_rects( &clipped_rects );
+    if (i > 1) return FALSE;
+
+    fill.pdev = pdev;
+    fill.dc = get_physdev_dc( &pdev->dev );
+    fill.ret = TRUE;
+    fill.count = fill.band_count = 0;
+    if (scan_polypolygon( points, counts, polygons, mode, &fill.clip, add_fill_spans, &fill ))
+    {
+        flush_span_fill( &fill );
+        *ret = fill.ret;
+    }
+    else *ret = FALSE;
+    return TRUE;
+}
+
 static RECT get_device_rect( DC *dc, int left, int top, int right, int bottom, BOOL rtl_correction )
 {
     RECT rect;
@@ -407,6 +541,35 @@ static BOOL draw_arc( PHYSDEV dev, INT left, INT top, INT right, INT bottom,
     return ret;
 }
 
+/* fill the interior of a flattened path, building a region only if the direct fill can't be used */
+static BOOL fill_path_spans( dibdrv_physdev *pdev, const POINT *points, const BYTE *types, int total,
+                             INT mode, HRGN *interior )
+{
+    INT count_buf[16], *counts = count_buf;
+    int i, pos, polygons;
+    BOOL ret = TRUE;
+
+    if (total / 2 > sizeof(count_buf) / sizeof(count_buf[0]) &&
+        !(counts = HeapAlloc( GetProcessHeap(), 0, (total / 2) * sizeof(*counts) )))
+        return FALSE;
+
+    pos = polygons = 0;
+    for (i = 1; i < total; i++)
+    {
+        if (types[i] != PT_MOVETO) continue;
+        counts[polygons++] = i - pos;
+        pos = i;
+    }
+    if (i > pos + 1) counts[polygons++] = i - pos;
+
+    if (!fill_polygon_spans( pdev, points, counts, polygons, mode, &ret ) &&
+        !(*interior = create_polypolygon_region( points, counts, polygons, mode, NULL )))
+        ret = FALSE;
+
+    if (counts != count_buf) HeapFree( GetProcessHeap(), 0, counts );
+    return ret;
+}
+
 /* helper for path stroking and filling functions */
 static BOOL stroke_and_fill_path( dibdrv_physdev *dev, BOOL stroke, BOOL fill )
 {
@@ -417,12 +580,16 @@ static BOOL stroke_and_fill_path( dibdrv_physdev *dev, BOOL stroke, BOOL fill )
     BOOL ret = TRUE;
     HRGN outline = 0, interior = 0;
     int i, pos, total;
+    BOOL direct;
 
     if (dev->brush.style == BS_NULL) fill = FALSE;
+    /* without an outline region the interior can be painted straight from the path */
+    direct = fill && !(stroke && dev->pen_uses_region);
 
-    if (!(path = get_gdi_flat_path( dc, fill ? &interior : NULL ))) return FALSE;
+    if (!(path = get_gdi_flat_path( dc, fill && !direct ? &interior : NULL ))) return FALSE;
     if (!(total = get_gdi_path_data( path, &points, &types ))) goto done;
 
+    if (direct) ret = fill_path_spans( dev, points, types, total, dc->polyFillMode, &interior );
     if (stroke && dev->pen_uses_region) outline = CreateRectRgn( 0, 0, 0, 0 );
 
     /* if not using a region, paint the interior first so the outline can overlap it */
@@ -588,19 +755,29 @@ static struct cached_font *add_cached_font( DC *dc, HFONT hfont, UINT aa_flags )
         }
     }
 
-    if (i > 5)  /* keep at least 5 of the most-recently used fonts around */
+    if (i > FONT_CACHE_MAX_UNUSED)  /* the glyph budget bounds memory, keep the recently used fonts */
     {
         ptr = last_unused;
+        EnterCriticalSection( &glyph_cache_cs );
         for (i = 0; i < GLYPH_NBTYPES; i++)
         {
             for (j = 0; j < GLYPH_CACHE_PAGES; j++)
             {
                 if (!ptr->glyphs[i][j]) continue;
                 for (k = 0; k < GLYPH_CACHE_PAGE_SIZE; k++)
-                    HeapFree( GetProcessHeap(), 0, ptr->glyphs[i][j][k] );
+                {
+                    struct cached_glyph *glyph = ptr->glyphs[i][j][k];
+
+                    if (!glyph) continue;
+                    list_remove( &glyph->entry );
+                    glyph_cache_size -= glyph->size;
+                    glyph_cache_count--;
+                    HeapFree( GetProcessHeap(), 0, glyph );
+                }
                 HeapFree( GetProcessHeap(), 0, ptr->glyphs[i][j] );
             }
         }
+        LeaveCriticalSection( &glyph_cache_cs );
         list_remove( &ptr->entry );
     }
     else if (!(ptr = HeapAlloc( GetProcessHeap(), 0, sizeof(*ptr) )))
@@ -611,6 +788,7 @@ static struct cached_font *add_cached_font( DC *dc, HFONT hfont, UINT aa_flags )
 
     *ptr = font;
     ptr->ref = 1;
+    InitializeSRWLock( &ptr->lock );
     memset( ptr->glyphs, 0, sizeof(ptr->glyphs) );
 done:
     list_add_head( &font_cache, &ptr->entry );
@@ -645,10 +823,67 @@ static struct cached_glyph *add_cached_glyph( struct cached_font *font, UINT ind
         if (InterlockedCompareExchangePointer( (void **)&font->glyphs[type][page], ptr, NULL ))
             HeapFree( GetProcessHeap(), 0, ptr );
     }
+    glyph->font       = font;
+    glyph->type       = type;
+    glyph->index      = index;
+    glyph->referenced = FALSE;
     ret = InterlockedCompareExchangePointer( (void **)&font->glyphs[type][page][entry], glyph, NULL );
-    if (!ret) ret = glyph;
-    else HeapFree( GetProcessHeap(), 0, glyph );
-    return ret;
+    if (ret)
+    {
+        HeapFree( GetProcessHeap(), 0, glyph );
+        return ret;
+    }
+
+    EnterCriticalSection( &glyph_cache_cs );
+    list_add_head( &glyph_lru, &glyph->entry );
+    glyph_cache_size += glyph->size;
+    glyph_cache_count++;
+    LeaveCriticalSection( &glyph_cache_cs );
+    return glyph;
+}
+
+/***********************************************************************
+ *         trim_glyph_cache
+ *
+ * Evict glyphs until the cache fits in its budget again. Must be called
+ * without holding the lock of any font.
+ */
+static void trim_glyph_cache(void)
+{
+    struct cached_glyph *glyph;
+    struct cached_font *font;
+    struct list *ptr;
+    UINT passes = 0;
+
+    if (glyph_cache_size <= GLYPH_CACHE_MAX_SIZE) return;
+
+    EnterCriticalSection( &glyph_cache_cs );
+    while (glyph_cache_size > GLYPH_CACHE_MAX_SIZE && (ptr = list_tail( &glyph_lru )))
+    {
+        glyph = LIST_ENTRY( ptr, struct cached_glyph, entry );
+        font = glyph->font;
+        list_remove( &glyph->entry );
+
+        /* give recently used glyphs another chance, and skip the ones of fonts
+         * currently drawn with, but give up after two full passes */
+        if (glyph->referenced || !TryAcquireSRWLockExclusive( &font->lock ))
+        {
+            glyph->referenced = FALSE;
+            list_add_head( &glyph_lru, &glyph->entry );
+            if (++passes > 2 * glyph_cache_count) break;
+            continue;
+        }
+
+        font->glyphs[glyph->type][glyph->index / GLYPH_CACHE_PAGE_SIZE][glyph->index % GLYPH_CACHE_PAGE_SIZE] = NULL;
+        ReleaseSRWLockExclusive( &font->lock );
+        glyph_cache_size -= glyph->size;
+        glyph_cache_count--;
+        glyph_cache_evictions++;
+        HeapFree( GetProcessHeap(), 0, glyph );
+    }
+    TRACE( "%d hits %d misses %u evictions, %u glyphs in %u bytes\n", glyph_cache_hits, glyph_cache_misses,
+           glyph_cache_evictions, glyph_cache_count, (UINT)glyph_cache_size );
+    LeaveCriticalSection( &glyph_cache_cs );
 }
 
 static struct cached_glyph *get_cached_glyph( struct cached_font *font, UINT index, UINT flags )
@@ -773,6 +1008,7 @@ static struct cached_glyph *cache_glyph_bitmap( DC *dc, struct cached_font *font
     size = metrics.gmBlackBoxY * stride;
     glyph = HeapAlloc( GetProcessHeap(), 0, FIELD_OFFSET( struct cached_glyph, bits[size] ));
     if (!glyph) return NULL;
+    glyph->size = FIELD_OFFSET( struct cached_glyph, bits[size] );
     if (!size) goto done;  /* empty glyph */
 
     if (bit_count == 8) pad = padding[ metrics.gmBlackBoxX % 4 ];
@@ -812,7 +1048,7 @@ static void render_string( DC *dc, dib_info *dib, struct cached_font *font, INT
                            UINT flags, const WCHAR *str, UINT count, const INT *dx,
                            const struct clipped_rects *clipped_rects, RECT *bounds )
 {
-    UINT i;
+    UINT i, misses = 0;
     struct cached_glyph *glyph;
     dib_info glyph_dib;
     DWORD text_color;
@@ -829,10 +1065,18 @@ static void render_string( DC *dc, dib_info *dib, struct cached_font *font, INT
     if (glyph_dib.bit_count == 8)
         get_aa_ranges( dib->funcs->pixel_to_colorref( dib, text_color ), ranges );
 
+    AcquireSRWLockShared( &font->lock );
     for (i = 0; i < count; i++)
     {
-        if (!(glyph = get_cached_glyph( font, str[i], flags )) &&
-            !(glyph = cache_glyph_bitmap( dc, font, str[i], flags ))) continue;
+        if ((glyph = get_cached_glyph( font, str[i], flags )))
+        {
+            if (!glyph->referenced) glyph->referenced = TRUE;
+        }
+        else
+        {
+            misses++;
+            if (!(glyph = cache_glyph_bitmap( dc, font, str[i], flags ))) continue;
+        }
 
         glyph_dib.width       = glyph->metrics.gmBlackBoxX;
         glyph_dib.height      = glyph->metrics.gmBlackBoxY;
@@ -859,6 +1103,14 @@ static void render_string( DC *dc, dib_info *dib, struct cached_font *font, INT
             y += glyph->metrics.gmCellIncY;
         }
     }
+    ReleaseSRWLockShared( &font->lock );
+
+    if (count > misses) InterlockedExchangeAdd( &glyph_cache_hits, count - misses );
+    if (misses)
+    {
+        InterlockedExchangeAdd( &glyph_cache_misses, misses );
+        trim_glyph_cache();
+    }
 }
 
 BOOL render_aa_text_bitmapinfo( DC *dc, BITMAPINFO *info, struct gdi_image_bits *bits,
@@ -912,8 +1164,8 @@ BOOL dibdrv_ExtTextOut( PHYSDEV dev, INT x, INT y, UINT flags,
         get_text_bkgnd_masks( dc, &pdev->dib, &bkgnd_color );
         add_bounds_rect( &bounds, rect );
         get_clipped_rects( &pdev->dib, rect, pdev->clip, &clipped_rects );
-        pdev->dib.funcs->solid_rects( &pdev->dib, clipped_rects.count, clipped_rects.rects,
-                                      bkgnd_color.and, bkgnd_color.xor );
+        banded_solid_rects( &pdev->dib, clipped_rects.count, clipped_rects.rects,
+                            bkgnd_color.and, bkgnd_color.xor );
     }
 
     if (count == 0) goto done;
@@ -1196,7 +1448,7 @@ BOOL dibdrv_PatBlt( PHYSDEV dev, struct bitblt_coords *dst, DWORD rop )
     case R2_WHITE: xor = ~0u;
         /* fall through */
     case R2_BLACK:
-        pdev->dib.funcs->solid_rects( &pdev->dib, clipped_rects.count, clipped_rects.rects, and, xor );
+        banded_solid_rects( &pdev->dib, clipped_rects.count, clipped_rects.rects, and, xor );
         /* fall through */
     case R2_NOP:
         break;
@@ -1253,6 +1505,7 @@ BOOL dibdrv_PolyPolygon( PHYSDEV dev, const POINT *pt, const INT *counts, DWORD
     POINT pt_buf[32];
     POINT *points = pt_buf;
     HRGN outline = 0, interior = 0;
+    BOOL filled = FALSE;
 
     for (i = total = 0; i < polygons; i++)
     {
@@ -1268,7 +1521,11 @@ BOOL dibdrv_PolyPolygon( PHYSDEV dev, const POINT *pt, const INT *counts, DWORD
     memcpy( points, pt, total * sizeof(*pt) );
     lp_to_dp( dc, points, total );
 
-    if (pdev->brush.style != BS_NULL &&
+    /* if not using a region for the outline, the interior can be painted directly */
+    if (pdev->brush.style != BS_NULL && !pdev->pen_uses_region)
+        filled = fill_polygon_spans( pdev, points, counts, polygons, dc->polyFillMode, &ret );
+
+    if (pdev->brush.style != BS_NULL && !filled &&
         get_dib_rect( &pdev->dib, &rc ) &&
         !(interior = create_polypolygon_region( points, counts, polygons, dc->polyFillMode, &rc )))
     {
@@ -4593,62 +4593,72 @@ static inline BYTE blend_color(BYTE dst, BYTE src, DWORD alpha)
     return (src * alpha + dst * (255 - alpha) + 127) / 255;
 }
 
+/* The blending helpers below work on two channels at a time, held in the
+ * 16-bit halves of a DWORD (0x00rr00bb or 0x00aa00gg).  Intermediate
+ * values never exceed 255 * 255 + 127, so the halves cannot overflow. */
+
+/* divide both 16-bit halves of val by 255, with the same result as integer division */
+static inline DWORD div255_x2( DWORD val )
+{
+    return ((val + 0x00010001 + ((val >> 8) & 0x00ff00ff)) >> 8) & 0x00ff00ff;
+}
+
+/* blend two channel pairs, same as blend_color() on each channel */
+static inline DWORD blend_color_x2( DWORD dst, DWORD src, DWORD alpha )
+{
+    return div255_x2( src * alpha + dst * (255 - alpha) + 0x007f007f );
+}
+
 static inline DWORD blend_argb_constant_alpha( DWORD dst, DWORD src, DWORD alpha )
 {
-    return (blend_color( dst, src, alpha ) |
-            blend_color( dst >> 8, src >> 8, alpha ) << 8 |
-            blend_color( dst >> 16, src >> 16, alpha ) << 16 |
-            blend_color( dst >> 24, src >> 24, alpha ) << 24);
+    return (blend_color_x2( dst & 0x00ff00ff, src & 0x00ff00ff, alpha ) |
+            blend_color_x2( (dst >> 8) & 0x00ff00ff, (src >> 8) & 0x00ff00ff, alpha ) << 8);
 }
 
 static inline DWORD blend_argb_no_src_alpha( DWORD dst, DWORD src, DWORD alpha )
 {
-    return (blend_color( dst, src, alpha ) |
-            blend_color( dst >> 8, src >> 8, alpha ) << 8 |
-            blend_color( dst >> 16, src >> 16, alpha ) << 16 |
-            blend_color( dst >> 24, 255, alpha ) << 24);
+    return blend_argb_constant_alpha( dst, src | 0xff000000, alpha );
+}
+
+/* blend premultiplied source channel pairs; the sums are combined with OR so that
+ * out-of-range premultiplied values spill over exactly like per-channel code would */
+static inline DWORD blend_premultiplied_x2( DWORD dst_rb, DWORD dst_ag, DWORD src_rb, DWORD src_ag, DWORD alpha )
+{
+    DWORD rb = src_rb + div255_x2( dst_rb * (255 - alpha) + 0x007f007f );
+    DWORD ag = src_ag + div255_x2( dst_ag * (255 - alpha) + 0x007f007f );
+    return rb | ag << 8;
 }
 
 static inline DWORD blend_argb( DWORD dst, DWORD src )
 {
-    BYTE b = (BYTE)src;
-    BYTE g = (BYTE)(src >> 8);
-    BYTE r = (BYTE)(src >> 16);
-    DWORD alpha  = (BYTE)(src >> 24);
-    return ((b     + ((BYTE)dst         * (255 - alpha) + 127) / 255) |
-            (g     + ((BYTE)(dst >> 8)  * (255 - alpha) + 127) / 255) << 8 |
-            (r     + ((BYTE)(dst >> 16) * (255 - alpha) + 127) / 255) << 16 |
-            (alpha + ((BYTE)(dst >> 24) * (255 - alpha) + 127) / 255) << 24);
+    return blend_premultiplied_x2( dst & 0x00ff00ff, (dst >> 8) & 0x00ff00ff,
+                                   src & 0x00ff00ff, (src >> 8) & 0x00ff00ff, src >> 24 );
 }
 
 static inline DWORD blend_argb_alpha( DWORD dst, DWORD src, DWORD alpha )
 {
-    BYTE b = ((BYTE)src         * alpha + 127) / 255;
-    BYTE g = ((BYTE)(src >> 8)  * alpha + 127) / 255;
-    BYTE r = ((BYTE)(src >> 16) * alpha + 127) / 255;
-    alpha  = ((BYTE)(src >> 24) * alpha + 127) / 255;
-    return ((b     + ((BYTE)dst         * (255 - alpha) + 127) / 255) |
-            (g     + ((BYTE)(dst >> 8)  * (255 - alpha) + 127) / 255) << 8 |
-            (r     + ((BYTE)(dst >> 16) * (255 - alpha) + 127) / 255) << 16 |
-            (alpha + ((BYTE)(dst >> 24) * (255 - alpha) + 127) / 255) << 24);
+    DWORD src_rb = div255_x2( (src & 0x00ff00ff) * alpha + 0x007f007f );
+    DWORD src_ag = div255_x2( ((src >> 8) & 0x00ff00ff) * alpha + 0x007f007f );
+
+    return blend_premultiplied_x2( dst & 0x00ff00ff, (dst >> 8) & 0x00ff00ff,
+                                   src_rb, src_ag, src_ag >> 16 );
 }
 
 static inline DWORD blend_rgb( BYTE dst_r, BYTE dst_g, BYTE dst_b, DWORD src, BLENDFUNCTION blend )
 {
+    DWORD dst_rb = dst_r << 16 | dst_b;
+
     if (blend.AlphaFormat & AC_SRC_ALPHA)
     {
         DWORD alpha = blend.SourceConstantAlpha;
-        BYTE src_b = ((BYTE)src         * alpha + 127) / 255;
-        BYTE src_g = ((BYTE)(src >> 8)  * alpha + 127) / 255;
-        BYTE src_r = ((BYTE)(src >> 16) * alpha + 127) / 255;
-        alpha      = ((BYTE)(src >> 24) * alpha + 127) / 255;
-        return ((src_b + (dst_b * (255 - alpha) + 127) / 255) |
-                (src_g + (dst_g * (255 - alpha) + 127) / 255) << 8 |
-                (src_r + (dst_r * (255 - alpha) + 127) / 255) << 16);
-    }
-    return (blend_color( dst_b, src, blend.SourceConstantAlpha ) |
-            blend_color( dst_g, src >> 8, blend.SourceConstantAlpha ) << 8 |
-            blend_color( dst_r, src >> 16, blend.SourceConstantAlpha ) << 16);
+        DWORD src_rb = div255_x2( (src & 0x00ff00ff) * alpha + 0x007f007f );
+        DWORD src_ag = div255_x2( ((src >> 8) & 0x00ff00ff) * alpha + 0x007f007f );
+
+        /* the alpha channel is not part of the result */
+        return blend_premultiplied_x2( dst_rb, dst_g, src_rb, src_ag & 0xff, src_ag >> 16 );
+    }
+    return (blend_color_x2( dst_rb, src & 0x00ff00ff, blend.SourceConstantAlpha ) |
+            blend_color( dst_g, src >> 8, blend.SourceConstantAlpha ) << 8);
 }
 
 static void blend_rect_8888(const dib_info *dst, const RECT *rc,
@@ -48,10 +48,26 @@
 
 WINE_DEFAULT_DEBUG_CHANNEL(enhmetafile);
 
+/* pre-decoded record list, built on the first enumeration of a metafile */
+struct emf_record
+{
+    const ENHMETARECORD *emr;
+    const POINT         *points;  /* widened points of a 16-bit poly record */
+    BOOL                 output;  /* record writes something to the dc */
+};
+
+struct emf_playback
+{
+    UINT              count;
+    POINT            *points;
+    struct emf_record records[1];
+};
+
 typedef struct
 {
-    ENHMETAHEADER  *emh;
-    BOOL           on_disk;   /* true if metafile is on disk */
+    ENHMETAHEADER       *emh;
+    BOOL                 on_disk;   /* true if metafile is on disk */
+    struct emf_playback *playback;  /* cached record list, or NULL */
 } ENHMETAFILEOBJ;
 
 static const struct emr_name {
@@ -278,6 +294,7 @@ HENHMETAFILE EMF_Create_HENHMETAFILE(ENHMETAHEADER *emh, DWORD filesize, BOOL on
 
     metaObj->emh = emh;
     metaObj->on_disk = on_disk;
+    metaObj->playback = NULL;
 
     if (!(hmf = alloc_gdi_handle( metaObj, OBJ_ENHMETAFILE, NULL )))
         HeapFree( GetProcessHeap(), 0, metaObj );
@@ -297,6 +314,11 @@ static BOOL EMF_Delete_HENHMETAFILE( HENHMETAFILE hmf )
         UnmapViewOfFile( metaObj->emh );
     else
         HeapFree( GetProcessHeap(), 0, metaObj->emh );
+    if (metaObj->playback)
+    {
+        HeapFree( GetProcessHeap(), 0, metaObj->playback->points );
+        HeapFree( GetProcessHeap(), 0, metaObj->playback );
+    }
     HeapFree( GetProcessHeap(), 0, metaObj );
     return TRUE;
 }
@@ -2270,6 +2292,195 @@ BOOL WINAPI PlayEnhMetaFileRecord(
 }
 
 
+/******************************************************************
+ *         get_poly16_points
+ *
+ * Returns the POINTS array of a 16-bit poly record, or NULL if the
+ * record is of another type or doesn't hold as many points as it claims.
+ */
+static const POINTS *get_poly16_points( const ENHMETARECORD *emr, DWORD *count )
+{
+    const char *end = (const char *)emr + emr->nSize;
+    const POINTS *pts;
+
+    switch (emr->iType)
+    {
+    case EMR_POLYGON16:
+    case EMR_POLYLINE16:
+    case EMR_POLYLINETO16:
+    case EMR_POLYBEZIER16:
+    case EMR_POLYBEZIERTO16:
+      {
+        const EMRPOLYLINE16 *poly = (const EMRPOLYLINE16 *)emr;
+
+        if (emr->nSize < FIELD_OFFSET( EMRPOLYLINE16, apts )) return NULL;
+        *count = poly->cpts;
+        pts = poly->apts;
+        break;
+      }
+    case EMR_POLYPOLYGON16:
+    case EMR_POLYPOLYLINE16:
+      {
+        const EMRPOLYPOLYLINE16 *poly = (const EMRPOLYPOLYLINE16 *)emr;
+
+        if (emr->nSize < FIELD_OFFSET( EMRPOLYPOLYLINE16, aPolyCounts )) return NULL;
+        if (poly->nPolys > (emr->nSize - FIELD_OFFSET( EMRPOLYPOLYLINE16, aPolyCounts )) / sizeof(DWORD))
+            return NULL;
+        *count = poly->cpts;
+        pts = (const POINTS *)(poly->aPolyCounts + poly->nPolys);
+        break;
+      }
+    default:
+        return NULL;
+    }
+    if (!*count || *count > (DWORD)(end - (const char *)pts) / sizeof(POINTS)) return NULL;
+    return pts;
+}
+
+static void free_emf_playback( struct emf_playback *playback )
+{
+    HeapFree( GetProcessHeap(), 0, playback->points );
+    HeapFree( GetProcessHeap(), 0, playback );
+}
+
+/******************************************************************
+ *         build_emf_playback
+ *
+ * Validates the records of a metafile once and stores them in a flat
+ * list, so that later enumerations don't need to walk and check the
+ * record sizes again.  The points of 16-bit poly records are widened
+ * up front, saving an allocation and a conversion on every playback.
+ */
+static struct emf_playback *build_emf_playback( const ENHMETAHEADER *emh )
+{
+    struct emf_playback *playback;
+    const ENHMETARECORD *emr;
+    const POINTS *pts;
+    POINT *pt;
+    DWORD offset, count, total = 0, i, j;
+    UINT records = 0;
+
+    for (offset = 0; offset < emh->nBytes; offset += emr->nSize)
+    {
+        emr = (const ENHMETARECORD *)((const char *)emh + offset);
+
+        if (offset + 8 > emh->nBytes ||
+            emr->nSize < 8 ||
+            offset > offset + emr->nSize ||
+            offset + emr->nSize > emh->nBytes)
+        {
+            WARN("record truncated\n");
+            break;
+        }
+        records++;
+        if ((pts = get_poly16_points( emr, &count ))) total += count;
+    }
+
+    if (!(playback = HeapAlloc( GetProcessHeap(), 0,
+                                FIELD_OFFSET( struct emf_playback, records[records] ))))
+        return NULL;
+    playback->count = records;
+    playback->points = NULL;
+    /* the points are only a shortcut, play the original records if they don't fit */
+    if (total && total <= MAXDWORD / sizeof(POINT))
+        playback->points = HeapAlloc( GetProcessHeap(), 0, total * sizeof(POINT) );
+
+    pt = playback->points;
+    for (i = offset = 0; i < records; i++, offset += emr->nSize)
+    {
+        emr = (const ENHMETARECORD *)((const char *)emh + offset);
+        playback->records[i].emr = emr;
+        playback->records[i].output = emr_produces_output( emr->iType );
+        playback->records[i].points = NULL;
+        if (pt && (pts = get_poly16_points( emr, &count )))
+        {
+            for (j = 0; j < count; j++)
+            {
+                pt[j].x = pts[j].x;
+                pt[j].y = pts[j].y;
+            }
+            playback->records[i].points = pt;
+            pt += count;
+        }
+    }
+    TRACE("%u records, %u widened points\n", records, pt ? (UINT)(pt - playback->points) : 0);
+    return playback;
+}
+
+/******************************************************************
+ *         EMF_GetPlayback
+ *
+ * Returns the cached record list of a metafile, building it if needed.
+ */
+static struct emf_playback *EMF_GetPlayback( HENHMETAFILE hmf )
+{
+    struct emf_playback *playback, *new = NULL;
+    ENHMETAFILEOBJ *metaObj;
+    ENHMETAHEADER *emh;
+
+    if (!(metaObj = GDI_GetObjPtr( hmf, OBJ_ENHMETAFILE ))) return NULL;
+    playback = metaObj->playback;
+    emh = metaObj->emh;
+    GDI_ReleaseObj( hmf );
+    if (playback) return playback;
+
+    /* build it without holding the GDI lock, another thread may win the race */
+    if (!(new = build_emf_playback( emh ))) return NULL;
+    if ((metaObj = GDI_GetObjPtr( hmf, OBJ_ENHMETAFILE )))
+    {
+        if (!(playback = metaObj->playback)) playback = metaObj->playback = new;
+        GDI_ReleaseObj( hmf );
+    }
+    if (playback != new) free_emf_playback( new );
+    return playback;
+}
+
+/******************************************************************
+ *         play_poly16_record
+ *
+ * Plays a 16-bit poly record from its pre-widened points.
+ */
+static BOOL play_poly16_record( HDC hdc, const struct emf_record *rec )
+{
+    const EMRPOLYLINE16 *poly = (const EMRPOLYLINE16 *)rec->emr;
+    const EMRPOLYPOLYLINE16 *polypoly = (const EMRPOLYPOLYLINE16 *)rec->emr;
+
+    TRACE("record %s from cache\n", get_emr_name(rec->emr->iType));
+    switch (rec->emr->iType)
+    {
+    case EMR_POLYGON16:
+        Polygon( hdc, rec->points, poly->cpts );
+        break;
+    case EMR_POLYLINE16:
+        Polyline( hdc, rec->points, poly->cpts );
+        break;
+    case EMR_POLYLINETO16:
+        PolylineTo( hdc, rec->points, poly->cpts );
+        break;
+    case EMR_POLYBEZIER16:
+        PolyBezier( hdc, rec->points, poly->cpts );
+        break;
+    case EMR_POLYBEZIERTO16:
+        PolyBezierTo( hdc, rec->points, poly->cpts );
+        break;
+    case EMR_POLYPOLYGON16:
+        PolyPolygon( hdc, rec->points, (const INT *)polypoly->aPolyCounts, polypoly->nPolys );
+        break;
+    case EMR_POLYPOLYLINE16:
+        PolyPolyline( hdc, rec->points, polypoly->aPolyCounts, polypoly->nPolys );
+        break;
+    }
+    return TRUE;
+}
+
+static INT CALLBACK EMF_PlayEnhMetaFileCallback(HDC hdc, HANDLETABLE *ht,
+						const ENHMETARECORD *emr,
+						INT handles, LPARAM data)
+{
+    return PlayEnhMetaFileRecord(hdc, ht, emr, handles);
+}
+
+
 /*****************************************************************************
  *
  *        EnumEnhMetaFile  (GDI32.@)
@@ -2314,8 +2525,7 @@ BOOL WINAPI EnumEnhMetaFile(
 {
     BOOL ret;
     ENHMETAHEADER *emh;
-    ENHMETARECORD *emr;
-    DWORD offset;
+    struct emf_playback *playback;
     UINT i;
     HANDLETABLE *ht;
     INT savedMode = 0;
@@ -2341,6 +2551,11 @@ BOOL WINAPI EnumEnhMetaFile(
         SetLastError(ERROR_INVALID_HANDLE);
         return FALSE;
     }
+    if (!(playback = EMF_GetPlayback(hmf)))
+    {
+        SetLastError(ERROR_NOT_ENOUGH_MEMORY);
+        return FALSE;
+    }
 
     info = HeapAlloc( GetProcessHeap(), 0,
 		    sizeof (enum_emh_data) + sizeof(HANDLETABLE) * emh->nHandles );
@@ -2465,26 +2680,22 @@ BOOL WINAPI EnumEnhMetaFile(
     }
 
     ret = TRUE;
-    offset = 0;
-    while(ret && offset < emh->nBytes)
+    for (i = 0; ret && i < playback->count; i++)
     {
-	emr = (ENHMETARECORD *)((char *)emh + offset);
-
-        if (offset + 8 > emh->nBytes ||
-            offset > offset + emr->nSize ||
-            offset + emr->nSize > emh->nBytes)
-        {
-            WARN("record truncated\n");
-            break;
-        }
+        const struct emf_record *rec = &playback->records[i];
 
         /* In Win9x mode we update the xform if the record will produce output */
-        if (hdc && IS_WIN9X() && emr_produces_output(emr->iType))
+        if (hdc && IS_WIN9X() && rec->output)
             EMF_Update_MF_Xform(hdc, info);
 
-	TRACE("Calling EnumFunc with record %s, size %d\n", get_emr_name(emr->iType), emr->nSize);
-	ret = (*callback)(hdc, ht, emr, emh->nHandles, (LPARAM)data);
-	offset += emr->nSize;
+        if (rec->points && callback == EMF_PlayEnhMetaFileCallback)
+        {
+            ret = play_poly16_record(hdc, rec);
+            continue;
+        }
+
+	TRACE("Calling EnumFunc with record %s, size %d\n", get_emr_name(rec->emr->iType), rec->emr->nSize);
+	ret = (*callback)(hdc, ht, rec->emr, emh->nHandles, (LPARAM)data);
     }
 
     if (hdc)
@@ -2528,13 +2739,6 @@ BOOL WINAPI EnumEnhMetaFile(
     return ret;
 }
 
-static INT CALLBACK EMF_PlayEnhMetaFileCallback(HDC hdc, HANDLETABLE *ht,
-						const ENHMETARECORD *emr,
-						INT handles, LPARAM data)
-{
-    return PlayEnhMetaFileRecord(hdc, ht, emr, handles);
-}
-
 /**************************************************************************
  *    PlayEnhMetaFile  (GDI32.@)
  *
@@ -562,24 +562,10 @@ typedef struct tagFontSubst {
     NameCs to;
 } FontSubst;
 
-/* Registry font cache key and value names */
+/* Registry keys for the font settings and the font cache session */
 static const WCHAR wine_fonts_key[] = {'S','o','f','t','w','a','r','e','\\','W','i','n','e','\\',
                                        'F','o','n','t','s',0};
 static const WCHAR wine_fonts_cache_key[] = {'C','a','c','h','e',0};
-static const WCHAR english_name_value[] = {'E','n','g','l','i','s','h',' ','N','a','m','e',0};
-static const WCHAR face_index_value[] = {'I','n','d','e','x',0};
-static const WCHAR face_ntmflags_value[] = {'N','t','m','f','l','a','g','s',0};
-static const WCHAR face_version_value[] = {'V','e','r','s','i','o','n',0};
-static const WCHAR face_height_value[] = {'H','e','i','g','h','t',0};
-static const WCHAR face_width_value[] = {'W','i','d','t','h',0};
-static const WCHAR face_size_value[] = {'S','i','z','e',0};
-static const WCHAR face_x_ppem_value[] = {'X','p','p','e','m',0};
-static const WCHAR face_y_ppem_value[] = {'Y','p','p','e','m',0};
-static const WCHAR face_flags_value[] = {'F','l','a','g','s',0};
-static const WCHAR face_internal_leading_value[] = {'I','n','t','e','r','n','a','l',' ','L','e','a','d','i','n','g',0};
-static const WCHAR face_font_sig_value[] = {'F','o','n','t',' ','S','i','g','n','a','t','u','r','e',0};
-static const WCHAR face_file_name_value[] = {'F','i','l','e',' ','N','a','m','e','\0'};
-static const WCHAR face_full_name_value[] = {'F','u','l','l',' ','N','a','m','e','\0'};
 
 
 struct font_mapping
@@ -595,7 +581,6 @@ struct font_mapping
 static struct list mappings_list = LIST_INIT( mappings_list );
 
 static UINT default_aa_flags;
-static HKEY hkey_font_cache;
 static BOOL antialias_fakes = TRUE;
 
 static CRITICAL_SECTION freetype_cs;
@@ -1608,102 +1593,270 @@ static LONG reg_load_dword(HKEY hkey, const WCHAR *value, DWORD *data)
     return ERROR_SUCCESS;
 }
 
-static inline LONG reg_load_ftlong(HKEY hkey, const WCHAR *value, FT_Long *data)
+/* Binary font cache file
+ *
+ * The faces found by scanning the font directories are saved in a file in
+ * the configuration directory, which all the processes map read-only instead
+ * of scanning again. Faces added or removed at run time by AddFontResource
+ * are appended as records, and dropped again when a new session starts.
+ * The file is rebuilt when one of the scanned directories or font files, the
+ * system language, the code pages or the dpi change.
+ */
+
+#define FONT_CACHE_MAGIC    0x434e4657  /* "WFNC" */
+#define FONT_CACHE_VERSION  2
+
+struct font_cache_header
 {
-    DWORD dw;
-    LONG ret = reg_load_dword(hkey, value, &dw);
-    *data = dw;
-    return ret;
+    DWORD magic;
+    DWORD version;
+    DWORD header_size;      /* size of the header and the file stamps */
+    DWORD scan_size;        /* end of the records written by the directory scan */
+    DWORD lang_id;          /* language of the localized names */
+    DWORD ansi_cp;
+    DWORD oem_cp;
+    DWORD dpi;
+};
+
+struct font_cache_stamp
+{
+    ULONGLONG dev;          /* all zero if the file didn't exist */
+    ULONGLONG ino;
+    ULONGLONG mtime;
+    ULONGLONG file_size;
+    DWORD     size;         /* size of the stamp, including the name */
+    char      name[4];      /* unix path of the directory or font file */
+};
+
+enum font_cache_record_type
+{
+    FONT_CACHE_ADD_FACE = 1,
+    FONT_CACHE_REMOVE_FACE
+};
+
+struct font_cache_face
+{
+    DWORD         type;
+    DWORD         size;     /* size of the record, including the names */
+    ULONGLONG     dev;
+    ULONGLONG     ino;
+    DWORD         face_index;
+    DWORD         ntm_flags;
+    DWORD         font_version;
+    DWORD         flags;
+    FONTSIGNATURE fs;
+    DWORD         scalable;
+    INT           height;
+    INT           width;
+    INT           bitmap_size;
+    INT           x_ppem;
+    INT           y_ppem;
+    INT           internal_leading;
+    DWORD         family_len;   /* name lengths in WCHARs, including the null, 0 if absent */
+    DWORD         english_len;
+    DWORD         style_len;
+    DWORD         full_name_len;
+    DWORD         file_len;
+    WCHAR         names[4];
+};
+
+/* records are kept 8-byte aligned so that 32-bit and 64-bit processes can share the file */
+#define FONT_CACHE_ALIGN(size) (((size) + 7) & ~7)
+
+struct font_cache_buffer
+{
+    BYTE *data;
+    DWORD size;
+    DWORD alloc;
+};
+
+static BOOL font_cache_scanning;                     /* collect the records in memory */
+static BOOL font_cache_loading;                      /* don't write records while replaying them */
+static struct font_cache_buffer font_cache_records;  /* records collected by the scan */
+static struct font_cache_buffer font_cache_stamps;   /* file stamps collected by the scan */
+
+static char *get_font_cache_path(void)
+{
+    static const char name[] = "/fontcache";
+    const char *dir = wine_get_config_dir();
+    char *path;
+
+    if ((path = HeapAlloc( GetProcessHeap(), 0, strlen(dir) + sizeof(name) )))
+    {
+        strcpy( path, dir );
+        strcat( path, name );
+    }
+    return path;
 }
 
-static inline LONG reg_load_ftshort(HKEY hkey, const WCHAR *value, FT_Short *data)
+static BOOL append_font_cache_buffer( struct font_cache_buffer *buffer, const void *data, DWORD size )
 {
-    DWORD dw;
-    LONG ret = reg_load_dword(hkey, value, &dw);
-    *data = dw;
-    return ret;
+    if (buffer->size + size > buffer->alloc)
+    {
+        DWORD alloc = max( buffer->alloc * 2, max( buffer->size + size, 0x10000 ));
+        BYTE *ptr;
+
+        if (buffer->data) ptr = HeapReAlloc( GetProcessHeap(), 0, buffer->data, alloc );
+        else ptr = HeapAlloc( GetProcessHeap(), 0, alloc );
+        if (!ptr) return FALSE;
+        buffer->data = ptr;
+        buffer->alloc = alloc;
+    }
+    memcpy( buffer->data + buffer->size, data, size );
+    buffer->size += size;
+    return TRUE;
 }
 
-static inline LONG reg_save_dword(HKEY hkey, const WCHAR *value, DWORD data)
+static void free_font_cache_buffer( struct font_cache_buffer *buffer )
 {
-    return RegSetValueExW(hkey, value, 0, REG_DWORD, (BYTE*)&data, sizeof(DWORD));
+    HeapFree( GetProcessHeap(), 0, buffer->data );
+    buffer->data = NULL;
+    buffer->size = buffer->alloc = 0;
 }
 
-static void load_face(HKEY hkey_face, WCHAR *face_name, Family *family, void *buffer, DWORD buffer_size)
+static void fill_font_cache_stamp( struct font_cache_stamp *stamp, const struct stat *st )
 {
-    DWORD needed, strike_index = 0;
-    HKEY hkey_strike;
+    stamp->dev       = st->st_dev;
+    stamp->ino       = st->st_ino;
+    stamp->mtime     = st->st_mtime;
+    stamp->file_size = S_ISDIR( st->st_mode ) ? 0 : st->st_size;
+}
 
-    /* If we have a File Name key then this is a real font, not just the parent
-       key of a bunch of non-scalable strikes */
-    needed = buffer_size;
-    if (RegQueryValueExW(hkey_face, face_file_name_value, NULL, NULL, buffer, &needed) == ERROR_SUCCESS)
-    {
-        Face *face;
-        face = HeapAlloc(GetProcessHeap(), 0, sizeof(*face));
-        face->cached_enum_data = NULL;
-        face->family = NULL;
+static void append_font_cache_stamp( const char *name, const struct stat *st )
+{
+    struct font_cache_stamp *stamp;
+    DWORD size = FONT_CACHE_ALIGN( FIELD_OFFSET( struct font_cache_stamp, name[strlen(name) + 1] ));
 
-        face->refcount = 1;
-        face->file = strdupW( buffer );
-        face->StyleName = strdupW(face_name);
+    if (!(stamp = HeapAlloc( GetProcessHeap(), HEAP_ZERO_MEMORY, size ))) return;
+    fill_font_cache_stamp( stamp, st );
+    stamp->size = size;
+    strcpy( stamp->name, name );
+    append_font_cache_buffer( &font_cache_stamps, stamp, size );
+    HeapFree( GetProcessHeap(), 0, stamp );
+}
 
-        needed = buffer_size;
-        if(RegQueryValueExW(hkey_face, face_full_name_value, NULL, NULL, buffer, &needed) == ERROR_SUCCESS)
-            face->FullName = strdupW( buffer );
-        else
-            face->FullName = NULL;
+/* record a scanned directory, so that files added to or removed from it invalidate the cache */
+static void add_font_cache_dir( const char *name )
+{
+    const struct font_cache_stamp *stamp;
+    struct stat st;
+    DWORD pos;
 
-        reg_load_ftlong(hkey_face, face_index_value, &face->face_index);
-        reg_load_dword(hkey_face, face_ntmflags_value, &face->ntmFlags);
-        reg_load_ftlong(hkey_face, face_version_value, &face->font_version);
-        reg_load_dword(hkey_face, face_flags_value, &face->flags);
+    if (!font_cache_scanning) return;
 
-        needed = sizeof(face->fs);
-        RegQueryValueExW(hkey_face, face_font_sig_value, NULL, NULL, (BYTE*)&face->fs, &needed);
+    if (stat( name, &st ) == -1) memset( &st, 0, sizeof(st) );
+    else if (!S_ISDIR( st.st_mode )) return;
 
-        if(reg_load_ftshort(hkey_face, face_height_value, &face->size.height) != ERROR_SUCCESS)
-        {
-            face->scalable = TRUE;
-            memset(&face->size, 0, sizeof(face->size));
-        }
-        else
-        {
-            face->scalable = FALSE;
-            reg_load_ftshort(hkey_face, face_width_value, &face->size.width);
-            reg_load_ftlong(hkey_face, face_size_value, &face->size.size);
-            reg_load_ftlong(hkey_face, face_x_ppem_value, &face->size.x_ppem);
-            reg_load_ftlong(hkey_face, face_y_ppem_value, &face->size.y_ppem);
-            reg_load_ftshort(hkey_face, face_internal_leading_value, &face->size.internal_leading);
-
-            TRACE("Adding bitmap size h %d w %d size %ld x_ppem %ld y_ppem %ld\n",
-                  face->size.height, face->size.width, face->size.size >> 6,
-                  face->size.x_ppem >> 6, face->size.y_ppem >> 6);
-        }
+    for (pos = 0; pos < font_cache_stamps.size; pos += stamp->size)
+    {
+        stamp = (const struct font_cache_stamp *)(font_cache_stamps.data + pos);
+        if (st.st_ino ? (stamp->dev == st.st_dev && stamp->ino == st.st_ino) : !strcmp( stamp->name, name ))
+            return;
+    }
+    append_font_cache_stamp( name, &st );
+}
 
-        TRACE("fsCsb = %08x %08x/%08x %08x %08x %08x\n",
-              face->fs.fsCsb[0], face->fs.fsCsb[1],
-              face->fs.fsUsb[0], face->fs.fsUsb[1],
-              face->fs.fsUsb[2], face->fs.fsUsb[3]);
+/* record a font file and its directory, so that rewriting the file also invalidates the cache */
+static void add_font_cache_file( const char *file )
+{
+    struct stat st;
+    char *dir, *p;
 
-        if (insert_face_in_family_list(face, family))
-            TRACE("Added font %s %s\n", debugstr_w(family->FamilyName), debugstr_w(face->StyleName));
+    if (!font_cache_scanning) return;
+    if (stat( file, &st ) != -1 && !S_ISDIR( st.st_mode )) append_font_cache_stamp( file, &st );
 
-        release_face( face );
+    if (!(dir = HeapAlloc( GetProcessHeap(), 0, strlen(file) + 1 ))) return;
+    strcpy( dir, file );
+    if ((p = strrchr( dir, '/' )) && p != dir)
+    {
+        *p = 0;
+        add_font_cache_dir( dir );
     }
+    HeapFree( GetProcessHeap(), 0, dir );
+}
+
+static inline DWORD font_cache_strlen( const WCHAR *str )
+{
+    return str ? strlenW( str ) + 1 : 0;
+}
+
+static WCHAR *font_cache_strcpy( WCHAR *dst, const WCHAR *str, DWORD len )
+{
+    memcpy( dst, str, len * sizeof(WCHAR) );
+    return dst + len;
+}
+
+static void write_font_cache_record( Face *face, enum font_cache_record_type type )
+{
+    struct font_cache_face *record;
+    DWORD size, family_len, english_len, style_len, full_name_len, file_len;
+    WCHAR *names;
+
+    if (font_cache_loading || !face->file) return;
+
+    family_len    = font_cache_strlen( face->family->FamilyName );
+    english_len   = font_cache_strlen( face->family->EnglishName );
+    style_len     = font_cache_strlen( face->StyleName );
+    full_name_len = font_cache_strlen( face->FullName );
+    file_len      = font_cache_strlen( face->file );
+    size = FONT_CACHE_ALIGN( FIELD_OFFSET( struct font_cache_face, names[family_len + english_len + style_len +
+                                                                        full_name_len + file_len] ));
 
-    /* load bitmap strikes */
+    if (!(record = HeapAlloc( GetProcessHeap(), HEAP_ZERO_MEMORY, size ))) return;
+    record->type             = type;
+    record->size             = size;
+    record->dev              = face->dev;
+    record->ino              = face->ino;
+    record->face_index       = face->face_index;
+    record->ntm_flags        = face->ntmFlags;
+    record->font_version     = face->font_version;
+    record->flags            = face->flags;
+    record->fs               = face->fs;
+    record->scalable         = face->scalable;
+    record->height           = face->size.height;
+    record->width            = face->size.width;
+    record->bitmap_size      = face->size.size;
+    record->x_ppem           = face->size.x_ppem;
+    record->y_ppem           = face->size.y_ppem;
+    record->internal_leading = face->size.internal_leading;
+    record->family_len       = family_len;
+    record->english_len      = english_len;
+    record->style_len        = style_len;
+    record->full_name_len    = full_name_len;
+    record->file_len         = file_len;
 
-    needed = buffer_size;
-    while (!RegEnumKeyExW(hkey_face, strike_index++, buffer, &needed, NULL, NULL, NULL, NULL))
+    names = font_cache_strcpy( record->names, face->family->FamilyName, family_len );
+    names = font_cache_strcpy( names, face->family->EnglishName, english_len );
+    names = font_cache_strcpy( names, face->StyleName, style_len );
+    names = font_cache_strcpy( names, face->FullName, full_name_len );
+    font_cache_strcpy( names, face->file, file_len );
+
+    if (font_cache_scanning)
+        append_font_cache_buffer( &font_cache_records, record, size );
+    else
     {
-        if (!RegOpenKeyExW(hkey_face, buffer, 0, KEY_ALL_ACCESS, &hkey_strike))
+        /* the file only gets created by a scan, but other processes may append to it */
+        char *path = get_font_cache_path();
+        int fd;
+
+        if (path && (fd = open( path, O_WRONLY | O_APPEND )) != -1)
         {
-            load_face(hkey_strike, face_name, family, buffer, buffer_size);
-            RegCloseKey(hkey_strike);
+            if (write( fd, record, size ) != size) WARN( "failed to update %s\n", debugstr_a(path) );
+            close( fd );
         }
-        needed = buffer_size;
+        HeapFree( GetProcessHeap(), 0, path );
     }
+    HeapFree( GetProcessHeap(), 0, record );
+}
+
+static void add_face_to_cache( Face *face )
+{
+    write_font_cache_record( face, FONT_CACHE_ADD_FACE );
+}
+
+static void remove_face_from_cache( Face *face )
+{
+    write_font_cache_record( face, FONT_CACHE_REMOVE_FACE );
 }
 
 /* move vertical fonts after their horizontal counterpart */
@@ -1738,149 +1891,282 @@ static void reorder_vertical_fonts(void)
     list_move_tail( &font_list, &vertical_families );
 }
 
-static void load_font_list_from_cache(HKEY hkey_font_cache)
+static void fill_font_cache_header( struct font_cache_header *header )
 {
-    DWORD size, family_index = 0;
-    Family *family;
-    HKEY hkey_family;
-    WCHAR buffer[4096];
+    header->magic   = FONT_CACHE_MAGIC;
+    header->version = FONT_CACHE_VERSION;
+    header->lang_id = GetSystemDefaultLangID();
+    header->ansi_cp = GetACP();
+    header->oem_cp  = GetOEMCP();
+    header->dpi     = get_dpi();
+}
+
+/* check that none of the scanned directories and files changed since the cache was built */
+static BOOL is_font_cache_up_to_date( const BYTE *data, const struct font_cache_header *header )
+{
+    struct font_cache_header current;
+    const struct font_cache_stamp *stamp;
+    struct font_cache_stamp file;
+    struct stat st;
+    DWORD pos;
 
-    size = sizeof(buffer);
-    while (!RegEnumKeyExW(hkey_font_cache, family_index++, buffer, &size, NULL, NULL, NULL, NULL))
+    fill_font_cache_header( &current );
+    if (header->lang_id != current.lang_id || header->ansi_cp != current.ansi_cp ||
+        header->oem_cp != current.oem_cp || header->dpi != current.dpi)
     {
-        WCHAR *english_family = NULL;
-        WCHAR *family_name = strdupW( buffer );
-        DWORD face_index = 0;
+        TRACE( "locale or dpi changed\n" );
+        return FALSE;
+    }
 
-        RegOpenKeyExW(hkey_font_cache, family_name, 0, KEY_ALL_ACCESS, &hkey_family);
-        TRACE("opened family key %s\n", debugstr_w(family_name));
-        size = sizeof(buffer);
-        if (!RegQueryValueExW(hkey_family, english_name_value, NULL, NULL, (BYTE *)buffer, &size))
-            english_family = strdupW( buffer );
+    for (pos = sizeof(*header); pos < header->header_size; pos += stamp->size)
+    {
+        stamp = (const struct font_cache_stamp *)(data + pos);
+        if (stamp->size < sizeof(*stamp) || stamp->size > header->header_size - pos) return FALSE;
+        if (stat( stamp->name, &st ) == -1) memset( &file, 0, sizeof(file) );
+        else fill_font_cache_stamp( &file, &st );
+        if (file.dev != stamp->dev || file.ino != stamp->ino || file.mtime != stamp->mtime ||
+            file.file_size != stamp->file_size)
+        {
+            TRACE( "%s changed\n", debugstr_a(stamp->name) );
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+static BOOL cached_face_matches( const Face *face, const struct font_cache_face *record,
+                                 const WCHAR *style, const WCHAR *file )
+{
+    if (strcmpiW( face->StyleName, style )) return FALSE;
+    if (!face->scalable && face->size.y_ppem != record->y_ppem) return FALSE;
+    if (face->face_index != record->face_index) return FALSE;
+    return face->file && !strcmpW( face->file, file );
+}
+
+static void load_cached_face( const struct font_cache_face *record )
+{
+    const WCHAR *family_name = record->names;
+    const WCHAR *english     = family_name + record->family_len;
+    const WCHAR *style       = english + record->english_len;
+    const WCHAR *full_name   = style + record->style_len;
+    const WCHAR *file        = full_name + record->full_name_len;
+    Family *family;
+    Face *face, *cursor;
 
-        family = create_family(family_name, english_family);
+    if (!record->family_len || !record->style_len || !record->file_len) return;
 
-        if(english_family)
+    if (record->type == FONT_CACHE_REMOVE_FACE)
+    {
+        if (!(family = find_family_from_name( family_name ))) return;
+        LIST_FOR_EACH_ENTRY( cursor, &family->faces, Face, entry )
         {
-            FontSubst *subst = HeapAlloc(GetProcessHeap(), 0, sizeof(*subst));
-            subst->from.name = strdupW(english_family);
-            subst->from.charset = -1;
-            subst->to.name = strdupW(family_name);
-            subst->to.charset = -1;
-            add_font_subst(&font_subst_list, subst, 0);
+            if (!cached_face_matches( cursor, record, style, file )) continue;
+            TRACE( "Removed font %s %s\n", debugstr_w(family->FamilyName), debugstr_w(cursor->StyleName) );
+            release_face( cursor );
+            break;
         }
+        return;
+    }
 
-        size = sizeof(buffer);
-        while (!RegEnumKeyExW(hkey_family, face_index++, buffer, &size, NULL, NULL, NULL, NULL))
+    if ((family = find_family_from_name( family_name ))) family->refcount++;
+    else
+    {
+        family = create_family( strdupW( family_name ), record->english_len ? strdupW( english ) : NULL );
+        if (family->EnglishName)
         {
-            WCHAR *face_name = strdupW( buffer );
-            HKEY hkey_face;
-
-            if (!RegOpenKeyExW(hkey_family, face_name, 0, KEY_ALL_ACCESS, &hkey_face))
-            {
-                load_face(hkey_face, face_name, family, buffer, sizeof(buffer));
-                RegCloseKey(hkey_face);
-            }
-            HeapFree( GetProcessHeap(), 0, face_name );
-            size = sizeof(buffer);
+            FontSubst *subst = HeapAlloc( GetProcessHeap(), 0, sizeof(*subst) );
+            subst->from.name = strdupW( family->EnglishName );
+            subst->from.charset = -1;
+            subst->to.name = strdupW( family->FamilyName );
+            subst->to.charset = -1;
+            add_font_subst( &font_subst_list, subst, 0 );
         }
-        RegCloseKey(hkey_family);
-        release_family( family );
-        size = sizeof(buffer);
     }
 
-    reorder_vertical_fonts();
+    face = HeapAlloc( GetProcessHeap(), 0, sizeof(*face) );
+    face->refcount = 1;
+    face->StyleName = strdupW( style );
+    face->FullName = record->full_name_len ? strdupW( full_name ) : NULL;
+    face->file = strdupW( file );
+    face->dev = record->dev;
+    face->ino = record->ino;
+    face->font_data_ptr = NULL;
+    face->font_data_size = 0;
+    face->face_index = record->face_index;
+    face->fs = record->fs;
+    face->ntmFlags = record->ntm_flags;
+    face->font_version = record->font_version;
+    face->scalable = record->scalable;
+    face->size.height = record->height;
+    face->size.width = record->width;
+    face->size.size = record->bitmap_size;
+    face->size.x_ppem = record->x_ppem;
+    face->size.y_ppem = record->y_ppem;
+    face->size.internal_leading = record->internal_leading;
+    face->flags = record->flags;
+    face->family = NULL;
+    face->cached_enum_data = NULL;
+
+    if (insert_face_in_family_list( face, family ))
+        TRACE( "Added font %s %s\n", debugstr_w(family->FamilyName), debugstr_w(face->StyleName) );
+
+    release_face( face );
+    release_family( family );
 }
 
-static LONG create_font_cache_key(HKEY *hkey, DWORD *disposition)
+static int family_name_compare( const void *p1, const void *p2 )
 {
-    LONG ret;
-    HKEY hkey_wine_fonts;
+    const Family *f1 = *(const Family * const *)p1, *f2 = *(const Family * const *)p2;
+    return strcmpiW( f1->FamilyName, f2->FamilyName );
+}
 
-    /* We don't want to create the fonts key as volatile, so open this first */
-    ret = RegCreateKeyExW(HKEY_CURRENT_USER, wine_fonts_key, 0, NULL, 0,
-                          KEY_ALL_ACCESS, NULL, &hkey_wine_fonts, NULL);
-    if(ret != ERROR_SUCCESS)
+/* sort the families by name, followed by vertical fonts */
+static void sort_font_list(void)
+{
+    Family *family, **families;
+    UINT i, count = list_count( &font_list );
+
+    if ((families = HeapAlloc( GetProcessHeap(), 0, count * sizeof(*families) )))
     {
-        WARN("Can't create %s\n", debugstr_w(wine_fonts_key));
-        return ret;
+        i = 0;
+        LIST_FOR_EACH_ENTRY( family, &font_list, Family, entry ) families[i++] = family;
+        qsort( families, count, sizeof(*families), family_name_compare );
+        list_init( &font_list );
+        for (i = 0; i < count; i++) list_add_tail( &font_list, &families[i]->entry );
+        HeapFree( GetProcessHeap(), 0, families );
     }
-
-    ret = RegCreateKeyExW(hkey_wine_fonts, wine_fonts_cache_key, 0, NULL, REG_OPTION_VOLATILE,
-                          KEY_ALL_ACCESS, NULL, hkey, disposition);
-    RegCloseKey(hkey_wine_fonts);
-    return ret;
+    reorder_vertical_fonts();
 }
 
-static void add_face_to_cache(Face *face)
+/*************************************************************
+ *    load_font_cache
+ *
+ * Load the face list from the cache file. The first process of a session
+ * checks that the cache is still valid, and drops the faces added at run
+ * time by the previous session.
+ */
+static BOOL load_font_cache( BOOL new_session )
 {
-    HKEY hkey_family, hkey_face;
-    WCHAR *face_key_name;
-
-    RegCreateKeyExW(hkey_font_cache, face->family->FamilyName, 0,
-                    NULL, REG_OPTION_VOLATILE, KEY_ALL_ACCESS, NULL, &hkey_family, NULL);
-    if(face->family->EnglishName)
-        RegSetValueExW(hkey_family, english_name_value, 0, REG_SZ, (BYTE*)face->family->EnglishName,
-                       (strlenW(face->family->EnglishName) + 1) * sizeof(WCHAR));
+    const struct font_cache_header *header;
+    const struct font_cache_face *record;
+    struct stat st;
+    char *path;
+    BYTE *data = NULL;
+    DWORD pos, size = 0;
+    BOOL ret = FALSE;
+    int fd;
 
-    if(face->scalable)
-        face_key_name = face->StyleName;
-    else
+    if (!(path = get_font_cache_path())) return FALSE;
+    if ((fd = open( path, new_session ? O_RDWR : O_RDONLY )) == -1 &&
+        (!new_session || (fd = open( path, O_RDONLY )) == -1)) goto done;
+    if (fstat( fd, &st ) == -1 || st.st_size < sizeof(*header) || st.st_size > 0x7fffffff) goto done;
+    size = st.st_size;
+    if ((data = mmap( NULL, size, PROT_READ, MAP_SHARED, fd, 0 )) == MAP_FAILED)
     {
-        static const WCHAR fmtW[] = {'%','s','\\','%','d',0};
-        face_key_name = HeapAlloc(GetProcessHeap(), 0, (strlenW(face->StyleName) + 10) * sizeof(WCHAR));
-        sprintfW(face_key_name, fmtW, face->StyleName, face->size.y_ppem);
+        data = NULL;
+        goto done;
     }
-    RegCreateKeyExW(hkey_family, face_key_name, 0, NULL, REG_OPTION_VOLATILE, KEY_ALL_ACCESS, NULL,
-                    &hkey_face, NULL);
-    if(!face->scalable)
-        HeapFree(GetProcessHeap(), 0, face_key_name);
 
-    RegSetValueExW(hkey_face, face_file_name_value, 0, REG_SZ, (BYTE *)face->file,
-                   (strlenW(face->file) + 1) * sizeof(WCHAR));
-    if (face->FullName)
-        RegSetValueExW(hkey_face, face_full_name_value, 0, REG_SZ, (BYTE*)face->FullName,
-                       (strlenW(face->FullName) + 1) * sizeof(WCHAR));
-
-    reg_save_dword(hkey_face, face_index_value, face->face_index);
-    reg_save_dword(hkey_face, face_ntmflags_value, face->ntmFlags);
-    reg_save_dword(hkey_face, face_version_value, face->font_version);
-    if (face->flags) reg_save_dword(hkey_face, face_flags_value, face->flags);
+    header = (const struct font_cache_header *)data;
+    if (header->magic != FONT_CACHE_MAGIC || header->version != FONT_CACHE_VERSION ||
+        header->header_size < sizeof(*header) || header->header_size > header->scan_size ||
+        header->scan_size > size)
+    {
+        WARN( "invalid font cache %s\n", debugstr_a(path) );
+        goto done;
+    }
 
-    RegSetValueExW(hkey_face, face_font_sig_value, 0, REG_BINARY, (BYTE*)&face->fs, sizeof(face->fs));
+    if (new_session)
+    {
+        if (!is_font_cache_up_to_date( data, header )) goto done;
+        if (size > header->scan_size)
+        {
+            if (ftruncate( fd, header->scan_size ) == -1) WARN( "failed to truncate %s\n", debugstr_a(path) );
+            size = header->scan_size;
+        }
+    }
 
-    if(!face->scalable)
+    font_cache_loading = TRUE;
+    for (pos = header->header_size; pos < size; pos += record->size)
     {
-        reg_save_dword(hkey_face, face_height_value, face->size.height);
-        reg_save_dword(hkey_face, face_width_value, face->size.width);
-        reg_save_dword(hkey_face, face_size_value, face->size.size);
-        reg_save_dword(hkey_face, face_x_ppem_value, face->size.x_ppem);
-        reg_save_dword(hkey_face, face_y_ppem_value, face->size.y_ppem);
-        reg_save_dword(hkey_face, face_internal_leading_value, face->size.internal_leading);
+        record = (const struct font_cache_face *)(data + pos);
+        if (size - pos < sizeof(*record) || record->size < sizeof(*record) || record->size > size - pos ||
+            FIELD_OFFSET( struct font_cache_face, names[record->family_len + record->english_len +
+                          record->style_len + record->full_name_len + record->file_len] ) > record->size)
+            break;  /* truncated record */
+        load_cached_face( record );
     }
-    RegCloseKey(hkey_face);
-    RegCloseKey(hkey_family);
+    font_cache_loading = FALSE;
+
+    sort_font_list();
+    TRACE( "loaded %u bytes from %s\n", pos, debugstr_a(path) );
+    ret = TRUE;
+
+done:
+    if (data) munmap( data, st.st_size );
+    if (fd != -1) close( fd );
+    HeapFree( GetProcessHeap(), 0, path );
+    return ret;
 }
 
-static void remove_face_from_cache( Face *face )
+/*************************************************************
+ *    save_font_cache
+ *
+ * Write the results of the directory scan to the cache file.
+ */
+static void save_font_cache(void)
 {
-    HKEY hkey_family;
+    struct font_cache_header header;
+    char *path, *tmp = NULL;
+    int fd = -1;
+
+    fill_font_cache_header( &header );
+    header.header_size = sizeof(header) + font_cache_stamps.size;
+    header.scan_size = header.header_size + font_cache_records.size;
 
-    RegOpenKeyExW( hkey_font_cache, face->family->FamilyName, 0, KEY_ALL_ACCESS, &hkey_family );
+    if (!(path = get_font_cache_path())) goto done;
+    if (!(tmp = HeapAlloc( GetProcessHeap(), 0, strlen(path) + sizeof(".tmp") ))) goto done;
+    strcpy( tmp, path );
+    strcat( tmp, ".tmp" );
 
-    if (face->scalable)
+    if ((fd = open( tmp, O_CREAT | O_TRUNC | O_WRONLY, 0644 )) == -1) goto done;
+    if (write( fd, &header, sizeof(header) ) != sizeof(header) ||
+        write( fd, font_cache_stamps.data, font_cache_stamps.size ) != font_cache_stamps.size ||
+        write( fd, font_cache_records.data, font_cache_records.size ) != font_cache_records.size)
     {
-        RegDeleteKeyW( hkey_family, face->StyleName );
+        WARN( "failed to write %s\n", debugstr_a(tmp) );
+        unlink( tmp );
+        goto done;
     }
-    else
+    if (rename( tmp, path ) == -1) unlink( tmp );
+    else TRACE( "saved %u bytes to %s\n", header.scan_size, debugstr_a(path) );
+
+done:
+    if (fd != -1) close( fd );
+    HeapFree( GetProcessHeap(), 0, tmp );
+    HeapFree( GetProcessHeap(), 0, path );
+    free_font_cache_buffer( &font_cache_stamps );
+    free_font_cache_buffer( &font_cache_records );
+}
+
+static LONG create_font_cache_key(HKEY *hkey, DWORD *disposition)
+{
+    LONG ret;
+    HKEY hkey_wine_fonts;
+
+    /* We don't want to create the fonts key as volatile, so open this first */
+    ret = RegCreateKeyExW(HKEY_CURRENT_USER, wine_fonts_key, 0, NULL, 0,
+                          KEY_ALL_ACCESS, NULL, &hkey_wine_fonts, NULL);
+    if(ret != ERROR_SUCCESS)
     {
-        static const WCHAR fmtW[] = {'%','s','\\','%','d',0};
-        WCHAR *face_key_name = HeapAlloc(GetProcessHeap(), 0, (strlenW(face->StyleName) + 10) * sizeof(WCHAR));
-        sprintfW(face_key_name, fmtW, face->StyleName, face->size.y_ppem);
-        RegDeleteKeyW( hkey_family, face_key_name );
-        HeapFree(GetProcessHeap(), 0, face_key_name);
+        WARN("Can't create %s\n", debugstr_w(wine_fonts_key));
+        return ret;
     }
-    RegCloseKey(hkey_family);
+
+    ret = RegCreateKeyExW(hkey_wine_fonts, wine_fonts_cache_key, 0, NULL, REG_OPTION_VOLATILE,
+                          KEY_ALL_ACCESS, NULL, hkey, disposition);
+    RegCloseKey(hkey_wine_fonts);
+    return ret;
 }
 
 static WCHAR *prepend_at(WCHAR *family)
@@ -2264,6 +2550,8 @@ static INT AddFontToList(const char *file, void *font_data_ptr, DWORD font_data_
     }
 #endif /* HAVE_CARBON_CARBON_H */
 
+    if (file && (flags & ADDFONT_ADD_TO_CACHE)) add_font_cache_file( file );
+
     do {
         const DWORD FS_DBCS_MASK = FS_JISJAPAN|FS_CHINESESIMP|FS_WANSUNG|FS_CHINESETRAD|FS_JOHAB;
         FONTSIGNATURE fs;
@@ -2721,6 +3009,8 @@ static BOOL ReadFontDir(const char *dirname, BOOL external_fonts)
 
     TRACE("Loading fonts from %s\n", debugstr_a(dirname));
 
+    add_font_cache_dir(dirname);
+
     dir = opendir(dirname);
     if(!dir) {
         WARN("Can't open directory %s\n", debugstr_a(dirname));
@@ -4353,8 +4643,9 @@ static void reorder_font_list(void)
 BOOL WineEngInit(void)
 {
     HKEY hkey;
-    DWORD disposition;
+    DWORD disposition = REG_CREATED_NEW_KEY;
     HANDLE font_mutex;
+    BOOL scanned;
 
     /* update locale dependent font info in registry */
     update_font_info();
@@ -4389,12 +4680,17 @@ BOOL WineEngInit(void)
     }
     WaitForSingleObject(font_mutex, INFINITE);
 
-    create_font_cache_key(&hkey_font_cache, &disposition);
+    /* the volatile cache key tells whether this is the first process of the session */
+    if (!create_font_cache_key(&hkey, &disposition)) RegCloseKey(hkey);
 
-    if(disposition == REG_CREATED_NEW_KEY)
+    scanned = !load_font_cache(disposition == REG_CREATED_NEW_KEY);
+    if (scanned)
+    {
+        font_cache_scanning = TRUE;
         init_font_list();
-    else
-        load_font_list_from_cache(hkey_font_cache);
+        font_cache_scanning = FALSE;
+        save_font_cache();
+    }
 
     reorder_font_list();
 
@@ -4403,7 +4699,7 @@ BOOL WineEngInit(void)
     DumpSubstList();
     LoadReplaceList();
 
-    if(disposition == REG_CREATED_NEW_KEY)
+    if (scanned)
         update_reg_entries();
 
     init_system_links();
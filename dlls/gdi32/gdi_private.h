@@ -296,6 +296,8 @@ extern void *free_gdi_handle( HGDIOBJ handle ) DECLSPEC_HIDDEN;
 extern HGDIOBJ get_full_gdi_handle( HGDIOBJ handle ) DECLSPEC_HIDDEN;
 extern void *GDI_GetObjPtr( HGDIOBJ, WORD ) DECLSPEC_HIDDEN;
 extern void *get_any_obj_ptr( HGDIOBJ, WORD * ) DECLSPEC_HIDDEN;
+extern void *grab_gdi_handle( HGDIOBJ handle, WORD *type ) DECLSPEC_HIDDEN;
+extern void release_gdi_handle(void) DECLSPEC_HIDDEN;
 extern void GDI_ReleaseObj( HGDIOBJ ) DECLSPEC_HIDDEN;
 extern void GDI_CheckNotLock(void) DECLSPEC_HIDDEN;
 extern UINT GDI_get_ref_count( HGDIOBJ handle ) DECLSPEC_HIDDEN;
@@ -357,6 +359,9 @@ extern INT mirror_region( HRGN dst, HRGN src, INT width ) DECLSPEC_HIDDEN;
 extern BOOL REGION_FrameRgn( HRGN dest, HRGN src, INT x, INT y ) DECLSPEC_HIDDEN;
 extern HRGN create_polypolygon_region( const POINT *pts, const INT *count, INT nbpolygons,
                                        INT mode, const RECT *clip_rect ) DECLSPEC_HIDDEN;
+typedef void (*polygon_spans_func)( void *context, int y, const int *spans, unsigned int count );
+extern BOOL scan_polypolygon( const POINT *pts, const INT *count, INT nbpolygons, INT mode,
+                              const RECT *clip_rect, polygon_spans_func func, void *context ) DECLSPEC_HIDDEN;
 
 #define RGN_DEFAULT_RECTS 4
 typedef struct
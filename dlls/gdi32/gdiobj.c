@@ -119,6 +119,12 @@ static CRITICAL_SECTION_DEBUG critsect_debug =
 };
 static CRITICAL_SECTION gdi_section = { &critsect_debug, -1, 0, 0, 0, 0 };
 
+/* The handle table entries only change with both gdi_section and handle_lock
+ * held exclusively. Lookups that don't access the object contents only need
+ * handle_lock shared, so that threads working on their own DCs don't
+ * serialize on gdi_section. */
+static SRWLOCK handle_lock = SRWLOCK_INIT;
+
 
 /****************************************************************************
  *
@@ -790,6 +796,7 @@ HGDIOBJ alloc_gdi_handle( void *obj, WORD type, const struct gdi_obj_funcs *func
     assert( type );  /* type 0 is reserved to mark free entries */
 
     EnterCriticalSection( &gdi_section );
+    AcquireSRWLockExclusive( &handle_lock );
 
     entry = next_free;
     if (entry)
@@ -798,6 +805,7 @@ HGDIOBJ alloc_gdi_handle( void *obj, WORD type, const struct gdi_obj_funcs *func
         entry = next_unused++;
     else
     {
+        ReleaseSRWLockExclusive( &handle_lock );
         LeaveCriticalSection( &gdi_section );
         ERR( "out of GDI object handles, expect a crash\n" );
         if (TRACE_ON(gdi)) dump_gdi_objects();
@@ -812,6 +820,7 @@ HGDIOBJ alloc_gdi_handle( void *obj, WORD type, const struct gdi_obj_funcs *func
     entry->deleted  = 0;
     if (++entry->generation == 0xffff) entry->generation = 1;
     ret = entry_to_handle( entry );
+    ReleaseSRWLockExclusive( &handle_lock );
     LeaveCriticalSection( &gdi_section );
     TRACE( "allocated %s %p %u/%u\n", gdi_obj_type(type), ret,
            InterlockedIncrement( &debug_count ), MAX_GDI_HANDLES );
@@ -830,6 +839,7 @@ void *free_gdi_handle( HGDIOBJ handle )
     struct gdi_handle_entry *entry;
 
     EnterCriticalSection( &gdi_section );
+    AcquireSRWLockExclusive( &handle_lock );
     if ((entry = handle_entry( handle )))
     {
         TRACE( "freed %s %p %u/%u\n", gdi_obj_type( entry->type ), handle,
@@ -839,6 +849,7 @@ void *free_gdi_handle( HGDIOBJ handle )
         entry->obj = next_free;
         next_free = entry;
     }
+    ReleaseSRWLockExclusive( &handle_lock );
     LeaveCriticalSection( &gdi_section );
     return object;
 }
@@ -855,13 +866,44 @@ HGDIOBJ get_full_gdi_handle( HGDIOBJ handle )
 
     if (!HIWORD( handle ))
     {
-        EnterCriticalSection( &gdi_section );
+        AcquireSRWLockShared( &handle_lock );
         if ((entry = handle_entry( handle ))) handle = entry_to_handle( entry );
-        LeaveCriticalSection( &gdi_section );
+        ReleaseSRWLockShared( &handle_lock );
     }
     return handle;
 }
 
+/***********************************************************************
+ *           grab_gdi_handle
+ *
+ * Return a pointer to, and the type of, the GDI object associated with
+ * the handle, without locking the object itself. Only the handle table
+ * is locked, which keeps the object from being freed; the caller must
+ * only access object fields that are synchronized by other means.
+ * The object must be released with release_gdi_handle.
+ */
+void *grab_gdi_handle( HGDIOBJ handle, WORD *type )
+{
+    struct gdi_handle_entry *entry;
+
+    AcquireSRWLockShared( &handle_lock );
+    if ((entry = handle_entry( handle )))
+    {
+        *type = entry->type;
+        return entry->obj;
+    }
+    ReleaseSRWLockShared( &handle_lock );
+    return NULL;
+}
+
+/***********************************************************************
+ *           release_gdi_handle
+ */
+void release_gdi_handle(void)
+{
+    ReleaseSRWLockShared( &handle_lock );
+}
+
 /***********************************************************************
  *           get_any_obj_ptr
  *
@@ -1083,13 +1125,13 @@ INT WINAPI GetObjectA( HGDIOBJ handle, INT count, LPVOID buffer )
 
     TRACE("%p %d %p\n", handle, count, buffer );
 
-    EnterCriticalSection( &gdi_section );
+    AcquireSRWLockShared( &handle_lock );
     if ((entry = handle_entry( handle )))
     {
         funcs = entry->funcs;
         handle = entry_to_handle( entry );  /* make it a full handle */
     }
-    LeaveCriticalSection( &gdi_section );
+    ReleaseSRWLockShared( &handle_lock );
 
     if (funcs)
     {
@@ -1114,13 +1156,13 @@ INT WINAPI GetObjectW( HGDIOBJ handle, INT count, LPVOID buffer )
 
     TRACE("%p %d %p\n", handle, count, buffer );
 
-    EnterCriticalSection( &gdi_section );
+    AcquireSRWLockShared( &handle_lock );
     if ((entry = handle_entry( handle )))
     {
         funcs = entry->funcs;
         handle = entry_to_handle( entry );  /* make it a full handle */
     }
-    LeaveCriticalSection( &gdi_section );
+    ReleaseSRWLockShared( &handle_lock );
 
     if (funcs)
     {
@@ -1142,9 +1184,9 @@ DWORD WINAPI GetObjectType( HGDIOBJ handle )
     struct gdi_handle_entry *entry;
     DWORD result = 0;
 
-    EnterCriticalSection( &gdi_section );
+    AcquireSRWLockShared( &handle_lock );
     if ((entry = handle_entry( handle ))) result = entry->type;
-    LeaveCriticalSection( &gdi_section );
+    ReleaseSRWLockShared( &handle_lock );
 
     TRACE("%p -> %u\n", handle, result );
     if (!result) SetLastError( ERROR_INVALID_HANDLE );
@@ -1222,13 +1264,13 @@ HGDIOBJ WINAPI SelectObject( HDC hdc, HGDIOBJ hObj )
 
     TRACE( "(%p,%p)\n", hdc, hObj );
 
-    EnterCriticalSection( &gdi_section );
+    AcquireSRWLockShared( &handle_lock );
     if ((entry = handle_entry( hObj )))
     {
         funcs = entry->funcs;
         hObj = entry_to_handle( entry );  /* make it a full handle */
     }
-    LeaveCriticalSection( &gdi_section );
+    ReleaseSRWLockShared( &handle_lock );
 
     if (funcs && funcs->pSelectObject) return funcs->pSelectObject( hObj, hdc );
     return 0;
@@ -1243,13 +1285,13 @@ BOOL WINAPI UnrealizeObject( HGDIOBJ obj )
     const struct gdi_obj_funcs *funcs = NULL;
     struct gdi_handle_entry *entry;
 
-    EnterCriticalSection( &gdi_section );
+    AcquireSRWLockShared( &handle_lock );
     if ((entry = handle_entry( obj )))
     {
         funcs = entry->funcs;
         obj = entry_to_handle( entry );  /* make it a full handle */
     }
-    LeaveCriticalSection( &gdi_section );
+    ReleaseSRWLockShared( &handle_lock );
 
     if (funcs && funcs->pUnrealizeObject) return funcs->pUnrealizeObject( obj );
     return funcs != NULL;
@@ -2583,6 +2583,165 @@ static void REGION_FreeStorage(ScanLineListBlock *pSLLBlock)
     }
 }
 
+struct polygon_scan
+{
+    EdgeTable          ET;          /* header node for ET      */
+    EdgeTableEntry    *pETEs;       /* EdgeTableEntries pool   */
+    ScanLineListBlock  SLLBlock;    /* header for scanlinelist */
+    int               *spans;       /* span buffer for one scanline */
+};
+
+/***********************************************************************
+ *     init_polygon_scan
+ *
+ * Builds the edge table of a polygon.  Returns the number of edge
+ * crossings, or 0 if there is nothing to scan.
+ */
+static unsigned int init_polygon_scan( struct polygon_scan *scan, const POINT *Pts, const INT *Count,
+                                       INT nbpolygons, const RECT *clip_rect )
+{
+    unsigned int nb_points;
+    INT poly, total;
+
+    scan->SLLBlock.next = NULL;
+    scan->spans = NULL;
+
+    for(poly = total = 0; poly < nbpolygons; poly++)
+        total += Count[poly];
+    if (! (scan->pETEs = HeapAlloc( GetProcessHeap(), 0, (sizeof(EdgeTableEntry) + sizeof(int)) * total )))
+	return 0;
+    scan->spans = (int *)(scan->pETEs + total);
+
+    if (!(nb_points = REGION_CreateEdgeTable( Count, nbpolygons, Pts, &scan->ET, scan->pETEs,
+                                              &scan->SLLBlock, clip_rect )))
+        return 0;
+    if (clip_rect) scan->ET.ymax = min( scan->ET.ymax, clip_rect->bottom );
+    return nb_points;
+}
+
+/***********************************************************************
+ *     run_polygon_scan
+ *
+ * Walks the scanlines of a polygon and passes the non-empty spans of each
+ * one to the callback, sorted by x, as pairs of left and right coordinates.
+ */
+static void run_polygon_scan( struct polygon_scan *scan, INT mode, const RECT *clip_rect,
+                              polygon_spans_func func, void *context )
+{
+    INT y;                           /* current scanline        */
+    struct list WETE, *pWETE;        /* Winding Edge Table */
+    ScanLineList *pSLL;              /* current scanLineList    */
+    struct list AET;                 /* header for AET     */
+    struct edge_table_entry *active;
+    unsigned int count;
+    int *spans = scan->spans;
+    BOOL first;
+
+    list_init( &AET );
+    list_init( &WETE );
+    pSLL = scan->ET.scanlines.next;
+
+    /*
+     *  for each scanline
+     */
+    for (y = scan->ET.ymin; y < scan->ET.ymax; y++)
+    {
+        /*
+         *  Add a new edge to the active edge table when we
+         *  get to the next edge.
+         */
+        if (pSLL != NULL && y == pSLL->scanline)
+        {
+            REGION_loadAET( &AET, &pSLL->edgelist );
+            if (mode == WINDING) REGION_computeWAET( &AET, &WETE );
+            pSLL = pSLL->next;
+        }
+
+        if (!clip_rect || y >= clip_rect->top)
+        {
+            count = 0;
+            first = TRUE;
+            pWETE = list_head( &WETE );
+            LIST_FOR_EACH_ENTRY( active, &AET, struct edge_table_entry, entry )
+            {
+                /*
+                 *  in winding mode, only use those edges that
+                 *  are in the Winding active edge table.
+                 */
+                if (mode == WINDING)
+                {
+                    if (pWETE != &active->winding_entry) continue;
+                    pWETE = list_next( &WETE, pWETE );
+                }
+                if (first) spans[2 * count] = active->bres.minor_axis;
+                else if (spans[2 * count] != active->bres.minor_axis)
+                    spans[2 * count++ + 1] = active->bres.minor_axis;
+                first = !first;
+            }
+            func( context, y, spans, count );
+        }
+
+        /*
+         *  recompute the winding active edge table if
+         *  we just resorted or have exited an edge.
+         */
+        if (next_scanline( &AET, y ) && mode == WINDING) REGION_computeWAET( &AET, &WETE );
+    }
+}
+
+static void free_polygon_scan( struct polygon_scan *scan )
+{
+    REGION_FreeStorage( scan->SLLBlock.next );
+    HeapFree( GetProcessHeap(), 0, scan->pETEs );
+}
+
+/***********************************************************************
+ *           scan_polypolygon
+ *
+ * Scan-converts a polygon without building a region, passing the spans
+ * of each scanline inside the clip rectangle to the callback.
+ */
+BOOL scan_polypolygon( const POINT *pts, const INT *count, INT nbpolygons, INT mode,
+                       const RECT *clip_rect, polygon_spans_func func, void *context )
+{
+    struct polygon_scan scan;
+    BOOL ret;
+
+    if (init_polygon_scan( &scan, pts, count, nbpolygons, clip_rect ))
+        run_polygon_scan( &scan, mode, clip_rect, func, context );
+    ret = scan.pETEs != NULL;
+    free_polygon_scan( &scan );
+    return ret;
+}
+
+struct region_spans
+{
+    WINEREGION *obj;
+    int         cur_band;
+    int         prev_band;
+};
+
+static void add_region_spans( void *context, int y, const int *spans, unsigned int count )
+{
+    struct region_spans *ctx = context;
+    WINEREGION *obj = ctx->obj;
+    unsigned int i;
+
+    for (i = 0; i < count; i++)
+    {
+        obj->rects[obj->numRects].left = spans[2 * i];
+        obj->rects[obj->numRects].top = y;
+        obj->rects[obj->numRects].right = spans[2 * i + 1];
+        obj->rects[obj->numRects].bottom = y + 1;
+        obj->numRects++;
+    }
+    if (obj->numRects)
+    {
+        ctx->prev_band = REGION_Coalesce( obj, ctx->prev_band, ctx->cur_band );
+        ctx->cur_band = obj->numRects;
+    }
+}
+
 /***********************************************************************
  *           create_polypolygon_region
  *
@@ -2593,17 +2752,10 @@ HRGN create_polypolygon_region( const POINT *Pts, const INT *Count, INT nbpolygo
 {
     HRGN hrgn = 0;
     WINEREGION *obj = NULL;
-    INT y;                           /* current scanline        */
-    struct list WETE, *pWETE;        /* Winding Edge Table */
-    ScanLineList *pSLL;              /* current scanLineList    */
-    EdgeTable ET;                    /* header node for ET      */
-    struct list AET;                 /* header for AET     */
-    EdgeTableEntry *pETEs;           /* EdgeTableEntries pool   */
-    ScanLineListBlock SLLBlock;      /* header for scanlinelist */
-    struct edge_table_entry *active;
+    struct polygon_scan scan;
+    struct region_spans ctx;
     unsigned int nb_points;
-    int cur_band = 0, prev_band = 0;
-    INT i, poly, total, first = 1;
+    INT i;
 
     TRACE("%p, count %d, polygons %d, mode %d\n", Pts, *Count, nbpolygons, mode);
 
@@ -2622,120 +2774,14 @@ HRGN create_polypolygon_region( const POINT *Pts, const INT *Count, INT nbpolygo
         return CreateRectRgn( min(Pts[0].x, Pts[2].x), min(Pts[0].y, Pts[2].y),
                               max(Pts[0].x, Pts[2].x), max(Pts[0].y, Pts[2].y) );
 
-    for(poly = total = 0; poly < nbpolygons; poly++)
-        total += Count[poly];
-    if (! (pETEs = HeapAlloc( GetProcessHeap(), 0, sizeof(EdgeTableEntry) * total )))
-	return 0;
-
-    if (!(nb_points = REGION_CreateEdgeTable( Count, nbpolygons, Pts, &ET, pETEs, &SLLBlock, clip_rect )))
+    if (!(nb_points = init_polygon_scan( &scan, Pts, Count, nbpolygons, clip_rect )))
         goto done;
     if (!(obj = alloc_region( nb_points / 2 )))
         goto done;
 
-    if (clip_rect) ET.ymax = min( ET.ymax, clip_rect->bottom );
-    list_init( &AET );
-    pSLL = ET.scanlines.next;
-    if (mode != WINDING) {
-        /*
-         *  for each scanline
-         */
-        for (y = ET.ymin; y < ET.ymax; y++) {
-            /*
-             *  Add a new edge to the active edge table when we
-             *  get to the next edge.
-             */
-            if (pSLL != NULL && y == pSLL->scanline) {
-                REGION_loadAET(&AET, &pSLL->edgelist);
-                pSLL = pSLL->next;
-            }
-
-            if (!clip_rect || y >= clip_rect->top)
-            {
-                LIST_FOR_EACH_ENTRY( active, &AET, struct edge_table_entry, entry )
-                {
-                    if (first)
-                    {
-                        obj->rects[obj->numRects].left = active->bres.minor_axis;
-                        obj->rects[obj->numRects].top = y;
-                    }
-                    else if (obj->rects[obj->numRects].left != active->bres.minor_axis)
-                    {
-                        obj->rects[obj->numRects].right = active->bres.minor_axis;
-                        obj->rects[obj->numRects].bottom = y + 1;
-                        obj->numRects++;
-                    }
-                    first = !first;
-                }
-            }
-
-            next_scanline( &AET, y );
-
-            if (obj->numRects)
-            {
-                prev_band = REGION_Coalesce( obj, prev_band, cur_band );
-                cur_band = obj->numRects;
-            }
-        }
-    }
-    else {
-        /*
-         *  for each scanline
-         */
-        for (y = ET.ymin; y < ET.ymax; y++) {
-            /*
-             *  Add a new edge to the active edge table when we
-             *  get to the next edge.
-             */
-            if (pSLL != NULL && y == pSLL->scanline) {
-                REGION_loadAET(&AET, &pSLL->edgelist);
-                REGION_computeWAET( &AET, &WETE );
-                pSLL = pSLL->next;
-            }
-            pWETE = list_head( &WETE );
-
-            /*
-             *  for each active edge
-             */
-            if (!clip_rect || y >= clip_rect->top)
-            {
-                LIST_FOR_EACH_ENTRY( active, &AET, struct edge_table_entry, entry )
-                {
-                    /*
-                     *  add to the buffer only those edges that
-                     *  are in the Winding active edge table.
-                     */
-                    if (pWETE == &active->winding_entry)
-                    {
-                        if (first)
-                        {
-                            obj->rects[obj->numRects].left = active->bres.minor_axis;
-                            obj->rects[obj->numRects].top = y;
-                        }
-                        else if (obj->rects[obj->numRects].left != active->bres.minor_axis)
-                        {
-                            obj->rects[obj->numRects].right = active->bres.minor_axis;
-                            obj->rects[obj->numRects].bottom = y + 1;
-                            obj->numRects++;
-                        }
-                        first = !first;
-                        pWETE = list_next( &WETE, pWETE );
-                    }
-                }
-            }
-
-            /*
-             *  recompute the winding active edge table if
-             *  we just resorted or have exited an edge.
-             */
-            if (next_scanline( &AET, y )) REGION_computeWAET( &AET, &WETE );
-
-            if (obj->numRects)
-            {
-                prev_band = REGION_Coalesce( obj, prev_band, cur_band );
-                cur_band = obj->numRects;
-            }
-        }
-    }
+    ctx.obj = obj;
+    ctx.cur_band = ctx.prev_band = 0;
+    run_polygon_scan( &scan, mode, clip_rect, add_region_spans, &ctx );
 
     assert( obj->numRects <= nb_points / 2 );
 
@@ -2757,8 +2803,7 @@ HRGN create_polypolygon_region( const POINT *Pts, const INT *Count, INT nbpolygo
         free_region( obj );
 
 done:
-    REGION_FreeStorage(SLLBlock.next);
-    HeapFree( GetProcessHeap(), 0, pETEs );
+    free_polygon_scan( &scan );
     return hrgn;
 }
 
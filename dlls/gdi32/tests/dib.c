@@ -3516,11 +3516,350 @@ static void test_simple_graphics(void)
     DeleteDC(mem_dc);
 }
 
+static void fill_polygon_star( HDC hdc, BOOL path, const POINT *pts, const INT *counts, int polygons )
+{
+    if (!path)
+    {
+        PolyPolygon( hdc, pts, counts, polygons );
+        return;
+    }
+    BeginPath( hdc );
+    PolyPolygon( hdc, pts, counts, polygons );
+    EndPath( hdc );
+    FillPath( hdc );
+}
+
+static void test_polygon_fill(void)
+{
+    BITMAPINFO bmi = {{ sizeof(bmi.bmiHeader), 200, -200, 1, 32, BI_RGB }};
+    POINT pts[24];
+    INT counts[2] = { 11, 13 };
+    DWORD *bits, *ref;
+    HDC hdc, ref_dc;
+    HBITMAP dib, ref_dib;
+    HBRUSH brush;
+    HRGN rgn, clip;
+    int i, mode, clipping, path;
+
+    /* a many-sided star and a self-intersecting zigzag, partly off the bitmap */
+    for (i = 0; i < 11; i++)
+    {
+        pts[i].x = 100 + ((i & 1) ? 30 : 95) * cos( i * 2 * M_PI / 11 );
+        pts[i].y = 100 + ((i & 1) ? 30 : 95) * sin( i * 2 * M_PI / 11 );
+    }
+    for (i = 0; i < 13; i++)
+    {
+        pts[11 + i].x = -20 + i * 19;
+        pts[11 + i].y = (i & 1) ? 40 : 230;
+    }
+
+    hdc = CreateCompatibleDC( 0 );
+    ref_dc = CreateCompatibleDC( 0 );
+    dib = CreateDIBSection( hdc, &bmi, DIB_RGB_COLORS, (void **)&bits, NULL, 0 );
+    ref_dib = CreateDIBSection( ref_dc, &bmi, DIB_RGB_COLORS, (void **)&ref, NULL, 0 );
+    SelectObject( hdc, dib );
+    SelectObject( ref_dc, ref_dib );
+    SelectObject( hdc, GetStockObject( NULL_PEN ));
+    brush = CreateSolidBrush( RGB( 0x12, 0x34, 0x56 ));
+    SelectObject( hdc, brush );
+
+    /* the polygon must cover the same pixels as the equivalent region */
+    for (mode = ALTERNATE; mode <= WINDING; mode++)
+    for (clipping = 0; clipping < 3; clipping++)
+    for (path = 0; path < 2; path++)
+    {
+        memset( bits, 0, 200 * 200 * 4 );
+        memset( ref, 0, 200 * 200 * 4 );
+
+        clip = 0;
+        if (clipping == 1) clip = CreateRectRgn( 10, 20, 150, 170 );
+        else if (clipping == 2)
+        {
+            clip = CreateRectRgn( 0, 0, 60, 200 );
+            rgn = CreateRectRgn( 100, 50, 180, 120 );
+            CombineRgn( clip, clip, rgn, RGN_OR );
+            DeleteObject( rgn );
+        }
+        SelectClipRgn( hdc, clip );
+        SelectClipRgn( ref_dc, clip );
+
+        SetPolyFillMode( hdc, mode );
+        fill_polygon_star( hdc, path, pts, counts, 2 );
+
+        rgn = CreatePolyPolygonRgn( pts, counts, 2, mode );
+        FillRgn( ref_dc, rgn, brush );
+        DeleteObject( rgn );
+        if (clip) DeleteObject( clip );
+
+        ok( !memcmp( bits, ref, 200 * 200 * 4 ), "mode %d clipping %d path %d: fill differs from region\n",
+            mode, clipping, path );
+    }
+
+    DeleteDC( hdc );
+    DeleteDC( ref_dc );
+    DeleteObject( dib );
+    DeleteObject( ref_dib );
+    DeleteObject( brush );
+}
+
+/* Windows doesn't use a plain box filter for HALFTONE, so only check that
+ * each destination pixel is close to the average of its source block. */
+static BOOL halftone_match( BYTE got, int expected )
+{
+    return abs( got - expected ) <= 4;
+}
+
+static void test_halftone_stretch(void)
+{
+    BITMAPINFO bmi = {{ sizeof(bmi.bmiHeader), 0, 0, 1, 32, BI_RGB }};
+    BYTE *src_bits, *dst_bits, *pixel;
+    HDC src_dc, dst_dc;
+    HBITMAP src_dib, dst_dib, orig_src, orig_dst;
+    DWORD src_stride, dst_stride;
+    int x, y;
+
+    src_dc = CreateCompatibleDC( 0 );
+    dst_dc = CreateCompatibleDC( 0 );
+    SetStretchBltMode( dst_dc, HALFTONE );
+
+    /* 2:1 in both directions, the four pixels of each block are within 3 of their average */
+    bmi.bmiHeader.biWidth = 8;
+    bmi.bmiHeader.biHeight = -4;
+    src_dib = CreateDIBSection( src_dc, &bmi, DIB_RGB_COLORS, (void **)&src_bits, NULL, 0 );
+    bmi.bmiHeader.biWidth = 4;
+    bmi.bmiHeader.biHeight = -2;
+    dst_dib = CreateDIBSection( dst_dc, &bmi, DIB_RGB_COLORS, (void **)&dst_bits, NULL, 0 );
+    orig_src = SelectObject( src_dc, src_dib );
+    orig_dst = SelectObject( dst_dc, dst_dib );
+
+    for (y = 0; y < 4; y++)
+        for (x = 0; x < 8; x++)
+        {
+            pixel = src_bits + (y * 8 + x) * 4;
+            pixel[0] = 40 * (x / 2) + 2 * (x % 2) + 4 * (y % 2);
+            pixel[1] = 30 * (y / 2) + 2 * (x % 2) + 4 * (y % 2);
+            pixel[2] = 0x80;
+            pixel[3] = 0;
+        }
+    StretchBlt( dst_dc, 0, 0, 4, 2, src_dc, 0, 0, 8, 4, SRCCOPY );
+
+    for (y = 0; y < 2; y++)
+        for (x = 0; x < 4; x++)
+        {
+            pixel = dst_bits + (y * 4 + x) * 4;
+            ok( halftone_match( pixel[0], 40 * x + 3 ) && halftone_match( pixel[1], 30 * y + 3 ) &&
+                halftone_match( pixel[2], 0x80 ),
+                "32 bpp %d,%d: got %02x,%02x,%02x\n", x, y, pixel[0], pixel[1], pixel[2] );
+        }
+
+    SelectObject( src_dc, orig_src );
+    SelectObject( dst_dc, orig_dst );
+    DeleteObject( src_dib );
+    DeleteObject( dst_dib );
+
+    /* 3:1 horizontally only */
+    bmi.bmiHeader.biBitCount = 24;
+    bmi.bmiHeader.biWidth = 6;
+    bmi.bmiHeader.biHeight = -2;
+    src_dib = CreateDIBSection( src_dc, &bmi, DIB_RGB_COLORS, (void **)&src_bits, NULL, 0 );
+    src_stride = get_stride( &bmi );
+    bmi.bmiHeader.biWidth = 2;
+    dst_dib = CreateDIBSection( dst_dc, &bmi, DIB_RGB_COLORS, (void **)&dst_bits, NULL, 0 );
+    dst_stride = get_stride( &bmi );
+    SelectObject( src_dc, src_dib );
+    SelectObject( dst_dc, dst_dib );
+
+    for (y = 0; y < 2; y++)
+        for (x = 0; x < 6; x++)
+        {
+            pixel = src_bits + y * src_stride + x * 3;
+            pixel[0] = 50 * (x / 3) + 3 * (x % 3);
+            pixel[1] = 20 * y;
+            pixel[2] = 0x40;
+        }
+    StretchBlt( dst_dc, 0, 0, 2, 2, src_dc, 0, 0, 6, 2, SRCCOPY );
+
+    for (y = 0; y < 2; y++)
+        for (x = 0; x < 2; x++)
+        {
+            pixel = dst_bits + y * dst_stride + x * 3;
+            ok( halftone_match( pixel[0], 50 * x + 3 ) && halftone_match( pixel[1], 20 * y ) &&
+                halftone_match( pixel[2], 0x40 ),
+                "24 bpp %d,%d: got %02x,%02x,%02x\n", x, y, pixel[0], pixel[1], pixel[2] );
+        }
+
+    SelectObject( src_dc, orig_src );
+    SelectObject( dst_dc, orig_dst );
+    DeleteDC( src_dc );
+    DeleteDC( dst_dc );
+    DeleteObject( src_dib );
+    DeleteObject( dst_dib );
+}
+
+static void test_banded_blits(void)
+{
+    static const int size = 1024, strip = 32;
+    BITMAPINFO bmi = {{ sizeof(bmi.bmiHeader), 1024, -1024, 1, 32, BI_RGB }};
+    BLENDFUNCTION blend = { AC_SRC_OVER, 0, 0xc0, AC_SRC_ALPHA };
+    DWORD *src_bits, *bits, *ref_bits;
+    HBITMAP src_dib, dib, ref_dib;
+    HDC src_dc, hdc, ref_dc;
+    int i, y;
+
+    src_dc = CreateCompatibleDC( 0 );
+    hdc = CreateCompatibleDC( 0 );
+    ref_dc = CreateCompatibleDC( 0 );
+    src_dib = CreateDIBSection( src_dc, &bmi, DIB_RGB_COLORS, (void **)&src_bits, NULL, 0 );
+    dib = CreateDIBSection( hdc, &bmi, DIB_RGB_COLORS, (void **)&bits, NULL, 0 );
+    ref_dib = CreateDIBSection( ref_dc, &bmi, DIB_RGB_COLORS, (void **)&ref_bits, NULL, 0 );
+    SelectObject( src_dc, src_dib );
+    SelectObject( hdc, dib );
+    SelectObject( ref_dc, ref_dib );
+
+    for (i = 0; i < size * size; i++)
+    {
+        src_bits[i] = i * 2654435761u;
+        bits[i] = ref_bits[i] = i * 0x9e3779b9;
+    }
+
+    /* a single blit large enough to be split into bands, against strips small enough not to be */
+    StretchBlt( hdc, 8, 4, size - 16, size - 8, src_dc, 0, 0, size - 16, size - 8, SRCINVERT );
+    for (y = 0; y < size - 8; y += strip)
+        StretchBlt( ref_dc, 8, 4 + y, size - 16, min( strip, size - 8 - y ),
+                    src_dc, 0, y, size - 16, min( strip, size - 8 - y ), SRCINVERT );
+    ok( !memcmp( bits, ref_bits, size * size * 4 ), "StretchBlt: banded output differs\n" );
+
+    GdiAlphaBlend( hdc, 4, 8, size - 8, size - 16, src_dc, 2, 2, size - 8, size - 16, blend );
+    for (y = 0; y < size - 16; y += strip)
+        GdiAlphaBlend( ref_dc, 4, 8 + y, size - 8, min( strip, size - 16 - y ),
+                       src_dc, 2, 2 + y, size - 8, min( strip, size - 16 - y ), blend );
+    ok( !memcmp( bits, ref_bits, size * size * 4 ), "AlphaBlend: banded output differs\n" );
+
+    DeleteDC( src_dc );
+    DeleteDC( hdc );
+    DeleteDC( ref_dc );
+    DeleteObject( src_dib );
+    DeleteObject( dib );
+    DeleteObject( ref_dib );
+}
+
+static BYTE ref_blend_color( BYTE dst, BYTE src, DWORD alpha )
+{
+    return (src * alpha + dst * (255 - alpha) + 127) / 255;
+}
+
+/* blend one channel at a time; an out-of-range premultiplied channel carries into the next one */
+static DWORD ref_blend_pixel( DWORD dst, DWORD src, BLENDFUNCTION blend )
+{
+    DWORD alpha = blend.SourceConstantAlpha;
+    BYTE b, g, r, a;
+
+    if (!(blend.AlphaFormat & AC_SRC_ALPHA))
+        return (ref_blend_color( dst, src, alpha ) |
+                ref_blend_color( dst >> 8, src >> 8, alpha ) << 8 |
+                ref_blend_color( dst >> 16, src >> 16, alpha ) << 16 |
+                ref_blend_color( dst >> 24, src >> 24, alpha ) << 24);
+
+    b = ((BYTE)src * alpha + 127) / 255;
+    g = ((BYTE)(src >> 8) * alpha + 127) / 255;
+    r = ((BYTE)(src >> 16) * alpha + 127) / 255;
+    a = ((BYTE)(src >> 24) * alpha + 127) / 255;
+    return ((b + ((BYTE)dst * (255 - a) + 127) / 255) |
+            (g + ((BYTE)(dst >> 8) * (255 - a) + 127) / 255) << 8 |
+            (r + ((BYTE)(dst >> 16) * (255 - a) + 127) / 255) << 16 |
+            (a + ((BYTE)(dst >> 24) * (255 - a) + 127) / 255) << 24);
+}
+
+static BOOL is_premultiplied( DWORD pixel )
+{
+    BYTE a = pixel >> 24;
+
+    return (BYTE)pixel <= a && (BYTE)(pixel >> 8) <= a && (BYTE)(pixel >> 16) <= a;
+}
+
+static void test_alpha_blend_exact(void)
+{
+    static const DWORD src_pixels[] =
+    {
+        0x00000000, 0x00ff80ff, 0xff000000, 0xff123456, 0xffffffff, 0x80604020, 0x7f7f007f,
+        /* not premultiplied, the channels spill over into the next one */
+        0x10ff80ff, 0x01ffffff, 0x7fff00ff, 0x80ff80ff,
+    };
+    static const DWORD dst_pixels[] = { 0x00000000, 0xffffffff, 0x80ff7f01, 0x12345678, 0x00ff00ff };
+    static const BLENDFUNCTION blends[] =
+    {
+        { AC_SRC_OVER, 0, 0xff, AC_SRC_ALPHA },
+        { AC_SRC_OVER, 0, 0x00, AC_SRC_ALPHA },
+        { AC_SRC_OVER, 0, 0x80, AC_SRC_ALPHA },
+        { AC_SRC_OVER, 0, 0x01, AC_SRC_ALPHA },
+        { AC_SRC_OVER, 0, 0xff, 0 },
+        { AC_SRC_OVER, 0, 0x00, 0 },
+        { AC_SRC_OVER, 0, 0x7f, 0 },
+    };
+    BITMAPINFO bmi = {{ sizeof(bmi.bmiHeader), 1, 1, 1, 32, BI_RGB }};
+    HBITMAP src_dib, dib, dib24;
+    DWORD *src_bits, *bits, expect;
+    HDC src_dc, hdc, hdc24;
+    BYTE *bits24;
+    int i, j, k;
+
+    src_dc = CreateCompatibleDC( 0 );
+    hdc = CreateCompatibleDC( 0 );
+    hdc24 = CreateCompatibleDC( 0 );
+    src_dib = CreateDIBSection( src_dc, &bmi, DIB_RGB_COLORS, (void **)&src_bits, NULL, 0 );
+    dib = CreateDIBSection( hdc, &bmi, DIB_RGB_COLORS, (void **)&bits, NULL, 0 );
+    bmi.bmiHeader.biBitCount = 24;
+    dib24 = CreateDIBSection( hdc24, &bmi, DIB_RGB_COLORS, (void **)&bits24, NULL, 0 );
+    SelectObject( src_dc, src_dib );
+    SelectObject( hdc, dib );
+    SelectObject( hdc24, dib24 );
+
+    /* the blending code works on two channels at a time, check that it matches per-channel blending exactly */
+    for (i = 0; i < ARRAY_SIZE(src_pixels); i++)
+        for (j = 0; j < ARRAY_SIZE(dst_pixels); j++)
+            for (k = 0; k < ARRAY_SIZE(blends); k++)
+            {
+                BOOL premultiplied = !(blends[k].AlphaFormat & AC_SRC_ALPHA) || is_premultiplied( src_pixels[i] );
+
+                *src_bits = src_pixels[i];
+                expect = ref_blend_pixel( dst_pixels[j], src_pixels[i], blends[k] );
+
+                *bits = dst_pixels[j];
+                GdiAlphaBlend( hdc, 0, 0, 1, 1, src_dc, 0, 0, 1, 1, blends[k] );
+                /* Windows doesn't define the result for sources that aren't premultiplied */
+                ok( *bits == expect || broken( !premultiplied ),
+                    "32 bpp src %08x dst %08x alpha %02x format %x: got %08x, expected %08x\n",
+                    src_pixels[i], dst_pixels[j], blends[k].SourceConstantAlpha,
+                    blends[k].AlphaFormat, *bits, expect );
+
+                bits24[0] = dst_pixels[j];
+                bits24[1] = dst_pixels[j] >> 8;
+                bits24[2] = dst_pixels[j] >> 16;
+                expect = ref_blend_pixel( dst_pixels[j] & 0xffffff, src_pixels[i], blends[k] ) & 0xffffff;
+                GdiAlphaBlend( hdc24, 0, 0, 1, 1, src_dc, 0, 0, 1, 1, blends[k] );
+                ok( (bits24[0] | bits24[1] << 8 | bits24[2] << 16) == expect || broken( !premultiplied ),
+                    "24 bpp src %08x dst %06x alpha %02x format %x: got %02x%02x%02x, expected %06x\n",
+                    src_pixels[i], dst_pixels[j] & 0xffffff, blends[k].SourceConstantAlpha,
+                    blends[k].AlphaFormat, bits24[2], bits24[1], bits24[0], expect );
+            }
+
+    DeleteDC( src_dc );
+    DeleteDC( hdc );
+    DeleteDC( hdc24 );
+    DeleteObject( src_dib );
+    DeleteObject( dib );
+    DeleteObject( dib24 );
+}
+
 START_TEST(dib)
 {
     CryptAcquireContextW(&crypt_prov, NULL, NULL, PROV_RSA_FULL, CRYPT_VERIFYCONTEXT);
 
     test_simple_graphics();
+    test_polygon_fill();
+    test_halftone_stretch();
+    test_banded_blits();
+    test_alpha_blend_exact();
 
     CryptReleaseContext(crypt_prov, 0);
 }
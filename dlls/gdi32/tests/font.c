@@ -6857,10 +6857,91 @@ static void test_long_names(void)
     ReleaseDC(NULL, dc);
 }
 
+static void run_font_cache_child( const char *family, BOOL present )
+{
+    PROCESS_INFORMATION pi;
+    STARTUPINFOA si = { sizeof(si) };
+    char cmdline[MAX_PATH * 2], **argv;
+
+    /* deleting the volatile cache key makes the child the first process of a new session,
+     * which checks whether the font cache is still up to date */
+    RegDeleteKeyA( HKEY_CURRENT_USER, "Software\\Wine\\Fonts\\Cache" );
+
+    winetest_get_mainargs( &argv );
+    sprintf( cmdline, "\"%s\" font font_cache %s %d", argv[0], family, present );
+    ok( CreateProcessA( NULL, cmdline, NULL, NULL, FALSE, 0, NULL, NULL, &si, &pi ),
+        "CreateProcess failed, error %u\n", GetLastError() );
+    winetest_wait_child_process( pi.hProcess );
+    CloseHandle( pi.hProcess );
+    CloseHandle( pi.hThread );
+}
+
+static void test_font_cache_child( const char *family, BOOL present )
+{
+    ok( is_truetype_font_installed( family ) == present, "font %s %s\n",
+        family, present ? "not found" : "still present" );
+}
+
+static void test_font_cache_rebuild(void)
+{
+    char fonts_dir[MAX_PATH], font_path[MAX_PATH], tmp_path[MAX_PATH];
+    HKEY hkey;
+
+    if (RegOpenKeyA( HKEY_CURRENT_USER, "Software\\Wine\\Fonts\\Cache", &hkey ))
+    {
+        skip( "no font cache\n" );
+        return;
+    }
+    RegCloseKey( hkey );
+
+    GetWindowsDirectoryA( fonts_dir, MAX_PATH );
+    strcat( fonts_dir, "\\Fonts" );
+    sprintf( font_path, "%s\\wine_cache_test.ttf", fonts_dir );
+
+    if (!write_ttf_file( "wine_test.ttf", tmp_path ))
+    {
+        skip( "failed to create ttf file for testing\n" );
+        return;
+    }
+    if (!CopyFileA( tmp_path, font_path, FALSE ))
+    {
+        skip( "can't write to %s\n", fonts_dir );
+        DeleteFileA( tmp_path );
+        return;
+    }
+    DeleteFileA( tmp_path );
+
+    /* a file added to a font directory */
+    run_font_cache_child( "wine_test", TRUE );
+
+    /* a font file rewritten in place, which doesn't change the directory */
+    if (write_ttf_file( "wine_vdmx.ttf", tmp_path ))
+    {
+        ok( CopyFileA( tmp_path, font_path, FALSE ), "CopyFile failed, error %u\n", GetLastError() );
+        DeleteFileA( tmp_path );
+        run_font_cache_child( "wine_vdmx", TRUE );
+        run_font_cache_child( "wine_test", FALSE );
+    }
+
+    /* a file removed from a font directory */
+    DeleteFileA( font_path );
+    run_font_cache_child( "wine_vdmx", FALSE );
+}
+
 START_TEST(font)
 {
+    int argc;
+    char **argv;
+
     init();
 
+    argc = winetest_get_mainargs( &argv );
+    if (argc >= 5 && !strcmp( argv[2], "font_cache" ))
+    {
+        test_font_cache_child( argv[3], atoi( argv[4] ));
+        return;
+    }
+
     test_stock_fonts();
     test_logfont();
     test_bitmap_font();
@@ -6922,6 +7003,7 @@ START_TEST(font)
     test_bitmap_font_glyph_index();
     test_GetCharWidthI();
     test_long_names();
+    test_font_cache_rebuild();
 
     /* These tests should be last test until RemoveFontResource
      * is properly implemented.
@@ -194,6 +194,61 @@ static void test_thread_objects(void)
     CloseHandle(hgdiobj_event.ready_event);
 }
 
+static DWORD WINAPI dc_thread_proc(void *param)
+{
+    COLORREF color = RGB(0, 0, (LONG_PTR)param), pixel;
+    HBITMAP bitmap, old_bitmap;
+    HBRUSH brush, old_brush;
+    DWORD type;
+    HDC hdc;
+    int i;
+
+    for (i = 0; i < 200; i++)
+    {
+        hdc = CreateCompatibleDC(NULL);
+        ok(hdc != NULL, "CreateCompatibleDC error %u\n", GetLastError());
+        bitmap = CreateBitmap(16, 16, 1, 32, NULL);
+        ok(bitmap != NULL, "CreateBitmap error %u\n", GetLastError());
+        brush = CreateSolidBrush(color);
+        ok(brush != NULL, "CreateSolidBrush error %u\n", GetLastError());
+
+        old_bitmap = SelectObject(hdc, bitmap);
+        old_brush = SelectObject(hdc, brush);
+        PatBlt(hdc, 0, 0, 16, 16, PATCOPY);
+        pixel = GetPixel(hdc, 8, 8);
+        ok(pixel == color, "got %08x, expected %08x\n", pixel, color);
+
+        type = GetObjectType(hdc);
+        ok(type == OBJ_MEMDC, "GetObjectType returned %u\n", type);
+        type = GetObjectType(brush);
+        ok(type == OBJ_BRUSH, "GetObjectType returned %u\n", type);
+
+        SelectObject(hdc, old_brush);
+        SelectObject(hdc, old_bitmap);
+        DeleteObject(brush);
+        DeleteObject(bitmap);
+        ok(DeleteDC(hdc), "DeleteDC error %u\n", GetLastError());
+        ok(!GetObjectType(hdc), "DC %p still valid\n", hdc);
+    }
+    return 0;
+}
+
+static void test_thread_dcs(void)
+{
+    HANDLE threads[4];
+    DWORD status;
+    int i;
+
+    for (i = 0; i < sizeof(threads) / sizeof(threads[0]); i++)
+    {
+        threads[i] = CreateThread(NULL, 0, dc_thread_proc, (void *)(LONG_PTR)(0x10 * (i + 1)), 0, NULL);
+        ok(threads[i] != NULL, "CreateThread error %u\n", GetLastError());
+    }
+    status = WaitForMultipleObjects(sizeof(threads) / sizeof(threads[0]), threads, TRUE, INFINITE);
+    ok(status == WAIT_OBJECT_0, "WaitForMultipleObjects returned %u\n", status);
+    for (i = 0; i < sizeof(threads) / sizeof(threads[0]); i++) CloseHandle(threads[i]);
+}
+
 static void test_GetCurrentObject(void)
 {
     DWORD type;
@@ -366,6 +421,7 @@ START_TEST(gdiobj)
 {
     test_gdi_objects();
     test_thread_objects();
+    test_thread_dcs();
     test_GetCurrentObject();
     test_region();
     test_handles_on_win64();
@@ -4163,6 +4163,68 @@ static void test_emf_WorldTransform(void)
     }
 }
 
+static int CALLBACK count_emf_records(HDC hdc, HANDLETABLE *ht, const ENHMETARECORD *emr,
+                                      int handles, LPARAM param)
+{
+    (*(int *)param)++;
+    return 1;
+}
+
+static void test_emf_replay(void)
+{
+    static const POINT pts[] = {{10, 10}, {90, 20}, {50, 90}, {5, 60}, {80, 80}, {20, 40}};
+    static const DWORD counts[] = {3, 3};
+    BITMAPINFO info = {{ sizeof(info.bmiHeader), 100, -100, 1, 32, BI_RGB }};
+    DWORD *bits, *first;
+    ENHMETAHEADER header;
+    RECT rect;
+    HDC hdcMetafile, hdc;
+    HENHMETAFILE hemf;
+    HBITMAP dib;
+    int i, records;
+    BOOL ret;
+
+    hdcMetafile = CreateEnhMetaFileA(0, NULL, NULL, NULL);
+    ok(hdcMetafile != 0, "CreateEnhMetaFileA error %d\n", GetLastError());
+    Rectangle(hdcMetafile, 0, 0, 100, 100);
+    Polygon(hdcMetafile, pts, 3);                     /* EMR_POLYGON16 */
+    PolyPolyline(hdcMetafile, pts, counts, 2);        /* EMR_POLYPOLYLINE16 */
+    PolyBezier(hdcMetafile, pts, 4);                  /* EMR_POLYBEZIER16 */
+    hemf = CloseEnhMetaFile(hdcMetafile);
+    ok(hemf != 0, "CloseEnhMetaFile error %d\n", GetLastError());
+
+    /* the frame is rounded to .01 mm, so playback isn't guaranteed to match
+     * direct drawing pixel for pixel; only compare playbacks with each other */
+    GetEnhMetaFileHeader(hemf, sizeof(header), &header);
+    SetRect(&rect, header.rclBounds.left, header.rclBounds.top, header.rclBounds.right, header.rclBounds.bottom);
+
+    hdc = CreateCompatibleDC(0);
+    dib = CreateDIBSection(hdc, &info, DIB_RGB_COLORS, (void **)&bits, NULL, 0);
+    SelectObject(hdc, dib);
+    first = HeapAlloc(GetProcessHeap(), 0, 100 * 100 * sizeof(DWORD));
+
+    /* later playbacks use the cached record list and must render the same */
+    for (i = 0; i < 3; i++)
+    {
+        memset(bits, 0xcc, 100 * 100 * sizeof(DWORD));
+        ret = PlayEnhMetaFile(hdc, hemf, &rect);
+        ok(ret, "%d: PlayEnhMetaFile failed\n", i);
+        if (!i) memcpy(first, bits, 100 * 100 * sizeof(DWORD));
+        else ok(!memcmp(first, bits, 100 * 100 * sizeof(DWORD)), "%d: playback differs\n", i);
+
+        records = 0;
+        ret = EnumEnhMetaFile(0, hemf, count_emf_records, &records, NULL);
+        ok(ret, "%d: EnumEnhMetaFile failed\n", i);
+        ok(records == 6, "%d: got %d records\n", i, records);
+    }
+    ok(first[50 * 100 + 50] != 0xcccccccc, "nothing drawn\n");
+
+    HeapFree(GetProcessHeap(), 0, first);
+    DeleteDC(hdc);
+    DeleteObject(dib);
+    DeleteEnhMetaFile(hemf);
+}
+
 START_TEST(metafile)
 {
     init_function_pointers();
@@ -4180,6 +4242,7 @@ START_TEST(metafile)
     test_emf_PolyPolyline();
     test_emf_GradientFill();
     test_emf_WorldTransform();
+    test_emf_replay();
 
     /* For win-format metafiles (mfdrv) */
     test_mf_SaveDC();
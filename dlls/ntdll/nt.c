@@ -2268,123 +2268,97 @@ NTSTATUS WINAPI NtQuerySystemInformation(
         {
             SYSTEM_PROCESS_INFORMATION* spi = SystemInformation;
             SYSTEM_PROCESS_INFORMATION* last = NULL;
-            HANDLE hSnap = 0;
-            WCHAR procname[1024];
-            WCHAR* exename;
-            DWORD wlen = 0;
-            DWORD procstructlen = 0;
+            data_size_t info_size = 16384, pos;
+            unsigned int process_count = 0, i, j;
+            char *buffer = NULL;
+            DWORD wlen, procstructlen;
 
-            SERVER_START_REQ( create_snapshot )
+            /* retrieve all the processes and threads in a single request */
+            for (;;)
             {
-                req->flags      = SNAP_PROCESS | SNAP_THREAD;
-                req->attributes = 0;
-                if (!(ret = wine_server_call( req )))
-                    hSnap = wine_server_ptr_handle( reply->handle );
-            }
-            SERVER_END_REQ;
-            len = 0;
-            while (ret == STATUS_SUCCESS)
-            {
-                SERVER_START_REQ( next_process )
+                if (!(buffer = RtlAllocateHeap( GetProcessHeap(), 0, info_size )))
                 {
-                    req->handle = wine_server_obj_handle( hSnap );
-                    req->reset = (len == 0);
-                    wine_server_set_reply( req, procname, sizeof(procname)-sizeof(WCHAR) );
-                    if (!(ret = wine_server_call( req )))
-                    {
-                        /* Make sure procname is 0 terminated */
-                        procname[wine_server_reply_size(reply) / sizeof(WCHAR)] = 0;
-
-                        /* Get only the executable name, not the path */
-                        if ((exename = strrchrW(procname, '\\')) != NULL) exename++;
-                        else exename = procname;
-
-                        wlen = (strlenW(exename) + 1) * sizeof(WCHAR);
-
-                        procstructlen = sizeof(*spi) + wlen + ((reply->threads - 1) * sizeof(SYSTEM_THREAD_INFORMATION));
-
-                        if (Length >= len + procstructlen)
-                        {
-                            /* ftCreationTime, ftUserTime, ftKernelTime;
-                             * vmCounters, ioCounters
-                             */
- 
-                            memset(spi, 0, sizeof(*spi));
-
-                            spi->NextEntryOffset = procstructlen - wlen;
-                            spi->dwThreadCount = reply->threads;
-
-                            /* spi->pszProcessName will be set later on */
-
-                            spi->dwBasePriority = reply->priority;
-                            spi->UniqueProcessId = UlongToHandle(reply->pid);
-                            spi->ParentProcessId = UlongToHandle(reply->ppid);
-                            spi->HandleCount = reply->handles;
-
-                            /* spi->ti will be set later on */
-
-                        }
-                        len += procstructlen;
-                    }
+                    ret = STATUS_NO_MEMORY;
+                    break;
                 }
-                SERVER_END_REQ;
- 
-                if (ret != STATUS_SUCCESS)
+                SERVER_START_REQ( list_processes )
                 {
-                    if (ret == STATUS_NO_MORE_FILES) ret = STATUS_SUCCESS;
-                    break;
+                    wine_server_set_reply( req, buffer, info_size );
+                    ret = wine_server_call( req );
+                    info_size = reply->info_size;
+                    process_count = reply->process_count;
                 }
+                SERVER_END_REQ;
+                if (ret != STATUS_INFO_LENGTH_MISMATCH) break;
+                RtlFreeHeap( GetProcessHeap(), 0, buffer );
+                buffer = NULL;
+            }
 
-                if (Length >= len)
+            len = 0;
+            pos = 0;
+            for (i = 0; ret == STATUS_SUCCESS && i < process_count; i++)
+            {
+                const struct process_info *process = (const struct process_info *)(buffer + pos);
+                const struct thread_info *thread;
+                const WCHAR *procname = (const WCHAR *)(process + 1);
+                const WCHAR *exename = procname;
+                DWORD namelen = process->name_len / sizeof(WCHAR);
+
+                /* Get only the executable name, not the path */
+                for (j = 0; j < namelen; j++)
+                    if (procname[j] == '\\') exename = procname + j + 1;
+                namelen -= exename - procname;
+                thread = (const struct thread_info *)((const char *)(process + 1) + ((process->name_len + 3) & ~3));
+                pos = (const char *)(thread + process->thread_count) - buffer;
+
+                wlen = (namelen + 1) * sizeof(WCHAR);
+                procstructlen = sizeof(*spi) + wlen + ((process->thread_count - 1) * sizeof(SYSTEM_THREAD_INFORMATION));
+                len += procstructlen;
+                if (Length < len) continue;
+
+                /* ftCreationTime, ftUserTime, ftKernelTime;
+                 * vmCounters, ioCounters
+                 */
+
+                memset(spi, 0, sizeof(*spi));
+
+                spi->NextEntryOffset = procstructlen - wlen;
+                spi->dwThreadCount = process->thread_count;
+                spi->dwBasePriority = process->priority;
+                spi->UniqueProcessId = UlongToHandle(process->pid);
+                spi->ParentProcessId = UlongToHandle(process->parent_pid);
+                spi->HandleCount = process->handle_count;
+
+                /* set thread info */
+                for (j = 0; j < process->thread_count; j++, thread++)
                 {
-                    int     i, j;
+                    /* ftKernelTime, ftUserTime, ftCreateTime;
+                     * dwTickCount, dwStartAddress
+                     */
 
-                    /* set thread info */
-                    i = j = 0;
-                    while (ret == STATUS_SUCCESS)
-                    {
-                        SERVER_START_REQ( next_thread )
-                        {
-                            req->handle = wine_server_obj_handle( hSnap );
-                            req->reset = (j == 0);
-                            if (!(ret = wine_server_call( req )))
-                            {
-                                j++;
-                                if (UlongToHandle(reply->pid) == spi->UniqueProcessId)
-                                {
-                                    /* ftKernelTime, ftUserTime, ftCreateTime;
-                                     * dwTickCount, dwStartAddress
-                                     */
-
-                                    memset(&spi->ti[i], 0, sizeof(spi->ti));
-
-                                    spi->ti[i].CreateTime.QuadPart = 0xdeadbeef;
-                                    spi->ti[i].ClientId.UniqueProcess = UlongToHandle(reply->pid);
-                                    spi->ti[i].ClientId.UniqueThread  = UlongToHandle(reply->tid);
-                                    spi->ti[i].dwCurrentPriority = reply->base_pri + reply->delta_pri;
-                                    spi->ti[i].dwBasePriority = reply->base_pri;
-                                    i++;
-                                }
-                            }
-                        }
-                        SERVER_END_REQ;
-                    }
-                    if (ret == STATUS_NO_MORE_FILES) ret = STATUS_SUCCESS;
+                    memset(&spi->ti[j], 0, sizeof(spi->ti));
 
-                    /* now append process name */
-                    spi->ProcessName.Buffer = (WCHAR*)((char*)spi + spi->NextEntryOffset);
-                    spi->ProcessName.Length = wlen - sizeof(WCHAR);
-                    spi->ProcessName.MaximumLength = wlen;
-                    memcpy( spi->ProcessName.Buffer, exename, wlen );
-                    spi->NextEntryOffset += wlen;
-
-                    last = spi;
-                    spi = (SYSTEM_PROCESS_INFORMATION*)((char*)spi + spi->NextEntryOffset);
+                    spi->ti[j].CreateTime.QuadPart = 0xdeadbeef;
+                    spi->ti[j].ClientId.UniqueProcess = UlongToHandle(process->pid);
+                    spi->ti[j].ClientId.UniqueThread  = UlongToHandle(thread->tid);
+                    spi->ti[j].dwCurrentPriority = thread->current_priority;
+                    spi->ti[j].dwBasePriority = thread->base_priority;
                 }
+
+                /* now append process name */
+                spi->ProcessName.Buffer = (WCHAR*)((char*)spi + spi->NextEntryOffset);
+                spi->ProcessName.Length = wlen - sizeof(WCHAR);
+                spi->ProcessName.MaximumLength = wlen;
+                memcpy( spi->ProcessName.Buffer, exename, namelen * sizeof(WCHAR) );
+                spi->ProcessName.Buffer[namelen] = 0;
+                spi->NextEntryOffset += wlen;
+
+                last = spi;
+                spi = (SYSTEM_PROCESS_INFORMATION*)((char*)spi + spi->NextEntryOffset);
             }
             if (ret == STATUS_SUCCESS && last) last->NextEntryOffset = 0;
             if (len > Length) ret = STATUS_INFO_LENGTH_MISMATCH;
-            if (hSnap) NtClose(hSnap);
+            RtlFreeHeap( GetProcessHeap(), 0, buffer );
         }
         break;
     case SystemProcessorPerformanceInformation:
@@ -459,14 +459,33 @@ static LRESULT call_hook( struct hook_info *info, INT code, WPARAM wparam, LPARA
 }
 
 
+/***********************************************************************
+ *           get_hooks_serial
+ *
+ * Retrieve the desktop hooks serial, to be stored along with a new active
+ * hooks bitmap. It must be read before querying the bitmap from the server.
+ */
+UINT get_hooks_serial(void)
+{
+    const volatile struct desktop_shared_memory *shared = get_desktop_shared_memory();
+
+    return shared ? shared->hooks_serial : 0;
+}
+
+
 /***********************************************************************
  *           HOOK_IsHooked
  */
 static BOOL HOOK_IsHooked( INT id )
 {
     struct user_thread_info *thread_info = get_user_thread_info();
+    const volatile struct desktop_shared_memory *shared = get_desktop_shared_memory();
 
+    /* no hook of that kind is set on the desktop, whatever the cached bitmap says */
+    if (shared && !(shared->active_hooks & (1 << (id - WH_MINHOOK)))) return FALSE;
     if (!thread_info->active_hooks) return TRUE;
+    /* the cached bitmap is out of date if a hook has been set or removed since */
+    if (shared && shared->hooks_serial != thread_info->hooks_serial) return TRUE;
     return (thread_info->active_hooks & (1 << (id - WH_MINHOOK))) != 0;
 }
 
@@ -479,6 +498,7 @@ LRESULT HOOK_CallHooks( INT id, INT code, WPARAM wparam, LPARAM lparam, BOOL uni
     struct user_thread_info *thread_info = get_user_thread_info();
     struct hook_info info;
     DWORD_PTR ret;
+    UINT serial;
 
     USER_CheckNotLock();
 
@@ -492,6 +512,7 @@ LRESULT HOOK_CallHooks( INT id, INT code, WPARAM wparam, LPARAM lparam, BOOL uni
     info.prev_unicode = unicode;
     info.id = id;
 
+    serial = get_hooks_serial();
     SERVER_START_REQ( start_hook_chain )
     {
         req->id = info.id;
@@ -506,6 +527,7 @@ LRESULT HOOK_CallHooks( INT id, INT code, WPARAM wparam, LPARAM lparam, BOOL uni
             info.proc         = wine_server_get_ptr( reply->proc );
             info.next_unicode = reply->unicode;
             thread_info->active_hooks = reply->active_hooks;
+            thread_info->hooks_serial = serial;
         }
     }
     SERVER_END_REQ;
@@ -796,6 +818,7 @@ static inline BOOL find_first_hook(DWORD id, DWORD event, HWND hwnd, LONG object
                                    LONG child_id, struct hook_info *info)
 {
     struct user_thread_info *thread_info = get_user_thread_info();
+    UINT serial;
     BOOL ret;
 
     if (!HOOK_IsHooked( id ))
@@ -804,6 +827,7 @@ static inline BOOL find_first_hook(DWORD id, DWORD event, HWND hwnd, LONG object
         return FALSE;
     }
 
+    serial = get_hooks_serial();
     SERVER_START_REQ( start_hook_chain )
     {
         req->id = id;
@@ -820,6 +844,7 @@ static inline BOOL find_first_hook(DWORD id, DWORD event, HWND hwnd, LONG object
             info->proc      = wine_server_get_ptr( reply->proc );
             info->tid       = reply->tid;
             thread_info->active_hooks = reply->active_hooks;
+            thread_info->hooks_serial = serial;
         }
     }
     SERVER_END_REQ;
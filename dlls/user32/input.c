@@ -54,6 +54,93 @@ WINE_DECLARE_DEBUG_CHANNEL(keyboard);
 
 INT global_key_state_counter = 0;
 
+/***********************************************************************
+ *           get_input_shared_memory
+ *
+ * Return the read-only view of the key state of the thread input,
+ * or NULL if it is not available.
+ */
+static const volatile struct input_shared_memory *get_input_shared_memory(void)
+{
+    struct user_thread_info *thread_info = get_user_thread_info();
+    struct user_key_state_info *key_state_info = thread_info->key_state;
+    HANDLE mapping = 0;
+    UINT serial = 0;
+
+    /* the server only keeps an input state for threads with a message queue */
+    if (!thread_info->server_queue) return NULL;
+
+    if (key_state_info && key_state_info->input_shm)
+    {
+        if (key_state_info->input_shm->attach_serial == key_state_info->attach_serial)
+            return key_state_info->input_shm;
+        /* the thread has been detached from that input since */
+        unmap_input_shared_memory();
+    }
+    if (!key_state_info)
+    {
+        if (!(key_state_info = HeapAlloc( GetProcessHeap(), HEAP_ZERO_MEMORY, sizeof(*key_state_info) )))
+            return NULL;
+        thread_info->key_state = key_state_info;
+    }
+
+    SERVER_START_REQ( get_input_shared_memory )
+    {
+        if (!wine_server_call( req ))
+        {
+            mapping = wine_server_ptr_handle( reply->handle );
+            serial = reply->attach_serial;
+        }
+    }
+    SERVER_END_REQ;
+    if (!mapping) return NULL;
+
+    key_state_info->input_shm = MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+    key_state_info->attach_serial = serial;
+    CloseHandle( mapping );
+    return key_state_info->input_shm;
+}
+
+
+/***********************************************************************
+ *           unmap_input_shared_memory
+ */
+void unmap_input_shared_memory(void)
+{
+    struct user_key_state_info *key_state_info = get_user_thread_info()->key_state;
+
+    if (!key_state_info || !key_state_info->input_shm) return;
+    UnmapViewOfFile( (void *)key_state_info->input_shm );
+    key_state_info->input_shm = NULL;
+}
+
+
+/***********************************************************************
+ *           get_shared_cursor_pos
+ *
+ * Read the cursor position from the desktop shared memory.
+ */
+static BOOL get_shared_cursor_pos( POINT *pt, DWORD *last_change )
+{
+    const volatile struct desktop_shared_memory *shm = get_desktop_shared_memory();
+    int seq;
+
+    if (!shm) return FALSE;
+
+    /* retry if the server updated the cursor while we were reading it, the barriers */
+    /* pair with the ones around the sequence updates in the server update_shared_cursor */
+    do
+    {
+        while ((seq = shm->seq) & 1) ;
+        MemoryBarrier();
+        pt->x = shm->cursor_x;
+        pt->y = shm->cursor_y;
+        *last_change = shm->cursor_last_change;
+        MemoryBarrier();
+    } while (shm->seq != seq);
+    return TRUE;
+}
+
 /***********************************************************************
  *           get_key_state
  */
@@ -255,16 +342,19 @@ BOOL WINAPI DECLSPEC_HOTPATCH GetCursorPos( POINT *pt )
 
     if (!pt) return FALSE;
 
-    SERVER_START_REQ( set_cursor )
+    if (!(ret = get_shared_cursor_pos( pt, &last_change )))
     {
-        if ((ret = !wine_server_call( req )))
+        SERVER_START_REQ( set_cursor )
         {
-            pt->x = reply->new_x;
-            pt->y = reply->new_y;
-            last_change = reply->last_change;
+            if ((ret = !wine_server_call( req )))
+            {
+                pt->x = reply->new_x;
+                pt->y = reply->new_y;
+                last_change = reply->last_change;
+            }
         }
+        SERVER_END_REQ;
     }
-    SERVER_END_REQ;
 
     /* query new position from graphics driver if we haven't updated recently */
     if (ret && GetTickCount() - last_change > 100) ret = USER_Driver->pGetCursorPos( pt );
@@ -393,8 +483,9 @@ static void check_for_events( UINT flags )
 SHORT WINAPI DECLSPEC_HOTPATCH GetAsyncKeyState( INT key )
 {
     struct user_key_state_info *key_state_info = get_user_thread_info()->key_state;
+    const volatile struct desktop_shared_memory *desktop_shm;
     INT counter = global_key_state_counter;
-    BYTE prev_key_state;
+    BYTE prev_key_state, state;
     SHORT ret;
 
     if (key < 0 || key >= 256) return 0;
@@ -403,6 +494,10 @@ SHORT WINAPI DECLSPEC_HOTPATCH GetAsyncKeyState( INT key )
 
     if ((ret = USER_Driver->pGetAsyncKeyState( key )) == -1)
     {
+        /* the server has to clear the pressed bit, so only use the shared state without it */
+        if ((desktop_shm = get_desktop_shared_memory()) && !((state = desktop_shm->keystate[key]) & 0x40))
+            return (state & 0x80) ? 0x8000 : 0;
+
         if (key_state_info &&
             !(key_state_info->state[key] & 0xc0) &&
             key_state_info->counter == counter &&
@@ -553,15 +648,23 @@ BOOL WINAPI AttachThreadInput( DWORD from, DWORD to, BOOL attach )
  */
 SHORT WINAPI DECLSPEC_HOTPATCH GetKeyState(INT vkey)
 {
+    const volatile struct input_shared_memory *input_shm;
     SHORT retval = 0;
 
-    SERVER_START_REQ( get_key_state )
+    if ((input_shm = get_input_shared_memory()))
     {
-        req->tid = GetCurrentThreadId();
-        req->key = vkey;
-        if (!wine_server_call( req )) retval = (signed char)reply->state;
+        if (vkey >= 0) retval = (signed char)input_shm->keystate[vkey & 0xff];
+    }
+    else
+    {
+        SERVER_START_REQ( get_key_state )
+        {
+            req->tid = GetCurrentThreadId();
+            req->key = vkey;
+            if (!wine_server_call( req )) retval = (signed char)reply->state;
+        }
+        SERVER_END_REQ;
     }
-    SERVER_END_REQ;
     TRACE("key (0x%x) -> %x\n", vkey, retval);
     return retval;
 }
@@ -1609,6 +1609,103 @@ static void test_GetRawInputData(void)
     ok(ret == ~0U, "Expect ret %u, got %u\n", ~0U, ret);
 }
 
+static void test_GetRawInputBuffer(void)
+{
+    RAWINPUT buffer[4], *rawinput;
+    RAWINPUTDEVICE device;
+    INPUT input[2];
+    UINT size, ret, i;
+    HWND hwnd;
+
+    size = 0xdeadbeef;
+    ret = GetRawInputBuffer(NULL, &size, 0);
+    ok(ret == ~0U, "Expect ret %u, got %u\n", ~0U, ret);
+
+    /* Empty queue */
+    size = 0xdeadbeef;
+    ret = GetRawInputBuffer(NULL, &size, sizeof(RAWINPUTHEADER));
+    ok(ret == 0, "Expect ret 0, got %u\n", ret);
+    ok(size == 0, "Expect size 0, got %u\n", size);
+
+    size = sizeof(buffer);
+    ret = GetRawInputBuffer(buffer, &size, sizeof(RAWINPUTHEADER));
+    ok(ret == 0, "Expect ret 0, got %u\n", ret);
+
+    hwnd = CreateWindowA("static", "rawinput", WS_POPUP, 0, 0, 10, 10, NULL, NULL, NULL, NULL);
+    ok(hwnd != NULL, "CreateWindow failed, error %u\n", GetLastError());
+
+    device.usUsagePage = 0x01;
+    device.usUsage = 0x02;
+    device.dwFlags = RIDEV_INPUTSINK;
+    device.hwndTarget = hwnd;
+    ret = RegisterRawInputDevices(&device, 1, sizeof(device));
+    ok(ret, "RegisterRawInputDevices failed, error %u\n", GetLastError());
+
+    memset(input, 0, sizeof(input));
+    input[0].type = INPUT_MOUSE;
+    input[0].mi.dwFlags = MOUSEEVENTF_LEFTDOWN;
+    input[1].type = INPUT_MOUSE;
+    input[1].mi.dwFlags = MOUSEEVENTF_LEFTUP;
+    ret = SendInput(2, input, sizeof(INPUT));
+    ok(ret == 2, "SendInput returned %u\n", ret);
+
+    /* Size of the next message */
+    size = 0xdeadbeef;
+    ret = GetRawInputBuffer(NULL, &size, sizeof(RAWINPUTHEADER));
+    ok(ret == 0, "Expect ret 0, got %u\n", ret);
+    ok(size == sizeof(RAWINPUT), "Expect size %u, got %u\n", (UINT)sizeof(RAWINPUT), size);
+
+    /* Buffer too small for a single message */
+    size = sizeof(RAWINPUTHEADER);
+    SetLastError(0xdeadbeef);
+    ret = GetRawInputBuffer(buffer, &size, sizeof(RAWINPUTHEADER));
+    ok(ret == ~0U, "Expect ret %u, got %u\n", ~0U, ret);
+    ok(GetLastError() == ERROR_INSUFFICIENT_BUFFER, "Got unexpected error %u\n", GetLastError());
+    ok(size == sizeof(RAWINPUT), "Expect size %u, got %u\n", (UINT)sizeof(RAWINPUT), size);
+
+    /* Only the first message fits */
+    size = sizeof(RAWINPUT);
+    memset(buffer, 0xcc, sizeof(buffer));
+    ret = GetRawInputBuffer(buffer, &size, sizeof(RAWINPUTHEADER));
+    ok(ret == 1, "Expect ret 1, got %u\n", ret);
+    ok(buffer[0].header.dwType == RIM_TYPEMOUSE, "Got unexpected type %u\n", buffer[0].header.dwType);
+    ok(buffer[0].header.dwSize == sizeof(RAWINPUT), "Got unexpected size %u\n", buffer[0].header.dwSize);
+    ok(buffer[0].data.mouse.usButtonFlags == RI_MOUSE_LEFT_BUTTON_DOWN,
+            "Got unexpected button flags %#x\n", buffer[0].data.mouse.usButtonFlags);
+    ok(buffer[0].data.mouse.lLastX == 0 && buffer[0].data.mouse.lLastY == 0,
+            "Got unexpected motion %d,%d\n", buffer[0].data.mouse.lLastX, buffer[0].data.mouse.lLastY);
+
+    ret = SendInput(2, input, sizeof(INPUT));
+    ok(ret == 2, "SendInput returned %u\n", ret);
+
+    /* The remaining message and the new ones are returned together */
+    size = sizeof(buffer);
+    memset(buffer, 0xcc, sizeof(buffer));
+    ret = GetRawInputBuffer(buffer, &size, sizeof(RAWINPUTHEADER));
+    ok(ret == 3, "Expect ret 3, got %u\n", ret);
+    rawinput = buffer;
+    for (i = 0; i < ret && i < 3; ++i)
+    {
+        ok(rawinput->header.dwType == RIM_TYPEMOUSE, "%u: got unexpected type %u\n", i, rawinput->header.dwType);
+        ok(rawinput->data.mouse.usButtonFlags == (i == 1 ? RI_MOUSE_LEFT_BUTTON_DOWN : RI_MOUSE_LEFT_BUTTON_UP),
+                "%u: got unexpected button flags %#x\n", i, rawinput->data.mouse.usButtonFlags);
+        rawinput = NEXTRAWINPUTBLOCK(rawinput);
+    }
+
+    size = 0xdeadbeef;
+    ret = GetRawInputBuffer(NULL, &size, sizeof(RAWINPUTHEADER));
+    ok(ret == 0, "Expect ret 0, got %u\n", ret);
+    ok(size == 0, "Expect size 0, got %u\n", size);
+
+    device.dwFlags = RIDEV_REMOVE;
+    device.hwndTarget = NULL;
+    ret = RegisterRawInputDevices(&device, 1, sizeof(device));
+    ok(ret, "RegisterRawInputDevices failed, error %u\n", GetLastError());
+
+    empty_message_queue();
+    DestroyWindow(hwnd);
+}
+
 static void test_key_map(void)
 {
     HKL kl = GetKeyboardLayout(0);
@@ -2585,6 +2682,64 @@ static void test_GetKeyState(void)
     CloseHandle(semaphores[1]);
 }
 
+static DWORD WINAPI cursor_pos_thread(void *arg)
+{
+    HANDLE *semaphores = arg;
+    DWORD result;
+    POINT pt;
+
+    ReleaseSemaphore(semaphores[0], 1, NULL);
+    result = WaitForSingleObject(semaphores[1], 1000);
+    ok(result == WAIT_OBJECT_0, "WaitForSingleObject returned %u\n", result);
+
+    GetCursorPos(&pt);
+    ok(pt.x == 50 && pt.y == 60, "GetCursorPos: (%d,%d)\n", pt.x, pt.y);
+
+    SetCursorPos(70, 80);
+    ReleaseSemaphore(semaphores[0], 1, NULL);
+    return 0;
+}
+
+static void test_GetCursorPos_thread(void)
+{
+    HANDLE semaphores[2];
+    POINT pt, pt_org;
+    HANDLE thread;
+    DWORD result;
+
+    GetCursorPos(&pt_org);
+
+    semaphores[0] = CreateSemaphoreA(NULL, 0, 1, NULL);
+    ok(semaphores[0] != NULL, "CreateSemaphoreA failed %u\n", GetLastError());
+    semaphores[1] = CreateSemaphoreA(NULL, 0, 1, NULL);
+    ok(semaphores[1] != NULL, "CreateSemaphoreA failed %u\n", GetLastError());
+
+    thread = CreateThread(NULL, 0, cursor_pos_thread, semaphores, 0, NULL);
+    ok(thread != NULL, "CreateThread failed %u\n", GetLastError());
+    result = WaitForSingleObject(semaphores[0], 1000);
+    ok(result == WAIT_OBJECT_0, "WaitForSingleObject returned %u\n", result);
+
+    /* make sure this thread caches the position before the other thread moves it */
+    SetCursorPos(50, 60);
+    GetCursorPos(&pt);
+    ok(pt.x == 50 && pt.y == 60, "GetCursorPos: (%d,%d)\n", pt.x, pt.y);
+
+    ReleaseSemaphore(semaphores[1], 1, NULL);
+    result = WaitForSingleObject(semaphores[0], 1000);
+    ok(result == WAIT_OBJECT_0, "WaitForSingleObject returned %u\n", result);
+
+    GetCursorPos(&pt);
+    ok(pt.x == 70 && pt.y == 80, "GetCursorPos: (%d,%d)\n", pt.x, pt.y);
+
+    result = WaitForSingleObject(thread, 1000);
+    ok(result == WAIT_OBJECT_0, "WaitForSingleObject returned %u\n", result);
+    CloseHandle(thread);
+    CloseHandle(semaphores[0]);
+    CloseHandle(semaphores[1]);
+
+    SetCursorPos(pt_org.x, pt_org.y);
+}
+
 static void test_OemKeyScan(void)
 {
     DWORD ret, expect, vkey, scan;
@@ -2642,8 +2797,10 @@ START_TEST(input)
     test_key_names();
     test_attach_input();
     test_GetKeyState();
+    test_GetCursorPos_thread();
     test_OemKeyScan();
     test_GetRawInputData();
+    test_GetRawInputBuffer();
 
     if(pGetMouseMovePointsEx)
         test_GetMouseMovePointsEx();
@@ -10509,6 +10509,79 @@ static void test_recursive_hook(void)
     DestroyWindow(hook_hwnd);
 }
 
+static LONG callwndproc_hook_calls;
+
+static LRESULT CALLBACK count_callwndproc_hook(int code, WPARAM wp, LPARAM lp)
+{
+    CWPSTRUCT *cwp = (CWPSTRUCT *)lp;
+
+    if (code == HC_ACTION && cwp->message == WM_USER + 1) InterlockedIncrement(&callwndproc_hook_calls);
+    return CallNextHookEx(0, code, wp, lp);
+}
+
+struct hook_thread_params
+{
+    DWORD tid;
+    HANDLE hooked;
+    HANDLE unhook;
+};
+
+static DWORD WINAPI set_hook_thread_proc(void *param)
+{
+    struct hook_thread_params *params = param;
+    HHOOK hook;
+    BOOL ret;
+
+    hook = SetWindowsHookExA(WH_CALLWNDPROC, count_callwndproc_hook, NULL, params->tid);
+    ok(hook != NULL, "SetWindowsHookEx failed, error %u\n", GetLastError());
+    SetEvent(params->hooked);
+    WaitForSingleObject(params->unhook, INFINITE);
+    ret = UnhookWindowsHookEx(hook);
+    ok(ret, "UnhookWindowsHookEx failed, error %u\n", GetLastError());
+    return 0;
+}
+
+static void test_hook_from_other_thread(void)
+{
+    struct hook_thread_params params;
+    HANDLE thread;
+    HWND hwnd;
+    DWORD ret;
+
+    hwnd = CreateWindowA("static", NULL, WS_POPUP, 0, 0, 100, 100, NULL, NULL, NULL, NULL);
+    ok(hwnd != NULL, "CreateWindow failed\n");
+
+    /* make sure the thread already knows there is no WH_CALLWNDPROC hook */
+    callwndproc_hook_calls = 0;
+    SendMessageA(hwnd, WM_USER + 1, 0, 0);
+    ok(!callwndproc_hook_calls, "got %d hook calls\n", callwndproc_hook_calls);
+
+    params.tid = GetCurrentThreadId();
+    params.hooked = CreateEventA(NULL, FALSE, FALSE, NULL);
+    params.unhook = CreateEventA(NULL, FALSE, FALSE, NULL);
+    thread = CreateThread(NULL, 0, set_hook_thread_proc, &params, 0, NULL);
+    ok(thread != NULL, "CreateThread failed, error %u\n", GetLastError());
+    ret = WaitForSingleObject(params.hooked, 5000);
+    ok(ret == WAIT_OBJECT_0, "WaitForSingleObject returned %u\n", ret);
+
+    /* a hook set by another thread must be called right away */
+    SendMessageA(hwnd, WM_USER + 1, 0, 0);
+    ok(callwndproc_hook_calls == 1, "got %d hook calls\n", callwndproc_hook_calls);
+
+    SetEvent(params.unhook);
+    ret = WaitForSingleObject(thread, 5000);
+    ok(ret == WAIT_OBJECT_0, "WaitForSingleObject returned %u\n", ret);
+
+    /* and no longer once it has been removed */
+    SendMessageA(hwnd, WM_USER + 1, 0, 0);
+    ok(callwndproc_hook_calls == 1, "got %d hook calls\n", callwndproc_hook_calls);
+
+    CloseHandle(thread);
+    CloseHandle(params.hooked);
+    CloseHandle(params.unhook);
+    DestroyWindow(hwnd);
+}
+
 static const struct message ScrollWindowPaint1[] = {
     { WM_PAINT, sent },
     { WM_ERASEBKGND, sent|beginpaint },
@@ -17084,6 +17157,7 @@ START_TEST(msg)
     {
         test_set_hook();
         test_recursive_hook();
+        test_hook_from_other_thread();
     }
     test_DestroyWindow();
     test_DispatchMessage();
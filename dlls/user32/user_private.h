@@ -165,18 +165,22 @@ struct wm_char_mapping_data
     MSG  get_msg;
 };
 
+struct desktop_shared_memory;
+struct input_shared_memory;
+
 /* this is the structure stored in TEB->Win32ClientInfo */
 /* no attempt is made to keep the layout compatible with the Windows one */
 struct user_thread_info
 {
-    DPI_AWARENESS                 dpi_awareness;          /* DPI awareness */
     HANDLE                        server_queue;           /* Handle to server-side queue */
     DWORD                         wake_mask;              /* Current queue wake mask */
     DWORD                         changed_mask;           /* Current queue changed mask */
     WORD                          recursion_count;        /* SendMessage recursion counter */
     WORD                          message_count;          /* Get/PeekMessage loop counter */
     WORD                          hook_call_depth;        /* Number of recursively called hook procs */
+    WORD                          desktop_shm_failed;     /* Mapping the desktop shared memory failed */
     BOOL                          hook_unicode;           /* Is current hook unicode? */
+    DPI_AWARENESS                 dpi_awareness;          /* DPI awareness */
     HHOOK                         hook;                   /* Current hook */
     struct received_message_info *receive_info;           /* Message being currently received */
     struct wm_char_mapping_data  *wmchar_data;            /* Data for WM_CHAR mappings */
@@ -184,10 +188,12 @@ struct user_thread_info
     DWORD                         GetMessagePosVal;       /* Value for GetMessagePos */
     ULONG_PTR                     GetMessageExtraInfoVal; /* Value for GetMessageExtraInfo */
     UINT                          active_hooks;           /* Bitmap of active hooks */
+    UINT                          hooks_serial;           /* Desktop hooks serial when active_hooks was set */
     struct user_key_state_info   *key_state;              /* Cache of global key state */
     HWND                          top_window;             /* Desktop window */
     HWND                          msg_window;             /* HWND_MESSAGE parent window */
     RAWINPUT                     *rawinput;
+    const volatile struct desktop_shared_memory *desktop_shm; /* Shared memory of the thread desktop */
 };
 
 C_ASSERT( sizeof(struct user_thread_info) <= sizeof(((TEB *)0)->Win32ClientInfo) );
@@ -202,6 +208,8 @@ struct user_key_state_info
     UINT                          time;                   /* Time of last key state refresh */
     INT                           counter;                /* Counter to invalidate the key state */
     BYTE                          state[256];             /* State for each key */
+    const volatile struct input_shared_memory *input_shm; /* Shared memory of the thread input */
+    UINT                          attach_serial;          /* Input attach serial when input_shm was mapped */
 };
 
 struct hook_extra_info
@@ -246,6 +254,12 @@ extern LRESULT call_current_hook( HHOOK hhook, INT code, WPARAM wparam, LPARAM l
 extern DWORD get_input_codepage( void ) DECLSPEC_HIDDEN;
 extern BOOL map_wparam_AtoW( UINT message, WPARAM *wparam, enum wm_char_mapping mapping ) DECLSPEC_HIDDEN;
 extern NTSTATUS send_hardware_message( HWND hwnd, const INPUT *input, UINT flags ) DECLSPEC_HIDDEN;
+extern const volatile struct desktop_shared_memory *get_desktop_shared_memory(void) DECLSPEC_HIDDEN;
+extern void unmap_desktop_shared_memory(void) DECLSPEC_HIDDEN;
+extern void unmap_input_shared_memory(void) DECLSPEC_HIDDEN;
+extern UINT get_hooks_serial(void) DECLSPEC_HIDDEN;
+struct hardware_msg_data;
+extern BOOL rawinput_from_hardware_message( RAWINPUT *rawinput, const struct hardware_msg_data *msg_data ) DECLSPEC_HIDDEN;
 extern LRESULT MSG_SendInternalMessageTimeout( DWORD dest_pid, DWORD dest_tid,
                                                UINT msg, WPARAM wparam, LPARAM lparam,
                                                UINT flags, UINT timeout, PDWORD_PTR res_ptr ) DECLSPEC_HIDDEN;
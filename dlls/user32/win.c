@@ -581,7 +581,8 @@ static const struct window_surface_funcs dummy_surface_funcs =
     dummy_surface_get_bounds,
     dummy_surface_set_region,
     dummy_surface_flush,
-    dummy_surface_destroy
+    dummy_surface_destroy,
+    NULL  /* add_damage */
 };
 
 struct window_surface dummy_surface = { &dummy_surface_funcs, { NULL, NULL }, 1, { 0, 0, 1, 1 } };
@@ -428,12 +428,60 @@ BOOL WINAPI SetThreadDesktop( HDESK handle )
         struct user_key_state_info *key_state_info = thread_info->key_state;
         thread_info->top_window = 0;
         thread_info->msg_window = 0;
+        thread_info->active_hooks = 0;
         if (key_state_info) key_state_info->time = 0;
+        unmap_desktop_shared_memory();
+        unmap_input_shared_memory();
     }
     return ret;
 }
 
 
+/***********************************************************************
+ *              get_desktop_shared_memory
+ *
+ * Return the read-only view of the state shared by the thread desktop,
+ * or NULL if it is not available.
+ */
+const volatile struct desktop_shared_memory *get_desktop_shared_memory(void)
+{
+    struct user_thread_info *thread_info = get_user_thread_info();
+    HANDLE mapping = 0;
+
+    if (thread_info->desktop_shm) return thread_info->desktop_shm;
+    /* don't ask the server again on every call, the desktop won't change until SetThreadDesktop */
+    if (thread_info->desktop_shm_failed) return NULL;
+
+    SERVER_START_REQ( get_desktop_shared_memory )
+    {
+        if (!wine_server_call( req )) mapping = wine_server_ptr_handle( reply->handle );
+    }
+    SERVER_END_REQ;
+
+    if (mapping)
+    {
+        thread_info->desktop_shm = MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+        CloseHandle( mapping );
+    }
+    if (!thread_info->desktop_shm) thread_info->desktop_shm_failed = TRUE;
+    return thread_info->desktop_shm;
+}
+
+
+/***********************************************************************
+ *              unmap_desktop_shared_memory
+ */
+void unmap_desktop_shared_memory(void)
+{
+    struct user_thread_info *thread_info = get_user_thread_info();
+
+    thread_info->desktop_shm_failed = FALSE;
+    if (!thread_info->desktop_shm) return;
+    UnmapViewOfFile( (void *)thread_info->desktop_shm );
+    thread_info->desktop_shm = NULL;
+}
+
+
 /******************************************************************************
  *              EnumDesktopsA   (USER32.@)
  */
@@ -829,7 +829,8 @@ static const struct window_surface_funcs android_surface_funcs =
     android_surface_get_bounds,
     android_surface_set_region,
     android_surface_flush,
-    android_surface_destroy
+    android_surface_destroy,
+    NULL  /* add_damage */
 };
 
 static BOOL is_argb_surface( struct window_surface *surface )
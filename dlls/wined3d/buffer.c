@@ -34,6 +34,7 @@ WINE_DEFAULT_DEBUG_CHANNEL(d3d);
 #define WINED3D_BUFFER_PIN_SYSMEM   0x04    /* Keep a system memory copy for this buffer. */
 #define WINED3D_BUFFER_DISCARD      0x08    /* A DISCARD lock has occurred since the last preload. */
 #define WINED3D_BUFFER_APPLESYNC    0x10    /* Using sync as in GL_APPLE_flush_buffer_range. */
+#define WINED3D_BUFFER_UPLOADING   0x20    /* The GPU may still be copying from the upload ring. */
 
 #define VB_MAXDECLCHANGES     100     /* After that number of decl changes we stop converting */
 #define VB_RESETDECLCHANGE    1000    /* Reset the decl changecount after that number of draws */
@@ -996,6 +997,265 @@ struct wined3d_resource * CDECL wined3d_buffer_get_resource(struct wined3d_buffe
     return &buffer->resource;
 }
 
+/* Context activation is done by the caller. */
+void wined3d_upload_ring_init(struct wined3d_upload_ring *ring, struct wined3d_context *context)
+{
+    const GLbitfield map_flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    const struct wined3d_gl_info *gl_info = context->gl_info;
+
+    memset(ring, 0, sizeof(*ring));
+
+    if (!gl_info->supported[ARB_BUFFER_STORAGE] || !gl_info->supported[ARB_COPY_BUFFER]
+            || !gl_info->supported[ARB_MAP_BUFFER_RANGE] || !gl_info->supported[ARB_SYNC])
+    {
+        TRACE("Persistent buffer mapping not supported, not creating an upload ring.\n");
+        return;
+    }
+
+    ring->size = WINED3D_UPLOAD_RING_SIZE;
+
+    GL_EXTCALL(glGenBuffers(1, &ring->buffer_object));
+    GL_EXTCALL(glBindBuffer(GL_COPY_READ_BUFFER, ring->buffer_object));
+    GL_EXTCALL(glBufferStorage(GL_COPY_READ_BUFFER, ring->size, NULL, map_flags));
+    ring->map_ptr = GL_EXTCALL(glMapBufferRange(GL_COPY_READ_BUFFER, 0, ring->size, map_flags));
+    GL_EXTCALL(glBindBuffer(GL_COPY_READ_BUFFER, 0));
+    checkGLcall("create upload ring");
+
+    if (!ring->map_ptr || ((DWORD_PTR)ring->map_ptr & (RESOURCE_ALIGNMENT - 1)))
+    {
+        WARN("Failed to map upload ring, pointer %p.\n", ring->map_ptr);
+        wined3d_upload_ring_cleanup(ring, context);
+        return;
+    }
+
+    TRACE("Created %u byte upload ring, buffer object %u, pointer %p.\n",
+            ring->size, ring->buffer_object, ring->map_ptr);
+}
+
+/* Context activation is done by the caller. */
+void wined3d_upload_ring_cleanup(struct wined3d_upload_ring *ring, struct wined3d_context *context)
+{
+    const struct wined3d_gl_info *gl_info = context->gl_info;
+    unsigned int i;
+
+    if (!ring->buffer_object)
+        return;
+
+    TRACE("Upload ring %p: %u allocations, %u times full.\n", ring, ring->allocations, ring->full);
+
+    for (i = 0; i < ring->fence_count; ++i)
+    {
+        GL_EXTCALL(glDeleteSync(ring->fences[(ring->fence_start + i) % ARRAY_SIZE(ring->fences)].sync));
+    }
+    ring->fence_count = 0;
+
+    if (ring->map_ptr)
+    {
+        GL_EXTCALL(glBindBuffer(GL_COPY_READ_BUFFER, ring->buffer_object));
+        GL_EXTCALL(glUnmapBuffer(GL_COPY_READ_BUFFER));
+        GL_EXTCALL(glBindBuffer(GL_COPY_READ_BUFFER, 0));
+        ring->map_ptr = NULL;
+    }
+    GL_EXTCALL(glDeleteBuffers(1, &ring->buffer_object));
+    checkGLcall("destroy upload ring");
+    ring->buffer_object = 0;
+}
+
+/* Context activation is done by the caller. */
+static void wined3d_upload_ring_fence(struct wined3d_upload_ring *ring, const struct wined3d_gl_info *gl_info)
+{
+    unsigned int idx;
+
+    if (ring->fenced == ring->submitted)
+        return;
+
+    if (ring->fence_count == ARRAY_SIZE(ring->fences))
+    {
+        idx = ring->fence_start;
+        GL_EXTCALL(glClientWaitSync(ring->fences[idx].sync, GL_SYNC_FLUSH_COMMANDS_BIT, ~(GLuint64)0));
+        GL_EXTCALL(glDeleteSync(ring->fences[idx].sync));
+        InterlockedExchange(&ring->tail, ring->fences[idx].position);
+        ring->fence_start = (ring->fence_start + 1) % ARRAY_SIZE(ring->fences);
+        --ring->fence_count;
+    }
+
+    idx = (ring->fence_start + ring->fence_count) % ARRAY_SIZE(ring->fences);
+    ring->fences[idx].sync = GL_EXTCALL(glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+    ring->fences[idx].position = ring->submitted;
+    ++ring->fence_count;
+    ring->fenced = ring->submitted;
+    checkGLcall("upload ring fence");
+}
+
+/* Context activation is done by the caller. Retires fences that have
+ * signalled, moving the tail forward, and optionally waits until "position"
+ * is no longer in use by the GPU. */
+static void wined3d_upload_ring_update(struct wined3d_upload_ring *ring,
+        const struct wined3d_gl_info *gl_info, BOOL wait, unsigned int position)
+{
+    GLuint64 timeout;
+    GLenum ret;
+
+    if (wait && (int)(position - ring->fenced) > 0)
+        wined3d_upload_ring_fence(ring, gl_info);
+
+    while (ring->fence_count)
+    {
+        unsigned int idx = ring->fence_start;
+
+        if (wait && (int)(position - (unsigned int)ring->tail) > 0)
+            timeout = ~(GLuint64)0;
+        else
+            timeout = 0;
+
+        ret = GL_EXTCALL(glClientWaitSync(ring->fences[idx].sync, timeout ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, timeout));
+        checkGLcall("glClientWaitSync");
+        if (ret == GL_TIMEOUT_EXPIRED)
+            break;
+        if (ret == GL_WAIT_FAILED)
+            ERR("glClientWaitSync failed.\n");
+
+        GL_EXTCALL(glDeleteSync(ring->fences[idx].sync));
+        InterlockedExchange(&ring->tail, ring->fences[idx].position);
+        ring->fence_start = (ring->fence_start + 1) % ARRAY_SIZE(ring->fences);
+        --ring->fence_count;
+    }
+}
+
+void wined3d_upload_ring_retire(struct wined3d_device *device)
+{
+    struct wined3d_upload_ring *ring = &device->upload_ring;
+    struct wined3d_context *context;
+
+    if (ring->submitted == (unsigned int)ring->tail)
+        return;
+
+    /* Make sure everything submitted so far becomes reclaimable, even if the
+     * application stops using DISCARD maps. */
+    context = context_acquire(device, NULL, 0);
+    wined3d_upload_ring_fence(ring, context->gl_info);
+    wined3d_upload_ring_update(ring, context->gl_info, FALSE, 0);
+    context_release(context);
+}
+
+/* Called from the application thread. */
+BOOL wined3d_buffer_map_upload(struct wined3d_buffer *buffer, struct wined3d_map_desc *map_desc,
+        const struct wined3d_box *box, DWORD flags)
+{
+    struct wined3d_upload_ring *ring = &buffer->resource.device->upload_ring;
+    unsigned int size, offset, position;
+
+    if (!buffer->upload_map_count)
+    {
+        if ((flags & (WINED3D_MAP_DISCARD | WINED3D_MAP_READ)) != WINED3D_MAP_DISCARD
+                || !ring->map_ptr || buffer->resource.map_count)
+            return FALSE;
+
+        /* DISCARD always replaces the entire buffer, see wined3d_buffer_map(). */
+        size = (buffer->resource.size + RESOURCE_ALIGNMENT - 1) & ~(RESOURCE_ALIGNMENT - 1);
+        if (size > ring->size / 4)
+            return FALSE;
+
+        position = ring->head;
+        offset = position & (ring->size - 1);
+        if (offset + size > ring->size)
+        {
+            position += ring->size - offset;
+            offset = 0;
+        }
+        if (position + size - (unsigned int)InterlockedCompareExchange(&ring->tail, 0, 0) > ring->size)
+        {
+            TRACE("Upload ring is full.\n");
+            ++ring->full;
+            return FALSE;
+        }
+
+        ring->head = position + size;
+        ++ring->allocations;
+        buffer->upload_offset = offset;
+        buffer->upload_end = ring->head;
+    }
+
+    ++buffer->upload_map_count;
+
+    TRACE("Mapped buffer %p at upload ring offset %#x.\n", buffer, buffer->upload_offset);
+
+    map_desc->row_pitch = map_desc->slice_pitch = buffer->resource.size;
+    map_desc->data = ring->map_ptr + buffer->upload_offset + (box ? box->left : 0);
+    return TRUE;
+}
+
+/* Called from the application thread. */
+BOOL wined3d_buffer_unmap_upload(struct wined3d_buffer *buffer)
+{
+    struct wined3d_device *device = buffer->resource.device;
+
+    if (!buffer->upload_map_count)
+        return FALSE;
+
+    if (!--buffer->upload_map_count)
+        wined3d_cs_emit_upload_buffer(device->cs, buffer, buffer->upload_offset, buffer->upload_end);
+    return TRUE;
+}
+
+/* Context activation is done by the caller. */
+void wined3d_buffer_upload_from_ring(struct wined3d_buffer *buffer, struct wined3d_context *context,
+        unsigned int ring_offset, unsigned int ring_end)
+{
+    struct wined3d_upload_ring *ring = &buffer->resource.device->upload_ring;
+    const struct wined3d_gl_info *gl_info = context->gl_info;
+    struct wined3d_bo_address dst, src;
+    DWORD dst_location;
+
+    TRACE("buffer %p, context %p, ring_offset %#x, ring_end %#x.\n", buffer, context, ring_offset, ring_end);
+
+    buffer_mark_used(buffer);
+
+    if ((buffer->flags & WINED3D_BUFFER_USE_BO) && !(buffer->flags & WINED3D_BUFFER_PIN_SYSMEM))
+        dst_location = WINED3D_LOCATION_BUFFER;
+    else
+        dst_location = WINED3D_LOCATION_SYSMEM;
+    if (!wined3d_buffer_prepare_location(buffer, context, dst_location))
+    {
+        dst_location = WINED3D_LOCATION_SYSMEM;
+        if (!wined3d_buffer_prepare_location(buffer, context, dst_location))
+        {
+            ERR("Failed to prepare buffer %p for upload.\n", buffer);
+            return;
+        }
+    }
+    wined3d_buffer_get_memory(buffer, &dst, dst_location);
+
+    /* The ring is coherently mapped, so system memory copies can read it
+     * directly. */
+    if (dst.buffer_object)
+    {
+        src.buffer_object = ring->buffer_object;
+        src.addr = (BYTE *)(ULONG_PTR)ring_offset;
+    }
+    else
+    {
+        src.buffer_object = 0;
+        src.addr = ring->map_ptr + ring_offset;
+    }
+    context_copy_bo_address(context, &dst, buffer->buffer_type_hint,
+            &src, GL_COPY_READ_BUFFER, buffer->resource.size);
+
+    wined3d_buffer_validate_location(buffer, dst_location);
+    wined3d_buffer_invalidate_location(buffer, ~dst_location);
+
+    if (dst.buffer_object)
+    {
+        buffer->flags |= WINED3D_BUFFER_UPLOADING;
+        buffer->upload_position = ring_end;
+    }
+
+    ring->submitted = ring_end;
+    if (ring->submitted - ring->fenced >= ring->size / 8)
+        wined3d_upload_ring_fence(ring, gl_info);
+    wined3d_upload_ring_update(ring, gl_info, FALSE, 0);
+}
+
 static HRESULT wined3d_buffer_map(struct wined3d_buffer *buffer, UINT offset, UINT size, BYTE **data, DWORD flags)
 {
     struct wined3d_device *device = buffer->resource.device;
@@ -1042,6 +1302,15 @@ static HRESULT wined3d_buffer_map(struct wined3d_buffer *buffer, UINT offset, UI
             context = context_acquire(device, NULL, 0);
             gl_info = context->gl_info;
 
+            /* Unsynchronised maps must not race with a copy from the upload
+             * ring that the GPU hasn't executed yet. */
+            if (buffer->flags & WINED3D_BUFFER_UPLOADING)
+            {
+                if (flags & WINED3D_MAP_NOOVERWRITE)
+                    wined3d_upload_ring_update(&device->upload_ring, gl_info, TRUE, buffer->upload_position);
+                buffer->flags &= ~WINED3D_BUFFER_UPLOADING;
+            }
+
             if (flags & WINED3D_MAP_DISCARD)
                 wined3d_buffer_validate_location(buffer, WINED3D_LOCATION_BUFFER);
             else
@@ -1634,15 +1634,11 @@ void context_invalidate_compute_state(struct wined3d_context *context, DWORD sta
 void context_invalidate_state(struct wined3d_context *context, DWORD state)
 {
     DWORD rep = context->state_table[state].representative;
-    DWORD idx;
-    BYTE shift;
-
-    if (isStateDirty(context, rep)) return;
+    unsigned int index, shift;
 
-    context->dirtyArray[context->numDirtyEntries++] = rep;
-    idx = rep / (sizeof(*context->isStateDirty) * CHAR_BIT);
-    shift = rep & ((sizeof(*context->isStateDirty) * CHAR_BIT) - 1);
-    context->isStateDirty[idx] |= (1u << shift);
+    index = rep / (sizeof(*context->dirty_graphics_states) * CHAR_BIT);
+    shift = rep & (sizeof(*context->dirty_graphics_states) * CHAR_BIT - 1);
+    context->dirty_graphics_states[index] |= (1u << shift);
 }
 
 /* This function takes care of wined3d pixel format selection. */
@@ -3935,7 +3931,7 @@ static BOOL context_apply_draw_state(struct wined3d_context *context,
     const struct StateEntry *state_table = context->state_table;
     const struct wined3d_gl_info *gl_info = context->gl_info;
     const struct wined3d_fb_state *fb = state->fb;
-    unsigned int i;
+    unsigned int i, state_id;
     WORD map;
 
     if (!have_framebuffer_attachment(gl_info->limits.buffers, fb->render_targets, fb->depth_stencil))
@@ -3992,16 +3988,34 @@ static BOOL context_apply_draw_state(struct wined3d_context *context,
             wined3d_buffer_load_sysmem(state->index_buffer, context);
     }
 
-    for (i = 0; i < context->numDirtyEntries; ++i)
+    /* State handlers may invalidate other states, including ones we already
+     * passed, so keep scanning until the bitmap is clean. */
+    for (;;)
     {
-        DWORD rep = context->dirtyArray[i];
-        DWORD idx = rep / (sizeof(*context->isStateDirty) * CHAR_BIT);
-        BYTE shift = rep & ((sizeof(*context->isStateDirty) * CHAR_BIT) - 1);
-        context->isStateDirty[idx] &= ~(1u << shift);
-        state_table[rep].apply(context, state, rep);
+        for (i = 0, state_id = 0; i < ARRAY_SIZE(context->dirty_graphics_states); ++i)
+        {
+            unsigned int dirty_mask;
+
+            while ((dirty_mask = context->dirty_graphics_states[i]))
+            {
+                unsigned int current_state_id = state_id + wined3d_bit_scan(&dirty_mask);
+
+                context->dirty_graphics_states[i] &= ~(1u << (current_state_id - state_id));
+                state_table[current_state_id].apply(context, state, current_state_id);
+            }
+            state_id += sizeof(*context->dirty_graphics_states) * CHAR_BIT;
+        }
+
+        for (i = 0; i < ARRAY_SIZE(context->dirty_graphics_states); ++i)
+        {
+            if (context->dirty_graphics_states[i])
+                break;
+        }
+        if (i == ARRAY_SIZE(context->dirty_graphics_states))
+            break;
     }
 
-    if (context->shader_update_mask & ~(1u << WINED3D_SHADER_TYPE_COMPUTE))
+    if ((context->shader_update_mask & ~(1u << WINED3D_SHADER_TYPE_COMPUTE)) || context->shader_link_pending)
     {
         device->shader_backend->shader_select(device->shader_priv, context, state);
         context->shader_update_mask &= 1u << WINED3D_SHADER_TYPE_COMPUTE;
@@ -4036,7 +4050,6 @@ static BOOL context_apply_draw_state(struct wined3d_context *context,
         context_check_fbo_status(context, GL_FRAMEBUFFER);
     }
 
-    context->numDirtyEntries = 0; /* This makes the whole list clean */
     context->last_was_blit = FALSE;
     context->last_was_ffp_blit = FALSE;
 
@@ -4498,6 +4511,29 @@ static void draw_primitive_arrays(struct wined3d_context *context, const struct
     }
 }
 
+/* Context activation is done by the caller. */
+static void draw_primitive_batch(struct wined3d_context *context, const struct wined3d_state *state,
+        const void *idx_data, unsigned int idx_size, const struct wined3d_draw_batch *batch)
+{
+    GLenum idx_type = idx_size == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    const struct wined3d_gl_info *gl_info = context->gl_info;
+    GLint base_vertex_idx[WINED3D_MAX_DRAW_BATCH_SIZE];
+    const void *indices[WINED3D_MAX_DRAW_BATCH_SIZE];
+    GLsizei counts[WINED3D_MAX_DRAW_BATCH_SIZE];
+    unsigned int i;
+
+    for (i = 0; i < batch->count; ++i)
+    {
+        counts[i] = batch->draws[i].index_count;
+        indices[i] = (const char *)idx_data + idx_size * batch->draws[i].start_idx;
+        base_vertex_idx[i] = batch->draws[i].base_vertex_idx;
+    }
+
+    GL_EXTCALL(glMultiDrawElementsBaseVertex(state->gl_primitive_type, counts, idx_type,
+            indices, batch->count, base_vertex_idx));
+    checkGLcall("glMultiDrawElementsBaseVertex");
+}
+
 static unsigned int get_stride_idx(const void *idx_data, unsigned int idx_size,
         unsigned int base_vertex_idx, unsigned int start_idx, unsigned int vertex_idx)
 {
@@ -4993,18 +5029,33 @@ void draw_primitive(struct wined3d_device *device, const struct wined3d_state *s
     }
     else
     {
+        const struct wined3d_draw_batch *batch = parameters->batch;
+        const struct wined3d_direct_draw_parameters *direct;
         unsigned int instance_count = parameters->u.direct.instance_count;
+        unsigned int draw_count = batch ? batch->count : 1;
+
         if (context->instance_count)
             instance_count = context->instance_count;
 
-        if (context->use_immediate_mode_draw || emulation)
-            draw_primitive_immediate_mode(context, state, stream_info, idx_data,
-                    idx_size, parameters->u.direct.base_vertex_idx,
-                    parameters->u.direct.start_idx, parameters->u.direct.index_count, instance_count);
-        else
-            draw_primitive_arrays(context, state, idx_data, idx_size, parameters->u.direct.base_vertex_idx,
-                    parameters->u.direct.start_idx, parameters->u.direct.index_count,
-                    parameters->u.direct.start_instance, instance_count);
+        if (batch && !instance_count && !context->use_immediate_mode_draw && !emulation)
+        {
+            draw_primitive_batch(context, state, idx_data, idx_size, batch);
+            draw_count = 0;
+        }
+
+        for (i = 0; i < draw_count; ++i)
+        {
+            direct = batch ? &batch->draws[i] : &parameters->u.direct;
+
+            if (context->use_immediate_mode_draw || emulation)
+                draw_primitive_immediate_mode(context, state, stream_info, idx_data,
+                        idx_size, direct->base_vertex_idx,
+                        direct->start_idx, direct->index_count, instance_count);
+            else
+                draw_primitive_arrays(context, state, idx_data, idx_size, direct->base_vertex_idx,
+                        direct->start_idx, direct->index_count,
+                        direct->start_instance, instance_count);
+        }
     }
 
     if (context->uses_uavs)
@@ -69,6 +69,7 @@ enum wined3d_cs_op
     WINED3D_CS_OP_UNMAP,
     WINED3D_CS_OP_BLT_SUB_RESOURCE,
     WINED3D_CS_OP_UPDATE_SUB_RESOURCE,
+    WINED3D_CS_OP_UPLOAD_BUFFER,
     WINED3D_CS_OP_ADD_DIRTY_TEXTURE_REGION,
     WINED3D_CS_OP_CLEAR_UNORDERED_ACCESS_VIEW,
     WINED3D_CS_OP_COPY_UAV_COUNTER,
@@ -413,6 +414,14 @@ struct wined3d_cs_update_sub_resource
     struct wined3d_sub_resource_data data;
 };
 
+struct wined3d_cs_upload_buffer
+{
+    enum wined3d_cs_op opcode;
+    struct wined3d_buffer *buffer;
+    unsigned int ring_offset;
+    unsigned int ring_end;
+};
+
 struct wined3d_cs_add_dirty_texture_region
 {
     enum wined3d_cs_op opcode;
@@ -524,6 +533,7 @@ static const char *debug_cs_op(enum wined3d_cs_op op)
         WINED3D_TO_STR(WINED3D_CS_OP_UNMAP);
         WINED3D_TO_STR(WINED3D_CS_OP_BLT_SUB_RESOURCE);
         WINED3D_TO_STR(WINED3D_CS_OP_UPDATE_SUB_RESOURCE);
+        WINED3D_TO_STR(WINED3D_CS_OP_UPLOAD_BUFFER);
         WINED3D_TO_STR(WINED3D_CS_OP_ADD_DIRTY_TEXTURE_REGION);
         WINED3D_TO_STR(WINED3D_CS_OP_CLEAR_UNORDERED_ACCESS_VIEW);
         WINED3D_TO_STR(WINED3D_CS_OP_COPY_UAV_COUNTER);
@@ -550,6 +560,16 @@ static void wined3d_cs_exec_present(struct wined3d_cs *cs, const void *data)
     wined3d_swapchain_set_swap_interval(swapchain, op->swap_interval);
 
     swapchain->swapchain_ops->swapchain_present(swapchain, &op->src_rect, &op->dst_rect, op->flags);
+    wined3d_upload_ring_retire(cs->device);
+
+    if (cs->thread)
+    {
+        TRACE("Frame statistics: %u packets, %lu bytes, %u waits, %u ms idle.\n", cs->packet_count,
+                (unsigned long)cs->packet_bytes, cs->wait_count, cs->idle_time);
+        cs->packet_count = cs->wait_count = 0;
+        cs->packet_bytes = 0;
+        cs->idle_time = 0;
+    }
 
     wined3d_resource_release(&swapchain->front_buffer->resource);
     for (i = 0; i < swapchain->desc.backbuffer_count; ++i)
@@ -858,47 +878,12 @@ void wined3d_cs_emit_dispatch_indirect(struct wined3d_cs *cs,
     cs->ops->submit(cs, WINED3D_CS_QUEUE_DEFAULT);
 }
 
-static void wined3d_cs_exec_draw(struct wined3d_cs *cs, const void *data)
+static void release_graphics_pipeline_resources(const struct wined3d_state *state,
+        BOOL indexed, const struct wined3d_d3d_info *d3d_info)
 {
-    const struct wined3d_d3d_info *d3d_info = &cs->device->adapter->d3d_info;
-    const struct wined3d_gl_info *gl_info = &cs->device->adapter->gl_info;
-    const struct wined3d_shader *geometry_shader;
-    struct wined3d_state *state = &cs->state;
-    const struct wined3d_cs_draw *op = data;
-    int load_base_vertex_idx;
     unsigned int i;
 
-    /* ARB_draw_indirect always supports a base vertex offset. */
-    if (!op->parameters.indirect && !gl_info->supported[ARB_DRAW_ELEMENTS_BASE_VERTEX])
-        load_base_vertex_idx = op->parameters.u.direct.base_vertex_idx;
-    else
-        load_base_vertex_idx = 0;
-
-    if (state->load_base_vertex_index != load_base_vertex_idx)
-    {
-        state->load_base_vertex_index = load_base_vertex_idx;
-        device_invalidate_state(cs->device, STATE_BASEVERTEXINDEX);
-    }
-
-    if (state->gl_primitive_type != op->primitive_type)
-    {
-        if ((geometry_shader = state->shader[WINED3D_SHADER_TYPE_GEOMETRY]) && !geometry_shader->function)
-            device_invalidate_state(cs->device, STATE_SHADER(WINED3D_SHADER_TYPE_GEOMETRY));
-        if (state->gl_primitive_type == GL_POINTS || op->primitive_type == GL_POINTS)
-            device_invalidate_state(cs->device, STATE_POINT_ENABLE);
-        state->gl_primitive_type = op->primitive_type;
-    }
-    state->gl_patch_vertices = op->patch_vertex_count;
-
-    draw_primitive(cs->device, state, &op->parameters);
-
-    if (op->parameters.indirect)
-    {
-        struct wined3d_buffer *buffer = op->parameters.u.indirect.buffer;
-        wined3d_resource_release(&buffer->resource);
-    }
-
-    if (op->parameters.indexed)
+    if (indexed)
         wined3d_resource_release(&state->index_buffer->resource);
     for (i = 0; i < ARRAY_SIZE(state->streams); ++i)
     {
@@ -927,6 +912,114 @@ static void wined3d_cs_exec_draw(struct wined3d_cs *cs, const void *data)
             state->unordered_access_view[WINED3D_PIPELINE_GRAPHICS]);
 }
 
+static void wined3d_cs_draw(struct wined3d_cs *cs, GLenum primitive_type,
+        GLint patch_vertex_count, const struct wined3d_draw_parameters *parameters)
+{
+    const struct wined3d_gl_info *gl_info = &cs->device->adapter->gl_info;
+    const struct wined3d_shader *geometry_shader;
+    struct wined3d_state *state = &cs->state;
+    int load_base_vertex_idx;
+
+    /* ARB_draw_indirect always supports a base vertex offset. */
+    if (!parameters->indirect && !gl_info->supported[ARB_DRAW_ELEMENTS_BASE_VERTEX])
+        load_base_vertex_idx = parameters->u.direct.base_vertex_idx;
+    else
+        load_base_vertex_idx = 0;
+
+    if (state->load_base_vertex_index != load_base_vertex_idx)
+    {
+        state->load_base_vertex_index = load_base_vertex_idx;
+        device_invalidate_state(cs->device, STATE_BASEVERTEXINDEX);
+    }
+
+    if (state->gl_primitive_type != primitive_type)
+    {
+        if ((geometry_shader = state->shader[WINED3D_SHADER_TYPE_GEOMETRY]) && !geometry_shader->function)
+            device_invalidate_state(cs->device, STATE_SHADER(WINED3D_SHADER_TYPE_GEOMETRY));
+        if (state->gl_primitive_type == GL_POINTS || primitive_type == GL_POINTS)
+            device_invalidate_state(cs->device, STATE_POINT_ENABLE);
+        state->gl_primitive_type = primitive_type;
+    }
+    state->gl_patch_vertices = patch_vertex_count;
+
+    draw_primitive(cs->device, state, parameters);
+}
+
+static void wined3d_cs_flush_draw_batch(struct wined3d_cs *cs)
+{
+    const struct wined3d_d3d_info *d3d_info = &cs->device->adapter->d3d_info;
+    struct wined3d_draw_batch *batch = &cs->draw_batch;
+    struct wined3d_draw_parameters parameters;
+    unsigned int i;
+
+    if (!batch->count)
+        return;
+
+    TRACE("Drawing %u batched draws.\n", batch->count);
+
+    parameters.indirect = FALSE;
+    parameters.u.direct = batch->draws[0];
+    parameters.indexed = TRUE;
+    parameters.batch = batch->count > 1 ? batch : NULL;
+    wined3d_cs_draw(cs, cs->draw_batch_primitive_type, cs->draw_batch_patch_vertex_count, &parameters);
+
+    for (i = 0; i < batch->count; ++i)
+        release_graphics_pipeline_resources(&cs->state, TRUE, d3d_info);
+    batch->count = 0;
+}
+
+/* Only the CS thread batches draws; it flushes the batch before executing
+ * any other packet, and before it makes a batched draw visible as executed
+ * by moving the queue tail up to the queue head. */
+static BOOL wined3d_cs_batch_draw(struct wined3d_cs *cs, const struct wined3d_cs_draw *op)
+{
+    const struct wined3d_gl_info *gl_info = &cs->device->adapter->gl_info;
+    struct wined3d_draw_batch *batch = &cs->draw_batch;
+
+    if (!cs->thread || cs->thread_id != GetCurrentThreadId()
+            || !gl_info->supported[ARB_DRAW_ELEMENTS_BASE_VERTEX]
+            || op->parameters.indirect || !op->parameters.indexed
+            || op->parameters.u.direct.instance_count || !op->parameters.u.direct.index_count)
+        return FALSE;
+
+    if (batch->count && (batch->count >= wined3d_settings.draw_batch_size
+            || cs->draw_batch_primitive_type != op->primitive_type
+            || cs->draw_batch_patch_vertex_count != op->patch_vertex_count))
+        wined3d_cs_flush_draw_batch(cs);
+
+    if (wined3d_settings.draw_batch_size < 2)
+        return FALSE;
+
+    if (!batch->count)
+    {
+        cs->draw_batch_primitive_type = op->primitive_type;
+        cs->draw_batch_patch_vertex_count = op->patch_vertex_count;
+    }
+    batch->draws[batch->count++] = op->parameters.u.direct;
+
+    return TRUE;
+}
+
+static void wined3d_cs_exec_draw(struct wined3d_cs *cs, const void *data)
+{
+    const struct wined3d_d3d_info *d3d_info = &cs->device->adapter->d3d_info;
+    const struct wined3d_cs_draw *op = data;
+
+    if (wined3d_cs_batch_draw(cs, op))
+        return;
+    wined3d_cs_flush_draw_batch(cs);
+
+    wined3d_cs_draw(cs, op->primitive_type, op->patch_vertex_count, &op->parameters);
+
+    if (op->parameters.indirect)
+    {
+        struct wined3d_buffer *buffer = op->parameters.u.indirect.buffer;
+        wined3d_resource_release(&buffer->resource);
+    }
+
+    release_graphics_pipeline_resources(&cs->state, op->parameters.indexed, d3d_info);
+}
+
 static void acquire_graphics_pipeline_resources(const struct wined3d_state *state,
         BOOL indexed, const struct wined3d_d3d_info *d3d_info)
 {
@@ -980,6 +1073,7 @@ void wined3d_cs_emit_draw(struct wined3d_cs *cs, GLenum primitive_type, unsigned
     op->parameters.u.direct.start_instance = start_instance;
     op->parameters.u.direct.instance_count = instance_count;
     op->parameters.indexed = indexed;
+    op->parameters.batch = NULL;
 
     acquire_graphics_pipeline_resources(state, indexed, d3d_info);
 
@@ -1001,6 +1095,7 @@ void wined3d_cs_emit_draw_indirect(struct wined3d_cs *cs, GLenum primitive_type,
     op->parameters.u.indirect.buffer = buffer;
     op->parameters.u.indirect.offset = offset;
     op->parameters.indexed = indexed;
+    op->parameters.batch = NULL;
 
     acquire_graphics_pipeline_resources(state, indexed, d3d_info);
     wined3d_resource_acquire(&buffer->resource);
@@ -1046,7 +1141,7 @@ void wined3d_cs_emit_set_predication(struct wined3d_cs *cs, struct wined3d_query
     op->predicate = predicate;
     op->value = value;
 
-    cs->ops->submit(cs, WINED3D_CS_QUEUE_DEFAULT);
+    cs->ops->submit_delayed(cs, WINED3D_CS_QUEUE_DEFAULT);
 }
 
 static void wined3d_cs_exec_set_viewports(struct wined3d_cs *cs, const void *data)
@@ -1072,7 +1167,7 @@ void wined3d_cs_emit_set_viewports(struct wined3d_cs *cs, unsigned int viewport_
     memcpy(op->viewports, viewports, viewport_count * sizeof(*viewports));
     op->viewport_count = viewport_count;
 
-    cs->ops->submit(cs, WINED3D_CS_QUEUE_DEFAULT);
+    cs->ops->submit_delayed(cs, WINED3D_CS_QUEUE_DEFAULT);
 }
 
 static void wined3d_cs_exec_set_scissor_rects(struct wined3d_cs *cs, const void *data)
@@ -1097,7 +1192,7 @@ void wined3d_cs_emit_set_scissor_rects(struct wined3d_cs *cs, unsigned int rect_
     memcpy(op->rects, rects, rect_count * sizeof(*rects));
     op->rect_count = rect_count;
 
-    cs->ops->submit(cs, WINED3D_CS_QUEUE_DEFAULT);
+    cs->ops->submit_delayed(cs, WINED3D_CS_QUEUE_DEFAULT);
 }
 
 static void wined3d_cs_exec_set_rendertarget_view(struct wined3d_cs *cs, const void *data)
@@ -1118,7 +1213,7 @@ void wined3d_cs_emit_set_rendertarget_view(struct wined3d_cs *cs, unsigned int v
     op->view_idx = view_idx;
     op->view = view;
 
-    cs->ops->submit(cs, WINED3D_CS_QUEUE_DEFAULT);
+    cs->ops->submit_delayed(cs, WINED3D_CS_QUEUE_DEFAULT);
 }
 
 static void wined3d_cs_exec_set_depth_stencil_view(struct wined3d_cs *cs, const void *data)
@@ -1163,7 +1258,7 @@ void wined3d_cs_emit_set_depth_stencil_view(struct wined3d_cs *cs, struct wined3
     op->opcode = WINED3D_CS_OP_SET_DEPTH_STENCIL_VIEW;
     op->view = view;
 
-    cs->ops->submit(cs, WINED3D_CS_QUEUE_DEFAULT);
+    cs->ops->submit_delayed(cs, WINED3D_CS_QUEUE_DEFAULT);
 }
 
 static void wined3d_cs_exec_set_vertex_declaration(struct wined3d_cs *cs, const void *data)
@@ -1182,7 +1277,7 @@ void wined3d_cs_emit_set_vertex_declaration(struct wined3d_cs *cs, struct wined3
     op->opcode = WINED3D_CS_OP_SET_VERTEX_DECLARATION;
     op->declaration = declaration;
 
-    cs->ops->submit(cs, WINED3D_CS_QUEUE_DEFAULT);
+    cs->ops->submit_delayed(cs, WINED3D_CS_QUEUE_DEFAULT);
 }
 
 static void wined3d_cs_exec_set_stream_source(struct wined3d_cs *cs, const void *data)
@@ -1217,7 +1312,7 @@ void wined3d_cs_emit_set_stream_source(struct wined3d_cs *cs, UINT stream_idx,
     op->offset = offset;
     op->stride = stride;
 
-    cs->ops->submit(cs, WINED3D_CS_QUEUE_DEFAULT);
+    cs->ops->submit_delayed(cs, WINED3D_CS_QUEUE_DEFAULT);
 }
 
 static void wined3d_cs_exec_set_stream_source_freq(struct wined3d_cs *cs, const void *data)
@@ -1242,7 +1337,7 @@ void wined3d_cs_emit_set_stream_source_freq(struct wined3d_cs *cs, UINT stream_i
     op->frequency = frequency;
     op->flags = flags;
 
-    cs->ops->submit(cs, WINED3D_CS_QUEUE_DEFAULT);
+    cs->ops->submit_delayed(cs, WINED3D_CS_QUEUE_DEFAULT);
 }
 
 static void wined3d_cs_exec_set_stream_output(struct wined3d_cs *cs, const void *data)
@@ -1275,7 +1370,7 @@ void wined3d_cs_emit_set_stream_output(struct wined3d_cs *cs, UINT stream_idx,
     op->buffer = buffer;
     op->offset = offset;
 
-    cs->ops->submit(cs, WINED3D_CS_QUEUE_DEFAULT);
+    cs->ops->submit_delayed(cs, WINED3D_CS_QUEUE_DEFAULT);
 }
 
 static void wined3d_cs_exec_set_index_buffer(struct wined3d_cs *cs, const void *data)
@@ -1307,7 +1402,7 @@ void wined3d_cs_emit_set_index_buffer(struct wined3d_cs *cs, struct wined3d_buff
     op->format_id = format_id;
     op->offset = offset;
 
-    cs->ops->submit(cs, WINED3D_CS_QUEUE_DEFAULT);
+    cs->ops->submit_delayed(cs, WINED3D_CS_QUEUE_DEFAULT);
 }
 
 static void wined3d_cs_exec_set_constant_buffer(struct wined3d_cs *cs, const void *data)
@@ -1337,7 +1432,7 @@ void wined3d_cs_emit_set_constant_buffer(struct wined3d_cs *cs, enum wined3d_sha
     op->cb_idx = cb_idx;
     op->buffer = buffer;
 
-    cs->ops->submit(cs, WINED3D_CS_QUEUE_DEFAULT);
+    cs->ops->submit_delayed(cs, WINED3D_CS_QUEUE_DEFAULT);
 }
 
 static void wined3d_cs_exec_set_texture(struct wined3d_cs *cs, const void *data)
@@ -1428,7 +1523,7 @@ void wined3d_cs_emit_set_texture(struct wined3d_cs *cs, UINT stage, struct wined
     op->stage = stage;
     op->texture = texture;
 
-    cs->ops->submit(cs, WINED3D_CS_QUEUE_DEFAULT);
+    cs->ops->submit_delayed(cs, WINED3D_CS_QUEUE_DEFAULT);
 }
 
 static void wined3d_cs_exec_set_shader_resource_view(struct wined3d_cs *cs, const void *data)
@@ -1461,7 +1556,7 @@ void wined3d_cs_emit_set_shader_resource_view(struct wined3d_cs *cs, enum wined3
     op->view_idx = view_idx;
     op->view = view;
 
-    cs->ops->submit(cs, WINED3D_CS_QUEUE_DEFAULT);
+    cs->ops->submit_delayed(cs, WINED3D_CS_QUEUE_DEFAULT);
 }
 
 static void wined3d_cs_exec_set_unordered_access_view(struct wined3d_cs *cs, const void *data)
@@ -1495,7 +1590,7 @@ void wined3d_cs_emit_set_unordered_access_view(struct wined3d_cs *cs, enum wined
     op->view = view;
     op->initial_count = initial_count;
 
-    cs->ops->submit(cs, WINED3D_CS_QUEUE_DEFAULT);
+    cs->ops->submit_delayed(cs, WINED3D_CS_QUEUE_DEFAULT);
 }
 
 static void wined3d_cs_exec_set_sampler(struct wined3d_cs *cs, const void *data)
@@ -1520,7 +1615,7 @@ void wined3d_cs_emit_set_sampler(struct wined3d_cs *cs, enum wined3d_shader_type
     op->sampler_idx = sampler_idx;
     op->sampler = sampler;
 
-    cs->ops->submit(cs, WINED3D_CS_QUEUE_DEFAULT);
+    cs->ops->submit_delayed(cs, WINED3D_CS_QUEUE_DEFAULT);
 }
 
 static void wined3d_cs_exec_set_shader(struct wined3d_cs *cs, const void *data)
@@ -1544,7 +1639,7 @@ void wined3d_cs_emit_set_shader(struct wined3d_cs *cs, enum wined3d_shader_type
     op->type = type;
     op->shader = shader;
 
-    cs->ops->submit(cs, WINED3D_CS_QUEUE_DEFAULT);
+    cs->ops->submit_delayed(cs, WINED3D_CS_QUEUE_DEFAULT);
 }
 
 static void wined3d_cs_exec_set_blend_state(struct wined3d_cs *cs, const void *data)
@@ -1563,7 +1658,7 @@ void wined3d_cs_emit_set_blend_state(struct wined3d_cs *cs, struct wined3d_blend
     op->opcode = WINED3D_CS_OP_SET_BLEND_STATE;
     op->state = state;
 
-    cs->ops->submit(cs, WINED3D_CS_QUEUE_DEFAULT);
+    cs->ops->submit_delayed(cs, WINED3D_CS_QUEUE_DEFAULT);
 }
 
 static void wined3d_cs_exec_set_rasterizer_state(struct wined3d_cs *cs, const void *data)
@@ -1583,7 +1678,7 @@ void wined3d_cs_emit_set_rasterizer_state(struct wined3d_cs *cs,
     op->opcode = WINED3D_CS_OP_SET_RASTERIZER_STATE;
     op->state = rasterizer_state;
 
-    cs->ops->submit(cs, WINED3D_CS_QUEUE_DEFAULT);
+    cs->ops->submit_delayed(cs, WINED3D_CS_QUEUE_DEFAULT);
 }
 
 static void wined3d_cs_exec_set_render_state(struct wined3d_cs *cs, const void *data)
@@ -1603,7 +1698,7 @@ void wined3d_cs_emit_set_render_state(struct wined3d_cs *cs, enum wined3d_render
     op->state = state;
     op->value = value;
 
-    cs->ops->submit(cs, WINED3D_CS_QUEUE_DEFAULT);
+    cs->ops->submit_delayed(cs, WINED3D_CS_QUEUE_DEFAULT);
 }
 
 static void wined3d_cs_exec_set_texture_state(struct wined3d_cs *cs, const void *data)
@@ -1625,7 +1720,7 @@ void wined3d_cs_emit_set_texture_state(struct wined3d_cs *cs, UINT stage,
     op->state = state;
     op->value = value;
 
-    cs->ops->submit(cs, WINED3D_CS_QUEUE_DEFAULT);
+    cs->ops->submit_delayed(cs, WINED3D_CS_QUEUE_DEFAULT);
 }
 
 static void wined3d_cs_exec_set_sampler_state(struct wined3d_cs *cs, const void *data)
@@ -1647,7 +1742,7 @@ void wined3d_cs_emit_set_sampler_state(struct wined3d_cs *cs, UINT sampler_idx,
     op->state = state;
     op->value = value;
 
-    cs->ops->submit(cs, WINED3D_CS_QUEUE_DEFAULT);
+    cs->ops->submit_delayed(cs, WINED3D_CS_QUEUE_DEFAULT);
 }
 
 static void wined3d_cs_exec_set_transform(struct wined3d_cs *cs, const void *data)
@@ -1669,7 +1764,7 @@ void wined3d_cs_emit_set_transform(struct wined3d_cs *cs, enum wined3d_transform
     op->state = state;
     op->matrix = *matrix;
 
-    cs->ops->submit(cs, WINED3D_CS_QUEUE_DEFAULT);
+    cs->ops->submit_delayed(cs, WINED3D_CS_QUEUE_DEFAULT);
 }
 
 static void wined3d_cs_exec_set_clip_plane(struct wined3d_cs *cs, const void *data)
@@ -1689,7 +1784,7 @@ void wined3d_cs_emit_set_clip_plane(struct wined3d_cs *cs, UINT plane_idx, const
     op->plane_idx = plane_idx;
     op->plane = *plane;
 
-    cs->ops->submit(cs, WINED3D_CS_QUEUE_DEFAULT);
+    cs->ops->submit_delayed(cs, WINED3D_CS_QUEUE_DEFAULT);
 }
 
 static void wined3d_cs_exec_set_color_key(struct wined3d_cs *cs, const void *data)
@@ -1772,7 +1867,7 @@ void wined3d_cs_emit_set_color_key(struct wined3d_cs *cs, struct wined3d_texture
     else
         op->set = 0;
 
-    cs->ops->submit(cs, WINED3D_CS_QUEUE_DEFAULT);
+    cs->ops->submit_delayed(cs, WINED3D_CS_QUEUE_DEFAULT);
 }
 
 static void wined3d_cs_exec_set_material(struct wined3d_cs *cs, const void *data)
@@ -1791,7 +1886,7 @@ void wined3d_cs_emit_set_material(struct wined3d_cs *cs, const struct wined3d_ma
     op->opcode = WINED3D_CS_OP_SET_MATERIAL;
     op->material = *material;
 
-    cs->ops->submit(cs, WINED3D_CS_QUEUE_DEFAULT);
+    cs->ops->submit_delayed(cs, WINED3D_CS_QUEUE_DEFAULT);
 }
 
 static void wined3d_cs_exec_set_light(struct wined3d_cs *cs, const void *data)
@@ -1839,7 +1934,7 @@ void wined3d_cs_emit_set_light(struct wined3d_cs *cs, const struct wined3d_light
     op->opcode = WINED3D_CS_OP_SET_LIGHT;
     op->light = *light;
 
-    cs->ops->submit(cs, WINED3D_CS_QUEUE_DEFAULT);
+    cs->ops->submit_delayed(cs, WINED3D_CS_QUEUE_DEFAULT);
 }
 
 static void wined3d_cs_exec_set_light_enable(struct wined3d_cs *cs, const void *data)
@@ -1873,7 +1968,7 @@ void wined3d_cs_emit_set_light_enable(struct wined3d_cs *cs, unsigned int idx, B
     op->idx = idx;
     op->enable = enable;
 
-    cs->ops->submit(cs, WINED3D_CS_QUEUE_DEFAULT);
+    cs->ops->submit_delayed(cs, WINED3D_CS_QUEUE_DEFAULT);
 }
 
 static const struct
@@ -1941,7 +2036,7 @@ static void wined3d_cs_mt_push_constants(struct wined3d_cs *cs, enum wined3d_pus
     op->count = count;
     memcpy(op->constants, constants, size);
 
-    cs->ops->submit(cs, WINED3D_CS_QUEUE_DEFAULT);
+    cs->ops->submit_delayed(cs, WINED3D_CS_QUEUE_DEFAULT);
 }
 
 static void wined3d_cs_exec_reset_state(struct wined3d_cs *cs, const void *data)
@@ -2362,6 +2457,36 @@ void wined3d_cs_emit_update_sub_resource(struct wined3d_cs *cs, struct wined3d_r
     cs->ops->finish(cs, WINED3D_CS_QUEUE_MAP);
 }
 
+static void wined3d_cs_exec_upload_buffer(struct wined3d_cs *cs, const void *data)
+{
+    const struct wined3d_cs_upload_buffer *op = data;
+    struct wined3d_context *context;
+
+    context = context_acquire(cs->device, NULL, 0);
+    wined3d_buffer_upload_from_ring(op->buffer, context, op->ring_offset, op->ring_end);
+    context_release(context);
+
+    wined3d_resource_release(&op->buffer->resource);
+}
+
+void wined3d_cs_emit_upload_buffer(struct wined3d_cs *cs, struct wined3d_buffer *buffer,
+        unsigned int ring_offset, unsigned int ring_end)
+{
+    struct wined3d_cs_upload_buffer *op;
+
+    /* The data already lives in the upload ring, so unlike
+     * wined3d_cs_emit_update_sub_resource() there's no need to wait. */
+    op = cs->ops->require_space(cs, sizeof(*op), WINED3D_CS_QUEUE_DEFAULT);
+    op->opcode = WINED3D_CS_OP_UPLOAD_BUFFER;
+    op->buffer = buffer;
+    op->ring_offset = ring_offset;
+    op->ring_end = ring_end;
+
+    wined3d_resource_acquire(&buffer->resource);
+
+    cs->ops->submit(cs, WINED3D_CS_QUEUE_DEFAULT);
+}
+
 static void wined3d_cs_exec_add_dirty_texture_region(struct wined3d_cs *cs, const void *data)
 {
     const struct wined3d_cs_add_dirty_texture_region *op = data;
@@ -2656,6 +2781,7 @@ static void (* const wined3d_cs_op_handlers[])(struct wined3d_cs *cs, const void
     /* WINED3D_CS_OP_UNMAP                       */ wined3d_cs_exec_unmap,
     /* WINED3D_CS_OP_BLT_SUB_RESOURCE            */ wined3d_cs_exec_blt_sub_resource,
     /* WINED3D_CS_OP_UPDATE_SUB_RESOURCE         */ wined3d_cs_exec_update_sub_resource,
+    /* WINED3D_CS_OP_UPLOAD_BUFFER               */ wined3d_cs_exec_upload_buffer,
     /* WINED3D_CS_OP_ADD_DIRTY_TEXTURE_REGION    */ wined3d_cs_exec_add_dirty_texture_region,
     /* WINED3D_CS_OP_CLEAR_UNORDERED_ACCESS_VIEW */ wined3d_cs_exec_clear_unordered_access_view,
     /* WINED3D_CS_OP_COPY_UAV_COUNTER            */ wined3d_cs_exec_copy_uav_counter,
@@ -2720,6 +2846,7 @@ static const struct wined3d_cs_ops wined3d_cs_st_ops =
 {
     wined3d_cs_st_require_space,
     wined3d_cs_st_submit,
+    wined3d_cs_st_submit,
     wined3d_cs_st_finish,
     wined3d_cs_st_push_constants,
 };
@@ -2730,17 +2857,34 @@ static BOOL wined3d_cs_queue_is_empty(const struct wined3d_cs *cs, const struct
     return *(volatile LONG *)&queue->head == queue->tail;
 }
 
-static void wined3d_cs_queue_submit(struct wined3d_cs_queue *queue, struct wined3d_cs *cs)
+static void wined3d_cs_queue_flush(struct wined3d_cs_queue *queue, struct wined3d_cs *cs)
+{
+    if (queue->head == queue->end)
+        return;
+
+    InterlockedExchange(&queue->head, queue->end);
+
+    if (InterlockedCompareExchange(&cs->waiting_for_event, FALSE, TRUE))
+        SetEvent(cs->event);
+}
+
+static void wined3d_cs_queue_submit(struct wined3d_cs_queue *queue, struct wined3d_cs *cs, BOOL delay)
 {
     struct wined3d_cs_packet *packet;
     size_t packet_size;
 
-    packet = (struct wined3d_cs_packet *)&queue->data[queue->head];
+    packet = (struct wined3d_cs_packet *)&queue->data[queue->end];
     packet_size = FIELD_OFFSET(struct wined3d_cs_packet, data[packet->size]);
-    InterlockedExchange(&queue->head, (queue->head + packet_size) & (WINED3D_CS_QUEUE_SIZE - 1));
+    queue->end = (queue->end + packet_size) & (WINED3D_CS_QUEUE_SIZE - 1);
 
-    if (InterlockedCompareExchange(&cs->waiting_for_event, FALSE, TRUE))
-        SetEvent(cs->event);
+    /* State changes are only observable by the next draw or other operation
+     * that is submitted normally, so we can hand consecutive state packets
+     * to the CS thread in one go. This saves a cache line transfer and a
+     * potential wakeup per packet. */
+    if (delay && ((queue->end - queue->head) & (WINED3D_CS_QUEUE_SIZE - 1)) < WINED3D_CS_MAX_DELAYED_SIZE)
+        return;
+
+    wined3d_cs_queue_flush(queue, cs);
 }
 
 static void wined3d_cs_mt_submit(struct wined3d_cs *cs, enum wined3d_cs_queue_id queue_id)
@@ -2748,7 +2892,15 @@ static void wined3d_cs_mt_submit(struct wined3d_cs *cs, enum wined3d_cs_queue_id
     if (cs->thread_id == GetCurrentThreadId())
         return wined3d_cs_st_submit(cs, queue_id);
 
-    wined3d_cs_queue_submit(&cs->queue[queue_id], cs);
+    wined3d_cs_queue_submit(&cs->queue[queue_id], cs, FALSE);
+}
+
+static void wined3d_cs_mt_submit_delayed(struct wined3d_cs *cs, enum wined3d_cs_queue_id queue_id)
+{
+    if (cs->thread_id == GetCurrentThreadId())
+        return wined3d_cs_st_submit(cs, queue_id);
+
+    wined3d_cs_queue_submit(&cs->queue[queue_id], cs, TRUE);
 }
 
 static void *wined3d_cs_queue_require_space(struct wined3d_cs_queue *queue, size_t size, struct wined3d_cs *cs)
@@ -2767,7 +2919,7 @@ static void *wined3d_cs_queue_require_space(struct wined3d_cs_queue *queue, size
         return NULL;
     }
 
-    remaining = queue_size - queue->head;
+    remaining = queue_size - queue->end;
     if (remaining < packet_size)
     {
         size_t nop_size = remaining - header_size;
@@ -2780,14 +2932,14 @@ static void *wined3d_cs_queue_require_space(struct wined3d_cs_queue *queue, size
         if (nop_size)
             nop->opcode = WINED3D_CS_OP_NOP;
 
-        wined3d_cs_queue_submit(queue, cs);
+        wined3d_cs_queue_submit(queue, cs, FALSE);
         assert(!queue->head);
     }
 
     for (;;)
     {
         LONG tail = *(volatile LONG *)&queue->tail;
-        LONG head = queue->head;
+        LONG head = queue->end;
         LONG new_pos;
 
         /* Empty. */
@@ -2805,9 +2957,10 @@ static void *wined3d_cs_queue_require_space(struct wined3d_cs_queue *queue, size
 
         TRACE("Waiting for free space. Head %u, tail %u, packet size %lu.\n",
                 head, tail, (unsigned long)packet_size);
+        wined3d_cs_queue_flush(queue, cs);
     }
 
-    packet = (struct wined3d_cs_packet *)&queue->data[queue->head];
+    packet = (struct wined3d_cs_packet *)&queue->data[queue->end];
     packet->size = size;
     return packet->data;
 }
@@ -2825,6 +2978,7 @@ static void wined3d_cs_mt_finish(struct wined3d_cs *cs, enum wined3d_cs_queue_id
     if (cs->thread_id == GetCurrentThreadId())
         return wined3d_cs_st_finish(cs, queue_id);
 
+    wined3d_cs_queue_flush(&cs->queue[queue_id], cs);
     while (cs->queue[queue_id].head != *(volatile LONG *)&cs->queue[queue_id].tail)
         wined3d_pause();
 }
@@ -2833,6 +2987,7 @@ static const struct wined3d_cs_ops wined3d_cs_mt_ops =
 {
     wined3d_cs_mt_require_space,
     wined3d_cs_mt_submit,
+    wined3d_cs_mt_submit_delayed,
     wined3d_cs_mt_finish,
     wined3d_cs_mt_push_constants,
 };
@@ -2854,6 +3009,8 @@ static void poll_queries(struct wined3d_cs *cs)
 
 static void wined3d_cs_wait_event(struct wined3d_cs *cs)
 {
+    DWORD start;
+
     InterlockedExchange(&cs->waiting_for_event, TRUE);
 
     /* The main thread might have enqueued a command and blocked on it after
@@ -2868,7 +3025,10 @@ static void wined3d_cs_wait_event(struct wined3d_cs *cs)
             && InterlockedCompareExchange(&cs->waiting_for_event, FALSE, TRUE))
         return;
 
+    start = GetTickCount();
     WaitForSingleObject(cs->event, INFINITE);
+    cs->idle_time += GetTickCount() - start;
+    ++cs->wait_count;
 }
 
 static DWORD WINAPI wined3d_cs_run(void *ctx)
@@ -2916,6 +3076,8 @@ static DWORD WINAPI wined3d_cs_run(void *ctx)
         if (packet->size)
         {
             opcode = *(const enum wined3d_cs_op *)packet->data;
+            if (opcode != WINED3D_CS_OP_DRAW)
+                wined3d_cs_flush_draw_batch(cs);
 
             TRACE("Executing %s.\n", debug_cs_op(opcode));
             if (opcode >= WINED3D_CS_OP_STOP)
@@ -2927,10 +3089,17 @@ static DWORD WINAPI wined3d_cs_run(void *ctx)
 
             wined3d_cs_op_handlers[opcode](cs, packet->data);
             TRACE("%s executed.\n", debug_cs_op(opcode));
+
+            ++cs->packet_count;
+            cs->packet_bytes += packet->size;
         }
 
         tail += FIELD_OFFSET(struct wined3d_cs_packet, data[packet->size]);
         tail &= (WINED3D_CS_QUEUE_SIZE - 1);
+        /* wined3d_cs_mt_finish() waits for the tail to reach the head, and
+         * expects every queued draw to have been issued by then. */
+        if (tail == *(volatile LONG *)&queue->head)
+            wined3d_cs_flush_draw_batch(cs);
         InterlockedExchange(&queue->tail, tail);
     }
 
@@ -1006,6 +1006,8 @@ static void wined3d_device_delete_opengl_contexts_cs(void *object)
     device->shader_backend->shader_free_private(device);
     destroy_dummy_textures(device, context);
     destroy_default_samplers(device, context);
+    wined3d_upload_ring_cleanup(&device->upload_ring, context);
+    wined3d_texture_destroy_staging_bo(device, context);
     context_release(context);
 
     while (device->context_count)
@@ -1055,6 +1057,7 @@ static void wined3d_device_create_primary_opengl_context_cs(void *object)
     context = context_acquire(device, target, 0);
     create_dummy_textures(device, context);
     create_default_samplers(device, context);
+    wined3d_upload_ring_init(&device->upload_ring, context);
     context_release(context);
 }
 
@@ -1921,6 +1924,16 @@ void CDECL wined3d_device_set_viewports(struct wined3d_device *device, unsigned
                 viewports[i].width, viewports[i].height, viewports[i].min_z, viewports[i].max_z);
     }
 
+    if (device->recording)
+        device->recording->changed.viewport = TRUE;
+
+    if (device->update_state->viewport_count == viewport_count
+            && !memcmp(device->update_state->viewports, viewports, viewport_count * sizeof(*viewports)))
+    {
+        TRACE("App is setting the old viewports over, nothing to do.\n");
+        return;
+    }
+
     if (viewport_count)
         memcpy(device->update_state->viewports, viewports, viewport_count * sizeof(*viewports));
     else
@@ -1931,7 +1944,6 @@ void CDECL wined3d_device_set_viewports(struct wined3d_device *device, unsigned
     if (device->recording)
     {
         TRACE("Recording... not performing anything\n");
-        device->recording->changed.viewport = TRUE;
         return;
     }
 
@@ -5219,10 +5231,6 @@ err:
 
 void device_invalidate_state(const struct wined3d_device *device, DWORD state)
 {
-    DWORD rep = device->StateTable[state].representative;
-    struct wined3d_context *context;
-    DWORD idx;
-    BYTE shift;
     UINT i;
 
     wined3d_from_cs(device->cs);
@@ -5235,15 +5243,7 @@ void device_invalidate_state(const struct wined3d_device *device, DWORD state)
     }
 
     for (i = 0; i < device->context_count; ++i)
-    {
-        context = device->contexts[i];
-        if(isStateDirty(context, rep)) continue;
-
-        context->dirtyArray[context->numDirtyEntries++] = rep;
-        idx = rep / (sizeof(*context->isStateDirty) * CHAR_BIT);
-        shift = rep & ((sizeof(*context->isStateDirty) * CHAR_BIT) - 1);
-        context->isStateDirty[idx] |= (1u << shift);
-    }
+        context_invalidate_state(device->contexts[i], state);
 }
 
 LRESULT device_process_message(struct wined3d_device *device, HWND window, BOOL unicode,
@@ -127,6 +127,42 @@ struct constant_heap
     unsigned int size;
 };
 
+#define WINED3D_GLSL_PROGRAM_CACHE_MAGIC    0x70336477u /* "wd3p" */
+#define WINED3D_GLSL_PROGRAM_CACHE_VERSION  1
+
+/* On-disk header of a cached program binary. The binary itself follows. */
+struct glsl_program_cache_header
+{
+    DWORD magic;
+    DWORD version;
+    UINT64 key;
+    DWORD source_size;
+    GLenum binary_format;
+    DWORD binary_size;
+    DWORD reserved;
+};
+
+struct glsl_program_cache_key
+{
+    UINT64 hash;
+    DWORD source_size;
+};
+
+struct glsl_program_cache
+{
+    BOOL initialised;
+    BOOL enabled;
+    char path[MAX_PATH];
+    UINT64 driver_hash;
+    UINT64 max_size;
+    UINT64 size;
+
+    unsigned int hits;
+    unsigned int misses;
+    unsigned int rejects;
+    unsigned int stores;
+};
+
 /* GLSL shader private data */
 struct shader_glsl_priv
 {
@@ -144,6 +180,8 @@ struct shader_glsl_priv
     struct wine_rb_tree ffp_fragment_shaders;
     BOOL ffp_proj_control;
     BOOL legacy_lighting;
+
+    struct glsl_program_cache program_cache;
 };
 
 struct glsl_vs_program
@@ -253,11 +291,15 @@ struct glsl_shader_prog_link
     struct glsl_ps_program ps;
     struct glsl_cs_program cs;
     GLuint id;
+    struct wined3d_shader *shaders[WINED3D_SHADER_TYPE_GRAPHICS_COUNT];
+    struct glsl_program_cache_key cache_key;
     DWORD constant_update_mask;
     unsigned int constant_version;
     DWORD shader_controlled_clip_distances : 1;
     DWORD clip_distance_mask : 8; /* MAX_CLIP_DISTANCES, 8 */
-    DWORD padding : 23;
+    DWORD link_pending : 1;
+    DWORD cache_store : 1;
+    DWORD padding : 21;
 };
 
 struct glsl_program_key
@@ -281,6 +323,7 @@ struct shader_glsl_ctx_priv {
 struct glsl_context_data
 {
     struct glsl_shader_prog_link *glsl_program;
+    struct glsl_shader_prog_link *pending_program;
     GLenum vertex_color_clamp;
     BOOL rasterization_disabled;
 };
@@ -603,6 +646,336 @@ void shader_glsl_validate_link(const struct wined3d_gl_info *gl_info, GLuint pro
     print_glsl_info_log(gl_info, program, TRUE);
 }
 
+static UINT64 glsl_program_cache_hash(UINT64 hash, const void *data, size_t size)
+{
+    const BYTE *ptr = data;
+    size_t i;
+
+    /* FNV-1a */
+    for (i = 0; i < size; ++i)
+    {
+        hash ^= ptr[i];
+        hash *= 0x100000001b3ull;
+    }
+
+    return hash;
+}
+
+static int glsl_program_cache_hash_compare(const void *a, const void *b)
+{
+    const UINT64 *hash_a = a, *hash_b = b;
+
+    return (*hash_a > *hash_b) - (*hash_a < *hash_b);
+}
+
+/* Context activation is done by the caller. */
+static void glsl_program_cache_init(struct glsl_program_cache *cache, const struct wined3d_gl_info *gl_info)
+{
+    static const GLenum driver_strings[] = {GL_VENDOR, GL_RENDERER, GL_VERSION};
+    static const char default_dir[] = "\\wined3d";
+    char pattern[MAX_PATH + 16];
+    WIN32_FIND_DATAA data;
+    unsigned int pointer_size;
+    GLint format_count;
+    const char *str;
+    unsigned int i;
+    HANDLE find;
+    DWORD len;
+
+    cache->initialised = TRUE;
+
+    if (!wined3d_settings.shader_cache_size || !gl_info->supported[ARB_GET_PROGRAM_BINARY])
+        return;
+
+    gl_info->gl_ops.gl.p_glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &format_count);
+    if (!format_count)
+    {
+        TRACE("No program binary formats supported.\n");
+        return;
+    }
+
+    if (wined3d_settings.shader_cache)
+    {
+        if (strlen(wined3d_settings.shader_cache) >= sizeof(cache->path))
+        {
+            WARN("Program binary cache path %s is too long.\n", debugstr_a(wined3d_settings.shader_cache));
+            return;
+        }
+        strcpy(cache->path, wined3d_settings.shader_cache);
+    }
+    else
+    {
+        len = GetEnvironmentVariableA("LOCALAPPDATA", cache->path, sizeof(cache->path));
+        if (!len || len + strlen(default_dir) >= sizeof(cache->path))
+        {
+            WARN("Failed to get the local application data directory.\n");
+            return;
+        }
+        strcat(cache->path, default_dir);
+    }
+
+    if (!CreateDirectoryA(cache->path, NULL) && GetLastError() != ERROR_ALREADY_EXISTS)
+    {
+        WARN("Failed to create program binary cache directory %s, error %u.\n",
+                debugstr_a(cache->path), GetLastError());
+        return;
+    }
+
+    /* Binaries are only valid for the driver build that produced them.
+     * Drivers are expected to reject foreign binaries, but keying on the
+     * driver identity avoids repeatedly trying to load them. */
+    pointer_size = sizeof(void *);
+    cache->driver_hash = glsl_program_cache_hash(0xcbf29ce484222325ull, &pointer_size, sizeof(pointer_size));
+    for (i = 0; i < ARRAY_SIZE(driver_strings); ++i)
+    {
+        if ((str = (const char *)gl_info->gl_ops.gl.p_glGetString(driver_strings[i])))
+            cache->driver_hash = glsl_program_cache_hash(cache->driver_hash, str, strlen(str) + 1);
+    }
+
+    sprintf(pattern, "%s\\*.bin", cache->path);
+    if ((find = FindFirstFileA(pattern, &data)) != INVALID_HANDLE_VALUE)
+    {
+        do
+        {
+            cache->size += ((UINT64)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+        } while (FindNextFileA(find, &data));
+        FindClose(find);
+    }
+
+    cache->max_size = (UINT64)wined3d_settings.shader_cache_size << 20;
+    cache->enabled = TRUE;
+
+    TRACE("Using program binary cache %s, %s of %s bytes used.\n", debugstr_a(cache->path),
+            wine_dbgstr_longlong(cache->size), wine_dbgstr_longlong(cache->max_size));
+}
+
+static void glsl_program_cache_get_filename(const struct glsl_program_cache *cache,
+        const struct glsl_program_cache_key *key, char *filename)
+{
+    sprintf(filename, "%s\\%08x%08x.bin", cache->path, (DWORD)(key->hash >> 32), (DWORD)key->hash);
+}
+
+/* The key covers the source of every attached shader object. Since the
+ * generated GLSL depends on the compile args, this implicitly covers those
+ * as well. Shaders are hashed individually and sorted, so the key doesn't
+ * depend on the order in which the GL returns the attached shaders.
+ *
+ * Context activation is done by the caller. */
+static BOOL glsl_program_cache_get_key(struct glsl_program_cache *cache,
+        const struct wined3d_gl_info *gl_info, GLuint program_id, struct glsl_program_cache_key *key)
+{
+    GLint i, shader_count, source_size = 0, length, type;
+    char *source = NULL;
+    UINT64 *hashes;
+    GLuint *shaders;
+    BOOL ret = FALSE;
+
+    if (!cache->initialised)
+        glsl_program_cache_init(cache, gl_info);
+    if (!cache->enabled)
+        return FALSE;
+
+    GL_EXTCALL(glGetProgramiv(program_id, GL_ATTACHED_SHADERS, &shader_count));
+    if (!shader_count)
+        return FALSE;
+    shaders = heap_calloc(shader_count, sizeof(*shaders));
+    hashes = heap_calloc(shader_count, sizeof(*hashes));
+    if (!shaders || !hashes)
+        goto done;
+
+    key->source_size = 0;
+    GL_EXTCALL(glGetAttachedShaders(program_id, shader_count, NULL, shaders));
+    for (i = 0; i < shader_count; ++i)
+    {
+        GL_EXTCALL(glGetShaderiv(shaders[i], GL_SHADER_TYPE, &type));
+        GL_EXTCALL(glGetShaderiv(shaders[i], GL_SHADER_SOURCE_LENGTH, &length));
+        if (source_size < length)
+        {
+            heap_free(source);
+            if (!(source = heap_alloc(length)))
+                goto done;
+            source_size = length;
+        }
+        length = 0;
+        GL_EXTCALL(glGetShaderSource(shaders[i], source_size, &length, source));
+
+        hashes[i] = glsl_program_cache_hash(cache->driver_hash, &type, sizeof(type));
+        hashes[i] = glsl_program_cache_hash(hashes[i], source, length);
+        key->source_size += length;
+    }
+    checkGLcall("get program cache key");
+
+    qsort(hashes, shader_count, sizeof(*hashes), glsl_program_cache_hash_compare);
+    key->hash = glsl_program_cache_hash(cache->driver_hash, hashes, shader_count * sizeof(*hashes));
+    ret = TRUE;
+
+done:
+    heap_free(source);
+    heap_free(hashes);
+    heap_free(shaders);
+    return ret;
+}
+
+/* Context activation is done by the caller. */
+static BOOL glsl_program_cache_load(struct glsl_program_cache *cache, const struct wined3d_gl_info *gl_info,
+        GLuint program_id, const struct glsl_program_cache_key *key)
+{
+    struct glsl_program_cache_header header;
+    char filename[MAX_PATH + 32];
+    LARGE_INTEGER file_size;
+    void *binary = NULL;
+    BOOL ret = FALSE;
+    GLint status;
+    HANDLE file;
+    DWORD read;
+
+    glsl_program_cache_get_filename(cache, key, filename);
+    if ((file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL,
+            OPEN_EXISTING, 0, NULL)) == INVALID_HANDLE_VALUE)
+    {
+        ++cache->misses;
+        return FALSE;
+    }
+
+    file_size.QuadPart = 0;
+    if (!GetFileSizeEx(file, &file_size)
+            || !ReadFile(file, &header, sizeof(header), &read, NULL) || read != sizeof(header)
+            || header.magic != WINED3D_GLSL_PROGRAM_CACHE_MAGIC
+            || header.version != WINED3D_GLSL_PROGRAM_CACHE_VERSION
+            || header.key != key->hash || header.source_size != key->source_size
+            || file_size.QuadPart != sizeof(header) + (UINT64)header.binary_size
+            || !(binary = heap_alloc(header.binary_size))
+            || !ReadFile(file, binary, header.binary_size, &read, NULL) || read != header.binary_size)
+    {
+        WARN("Invalid program binary cache entry %s.\n", debugstr_a(filename));
+        goto done;
+    }
+
+    GL_EXTCALL(glProgramBinary(program_id, header.binary_format, binary, header.binary_size));
+    GL_EXTCALL(glGetProgramiv(program_id, GL_LINK_STATUS, &status));
+    checkGLcall("glProgramBinary");
+    if (!status)
+    {
+        TRACE("Program binary %s was rejected.\n", debugstr_a(filename));
+        goto done;
+    }
+
+    TRACE("Loaded program %u from %s.\n", program_id, debugstr_a(filename));
+    ret = TRUE;
+
+done:
+    CloseHandle(file);
+    heap_free(binary);
+    if (ret)
+    {
+        ++cache->hits;
+    }
+    else
+    {
+        /* Drop stale entries, the program is relinked and stored again. */
+        ++cache->rejects;
+        if (DeleteFileA(filename))
+            cache->size -= min(cache->size, file_size.QuadPart);
+    }
+    return ret;
+}
+
+/* Context activation is done by the caller. */
+static void glsl_program_cache_store(struct glsl_program_cache *cache, const struct wined3d_gl_info *gl_info,
+        GLuint program_id, const struct glsl_program_cache_key *key)
+{
+    struct glsl_program_cache_header header;
+    char filename[MAX_PATH + 32];
+    GLint status, length;
+    void *binary;
+    DWORD written;
+    HANDLE file;
+
+    GL_EXTCALL(glGetProgramiv(program_id, GL_LINK_STATUS, &status));
+    GL_EXTCALL(glGetProgramiv(program_id, GL_PROGRAM_BINARY_LENGTH, &length));
+    if (!status || length <= 0)
+        return;
+
+    if (cache->size + sizeof(header) + length > cache->max_size)
+    {
+        TRACE("Program binary cache is full, not storing program %u.\n", program_id);
+        return;
+    }
+
+    if (!(binary = heap_alloc(length)))
+        return;
+    GL_EXTCALL(glGetProgramBinary(program_id, length, &length, &header.binary_format, binary));
+    checkGLcall("glGetProgramBinary");
+
+    header.magic = WINED3D_GLSL_PROGRAM_CACHE_MAGIC;
+    header.version = WINED3D_GLSL_PROGRAM_CACHE_VERSION;
+    header.key = key->hash;
+    header.source_size = key->source_size;
+    header.binary_size = length;
+    header.reserved = 0;
+
+    /* Entries are never overwritten. CREATE_NEW also keeps other processes
+     * from reading partially written entries, since those are opened
+     * without sharing. */
+    glsl_program_cache_get_filename(cache, key, filename);
+    if ((file = CreateFileA(filename, GENERIC_WRITE, 0, NULL, CREATE_NEW, 0, NULL)) != INVALID_HANDLE_VALUE)
+    {
+        if (WriteFile(file, &header, sizeof(header), &written, NULL) && written == sizeof(header)
+                && WriteFile(file, binary, length, &written, NULL) && written == length)
+        {
+            TRACE("Stored program %u to %s.\n", program_id, debugstr_a(filename));
+            cache->size += sizeof(header) + length;
+            ++cache->stores;
+            CloseHandle(file);
+        }
+        else
+        {
+            WARN("Failed to write %s, error %u.\n", debugstr_a(filename), GetLastError());
+            CloseHandle(file);
+            DeleteFileA(filename);
+        }
+    }
+
+    heap_free(binary);
+}
+
+/* Starts linking the program. With ARB_parallel_shader_compile the link may
+ * still be in progress when this returns, anything that waits for it is
+ * done by shader_glsl_finish_link().
+ *
+ * Context activation is done by the caller. */
+static void shader_glsl_link_program(struct shader_glsl_priv *priv, const struct wined3d_gl_info *gl_info,
+        struct glsl_shader_prog_link *entry, BOOL cacheable)
+{
+    struct glsl_program_cache *cache = &priv->program_cache;
+    GLuint program_id = entry->id;
+
+    entry->cache_store = 0;
+    if (cacheable)
+    {
+        if ((cacheable = glsl_program_cache_get_key(cache, gl_info, program_id, &entry->cache_key))
+                && glsl_program_cache_load(cache, gl_info, program_id, &entry->cache_key))
+            return;
+    }
+
+    TRACE("Linking GLSL shader program %u.\n", program_id);
+    if (cacheable)
+        GL_EXTCALL(glProgramParameteri(program_id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+    GL_EXTCALL(glLinkProgram(program_id));
+    entry->cache_store = cacheable;
+}
+
+/* Context activation is done by the caller. */
+static void shader_glsl_finish_link(struct shader_glsl_priv *priv, const struct wined3d_gl_info *gl_info,
+        struct glsl_shader_prog_link *entry)
+{
+    shader_glsl_validate_link(gl_info, entry->id);
+
+    if (entry->cache_store)
+        glsl_program_cache_store(&priv->program_cache, gl_info, entry->id, &entry->cache_key);
+    entry->cache_store = 0;
+}
+
 static BOOL shader_glsl_use_layout_qualifier(const struct wined3d_gl_info *gl_info)
 {
     /* Layout qualifiers were introduced in GLSL 1.40. The Nvidia Legacy GPU
@@ -10292,8 +10665,10 @@ static HRESULT shader_glsl_compile_compute_shader(struct shader_glsl_priv *priv,
     entry->gs.id = 0;
     entry->ps.id = 0;
     entry->cs.id = shader_id;
+    memset(entry->shaders, 0, sizeof(entry->shaders));
     entry->constant_version = 0;
     entry->shader_controlled_clip_distances = 0;
+    entry->link_pending = 0;
     entry->ps.np2_fixup_info = NULL;
     add_glsl_program_entry(priv, entry);
 
@@ -10303,9 +10678,8 @@ static HRESULT shader_glsl_compile_compute_shader(struct shader_glsl_priv *priv,
 
     list_add_head(&shader->linked_programs, &entry->cs.shader_entry);
 
-    TRACE("Linking GLSL shader program %u.\n", program_id);
-    GL_EXTCALL(glLinkProgram(program_id));
-    shader_glsl_validate_link(gl_info, program_id);
+    shader_glsl_link_program(priv, gl_info, entry, TRUE);
+    shader_glsl_finish_link(priv, gl_info, entry);
 
     GL_EXTCALL(glUseProgram(program_id));
     checkGLcall("glUseProgram");
@@ -10365,15 +10739,306 @@ static void set_glsl_compute_shader_program(const struct wined3d_context *contex
 }
 
 /* Context activation is done by the caller. */
-static void set_glsl_shader_program(const struct wined3d_context *context, const struct wined3d_state *state,
+static void shader_glsl_init_graphics_program(const struct wined3d_context *context,
+        struct shader_glsl_priv *priv, struct glsl_shader_prog_link *entry)
+{
+    struct wined3d_shader *vshader = entry->shaders[WINED3D_SHADER_TYPE_VERTEX];
+    struct wined3d_shader *hshader = entry->shaders[WINED3D_SHADER_TYPE_HULL];
+    struct wined3d_shader *dshader = entry->shaders[WINED3D_SHADER_TYPE_DOMAIN];
+    struct wined3d_shader *gshader = entry->shaders[WINED3D_SHADER_TYPE_GEOMETRY];
+    struct wined3d_shader *pshader = entry->shaders[WINED3D_SHADER_TYPE_PIXEL];
+    const struct wined3d_gl_info *gl_info = context->gl_info;
+    const struct wined3d_shader *pre_rasterization_shader;
+    GLuint program_id = entry->id;
+    unsigned int i;
+
+    shader_glsl_finish_link(priv, gl_info, entry);
+    entry->link_pending = 0;
+
+    shader_glsl_init_vs_uniform_locations(gl_info, priv, program_id, &entry->vs,
+            vshader ? vshader->limits->constant_float : 0);
+    shader_glsl_init_ds_uniform_locations(gl_info, priv, program_id, &entry->ds);
+    shader_glsl_init_gs_uniform_locations(gl_info, priv, program_id, &entry->gs);
+    shader_glsl_init_ps_uniform_locations(gl_info, priv, program_id, &entry->ps,
+            pshader ? pshader->limits->constant_float : 0);
+    checkGLcall("find glsl program uniform locations");
+
+    pre_rasterization_shader = gshader ? gshader : dshader ? dshader : vshader;
+    if (pre_rasterization_shader && pre_rasterization_shader->reg_maps.shader_version.major >= 4)
+    {
+        unsigned int clip_distance_count = wined3d_popcount(pre_rasterization_shader->reg_maps.clip_distance_mask);
+        entry->shader_controlled_clip_distances = 1;
+        entry->clip_distance_mask = (1u << clip_distance_count) - 1;
+    }
+
+    if (needs_legacy_glsl_syntax(gl_info))
+    {
+        if (pshader && pshader->reg_maps.shader_version.major >= 3
+                && pshader->u.ps.declared_in_count > vec4_varyings(3, gl_info))
+        {
+            TRACE("Shader %d needs vertex color clamping disabled.\n", program_id);
+            entry->vs.vertex_color_clamp = GL_FALSE;
+        }
+        else
+        {
+            entry->vs.vertex_color_clamp = GL_FIXED_ONLY_ARB;
+        }
+    }
+    else
+    {
+        /* With core profile we never change vertex_color_clamp from
+         * GL_FIXED_ONLY_MODE (which is also the initial value) so we never call
+         * glClampColorARB(). */
+        entry->vs.vertex_color_clamp = GL_FIXED_ONLY_ARB;
+    }
+
+    /* Set the shader to allow uniform loading on it */
+    GL_EXTCALL(glUseProgram(program_id));
+    checkGLcall("glUseProgram");
+
+    entry->constant_update_mask = 0;
+    if (vshader)
+    {
+        entry->constant_update_mask |= WINED3D_SHADER_CONST_VS_F;
+        if (vshader->reg_maps.integer_constants)
+            entry->constant_update_mask |= WINED3D_SHADER_CONST_VS_I;
+        if (vshader->reg_maps.boolean_constants)
+            entry->constant_update_mask |= WINED3D_SHADER_CONST_VS_B;
+        if (entry->vs.pos_fixup_location != -1)
+            entry->constant_update_mask |= WINED3D_SHADER_CONST_POS_FIXUP;
+
+        shader_glsl_load_program_resources(context, priv, program_id, vshader);
+    }
+    else
+    {
+        entry->constant_update_mask |= WINED3D_SHADER_CONST_FFP_MODELVIEW
+                | WINED3D_SHADER_CONST_FFP_PROJ;
+
+        for (i = 1; i < MAX_VERTEX_BLENDS; ++i)
+        {
+            if (entry->vs.modelview_matrix_location[i] != -1)
+            {
+                entry->constant_update_mask |= WINED3D_SHADER_CONST_FFP_VERTEXBLEND;
+                break;
+            }
+        }
+
+        for (i = 0; i < MAX_TEXTURES; ++i)
+        {
+            if (entry->vs.texture_matrix_location[i] != -1)
+            {
+                entry->constant_update_mask |= WINED3D_SHADER_CONST_FFP_TEXMATRIX;
+                break;
+            }
+        }
+        if (entry->vs.material_ambient_location != -1 || entry->vs.material_diffuse_location != -1
+                || entry->vs.material_specular_location != -1
+                || entry->vs.material_emissive_location != -1
+                || entry->vs.material_shininess_location != -1)
+            entry->constant_update_mask |= WINED3D_SHADER_CONST_FFP_MATERIAL;
+        if (entry->vs.light_ambient_location != -1)
+            entry->constant_update_mask |= WINED3D_SHADER_CONST_FFP_LIGHTS;
+    }
+    if (entry->vs.clip_planes_location != -1)
+        entry->constant_update_mask |= WINED3D_SHADER_CONST_VS_CLIP_PLANES;
+    if (entry->vs.pointsize_min_location != -1)
+        entry->constant_update_mask |= WINED3D_SHADER_CONST_VS_POINTSIZE;
+
+    if (hshader)
+        shader_glsl_load_program_resources(context, priv, program_id, hshader);
+
+    if (dshader)
+    {
+        if (entry->ds.pos_fixup_location != -1)
+            entry->constant_update_mask |= WINED3D_SHADER_CONST_POS_FIXUP;
+
+        shader_glsl_load_program_resources(context, priv, program_id, dshader);
+    }
+
+    if (gshader)
+    {
+        if (entry->gs.pos_fixup_location != -1)
+            entry->constant_update_mask |= WINED3D_SHADER_CONST_POS_FIXUP;
+
+        shader_glsl_load_program_resources(context, priv, program_id, gshader);
+    }
+
+    if (entry->ps.id)
+    {
+        if (pshader)
+        {
+            entry->constant_update_mask |= WINED3D_SHADER_CONST_PS_F;
+            if (pshader->reg_maps.integer_constants)
+                entry->constant_update_mask |= WINED3D_SHADER_CONST_PS_I;
+            if (pshader->reg_maps.boolean_constants)
+                entry->constant_update_mask |= WINED3D_SHADER_CONST_PS_B;
+            if (entry->ps.ycorrection_location != -1)
+                entry->constant_update_mask |= WINED3D_SHADER_CONST_PS_Y_CORR;
+
+            shader_glsl_load_program_resources(context, priv, program_id, pshader);
+            shader_glsl_load_images(gl_info, priv, program_id, &pshader->reg_maps);
+        }
+        else
+        {
+            entry->constant_update_mask |= WINED3D_SHADER_CONST_FFP_PS;
+
+            shader_glsl_load_samplers(context, priv, program_id, NULL);
+        }
+
+        for (i = 0; i < MAX_TEXTURES; ++i)
+        {
+            if (entry->ps.bumpenv_mat_location[i] != -1)
+            {
+                entry->constant_update_mask |= WINED3D_SHADER_CONST_PS_BUMP_ENV;
+                break;
+            }
+        }
+
+        if (entry->ps.fog_color_location != -1)
+            entry->constant_update_mask |= WINED3D_SHADER_CONST_PS_FOG;
+        if (entry->ps.alpha_test_ref_location != -1)
+            entry->constant_update_mask |= WINED3D_SHADER_CONST_PS_ALPHA_TEST;
+        if (entry->ps.np2_fixup_location != -1)
+            entry->constant_update_mask |= WINED3D_SHADER_CONST_PS_NP2_FIXUP;
+        if (entry->ps.color_key_location != -1)
+            entry->constant_update_mask |= WINED3D_SHADER_CONST_FFP_COLOR_KEY;
+    }
+}
+
+static const struct vs_compile_args *shader_glsl_get_vs_compile_args(const struct wined3d_shader *shader, GLuint id)
+{
+    const struct glsl_shader_private *shader_data = shader->backend_data;
+    unsigned int i;
+
+    for (i = 0; i < shader_data->num_gl_shaders; ++i)
+    {
+        if (shader_data->gl_shaders.vs[i].id == id)
+            return &shader_data->gl_shaders.vs[i].args;
+    }
+
+    return NULL;
+}
+
+static const struct ps_compile_args *shader_glsl_get_ps_compile_args(const struct wined3d_shader *shader, GLuint id)
+{
+    const struct glsl_shader_private *shader_data = shader->backend_data;
+    unsigned int i;
+
+    for (i = 0; i < shader_data->num_gl_shaders; ++i)
+    {
+        if (shader_data->gl_shaders.ps[i].id == id)
+            return &shader_data->gl_shaders.ps[i].args;
+    }
+
+    return NULL;
+}
+
+/* A variant may differ in compile args that only affect the rendering
+ * results, like fog or alpha test, but not in the ones that change the
+ * interface of the program. Sampling a texture through a sampler of the
+ * wrong type or shadowness is a GL error, and a different attribute
+ * swizzle reads the wrong vertex attributes. Pixel shader outputs are
+ * always declared as vec4, so they don't depend on the render targets. */
+static BOOL shader_glsl_is_program_variant(const struct glsl_shader_prog_link *candidate,
+        const struct glsl_shader_prog_link *program)
+{
+    const struct vs_compile_args *vs_args, *candidate_vs_args;
+    const struct ps_compile_args *ps_args, *candidate_ps_args;
+    const struct wined3d_shader *vs, *ps;
+
+    if (candidate == program || candidate->link_pending || candidate->cs.id)
+        return FALSE;
+    /* Fixed function replacement shaders depend on the fixed function
+     * settings rather than on a shader object, so programs using them can't
+     * be told apart by their shaders. */
+    if (!(vs = program->shaders[WINED3D_SHADER_TYPE_VERTEX]) || !(ps = program->shaders[WINED3D_SHADER_TYPE_PIXEL]))
+        return FALSE;
+    if (!candidate->ps.id != !program->ps.id)
+        return FALSE;
+    if (memcmp(candidate->shaders, program->shaders, sizeof(program->shaders)))
+        return FALSE;
+
+    if (!(vs_args = shader_glsl_get_vs_compile_args(vs, program->vs.id))
+            || !(candidate_vs_args = shader_glsl_get_vs_compile_args(vs, candidate->vs.id))
+            || vs_args->swizzle_map != candidate_vs_args->swizzle_map)
+        return FALSE;
+
+    if (!(ps_args = shader_glsl_get_ps_compile_args(ps, program->ps.id))
+            || !(candidate_ps_args = shader_glsl_get_ps_compile_args(ps, candidate->ps.id)))
+        return FALSE;
+    return ps_args->tex_types == candidate_ps_args->tex_types && ps_args->shadow == candidate_ps_args->shadow;
+}
+
+/* Finds a linked program built from the same shaders as "program", but with
+ * different compile args. The program currently in use is the most likely
+ * candidate. */
+static struct glsl_shader_prog_link *shader_glsl_find_fallback_program(const struct glsl_context_data *ctx_data,
+        const struct glsl_shader_prog_link *program, struct wined3d_shader *vshader)
+{
+    struct glsl_shader_prog_link *candidate;
+
+    if ((candidate = ctx_data->glsl_program) && shader_glsl_is_program_variant(candidate, program))
+        return candidate;
+
+    if (!vshader)
+        return NULL;
+
+    LIST_FOR_EACH_ENTRY(candidate, &vshader->linked_programs, struct glsl_shader_prog_link, vs.shader_entry)
+    {
+        if (shader_glsl_is_program_variant(candidate, program))
+            return candidate;
+    }
+
+    return NULL;
+}
+
+/* Returns the program to draw with. If the link of "entry" is still in
+ * progress, a variant of it is used instead of waiting for the link to
+ * complete, and the selection is retried on the next draw.
+ *
+ * Context activation is done by the caller. */
+static struct glsl_shader_prog_link *shader_glsl_get_linked_program(struct wined3d_context *context,
+        struct shader_glsl_priv *priv, struct glsl_context_data *ctx_data,
+        struct glsl_shader_prog_link *entry, struct wined3d_shader *vshader)
+{
+    const struct wined3d_gl_info *gl_info = context->gl_info;
+    struct glsl_shader_prog_link *fallback;
+    GLint complete;
+
+    ctx_data->pending_program = NULL;
+    context->shader_link_pending = 0;
+
+    if (!entry || !entry->link_pending)
+        return entry;
+
+    if (gl_info->supported[ARB_PARALLEL_SHADER_COMPILE])
+    {
+        GL_EXTCALL(glGetProgramiv(entry->id, GL_COMPLETION_STATUS_ARB, &complete));
+        checkGLcall("glGetProgramiv");
+        if (!complete && (fallback = shader_glsl_find_fallback_program(ctx_data, entry, vshader)))
+        {
+            TRACE("Program %u is still being linked, using program %u.\n", entry->id, fallback->id);
+            ctx_data->pending_program = entry;
+            context->shader_link_pending = 1;
+            ++context->device->shader_stalls_avoided;
+            return fallback;
+        }
+    }
+
+    shader_glsl_init_graphics_program(context, priv, entry);
+    return entry;
+}
+
+/* Context activation is done by the caller. */
+static void set_glsl_shader_program(struct wined3d_context *context, const struct wined3d_state *state,
         struct shader_glsl_priv *priv, struct glsl_context_data *ctx_data)
 {
     const struct wined3d_d3d_info *d3d_info = context->d3d_info;
     const struct wined3d_gl_info *gl_info = context->gl_info;
-    const struct wined3d_shader *pre_rasterization_shader;
     const struct ps_np2fixup_info *np2fixup_info = NULL;
     struct wined3d_shader *hshader, *dshader, *gshader;
     struct glsl_shader_prog_link *entry = NULL;
+    struct glsl_shader_prog_link *current;
     struct wined3d_shader *vshader = NULL;
     struct wined3d_shader *pshader = NULL;
     GLuint reorder_shader_id = 0;
@@ -10389,10 +11054,14 @@ static void set_glsl_shader_program(const struct wined3d_context *context, const
     WORD attribs_map;
     struct wined3d_string_buffer *tmp_name;
 
-    if (!(context->shader_update_mask & (1u << WINED3D_SHADER_TYPE_VERTEX)) && ctx_data->glsl_program)
+    /* Stages that didn't change are taken from the program being linked, if
+     * any, rather than from its fallback. */
+    current = ctx_data->pending_program ? ctx_data->pending_program : ctx_data->glsl_program;
+
+    if (!(context->shader_update_mask & (1u << WINED3D_SHADER_TYPE_VERTEX)) && current)
     {
-        vs_id = ctx_data->glsl_program->vs.id;
-        vs_list = &ctx_data->glsl_program->vs.shader_entry;
+        vs_id = current->vs.id;
+        vs_list = &current->vs.shader_entry;
 
         if (use_vs(state))
             vshader = state->shader[WINED3D_SHADER_TYPE_VERTEX];
@@ -10419,15 +11088,15 @@ static void set_glsl_shader_program(const struct wined3d_context *context, const
     }
 
     hshader = state->shader[WINED3D_SHADER_TYPE_HULL];
-    if (!(context->shader_update_mask & (1u << WINED3D_SHADER_TYPE_HULL)) && ctx_data->glsl_program)
-        hs_id = ctx_data->glsl_program->hs.id;
+    if (!(context->shader_update_mask & (1u << WINED3D_SHADER_TYPE_HULL)) && current)
+        hs_id = current->hs.id;
     else if (hshader)
         hs_id = find_glsl_hull_shader(context, priv, hshader);
 
     dshader = state->shader[WINED3D_SHADER_TYPE_DOMAIN];
-    if (!(context->shader_update_mask & (1u << WINED3D_SHADER_TYPE_DOMAIN)) && ctx_data->glsl_program)
+    if (!(context->shader_update_mask & (1u << WINED3D_SHADER_TYPE_DOMAIN)) && current)
     {
-        ds_id = ctx_data->glsl_program->ds.id;
+        ds_id = current->ds.id;
     }
     else if (dshader)
     {
@@ -10438,9 +11107,9 @@ static void set_glsl_shader_program(const struct wined3d_context *context, const
     }
 
     gshader = state->shader[WINED3D_SHADER_TYPE_GEOMETRY];
-    if (!(context->shader_update_mask & (1u << WINED3D_SHADER_TYPE_GEOMETRY)) && ctx_data->glsl_program)
+    if (!(context->shader_update_mask & (1u << WINED3D_SHADER_TYPE_GEOMETRY)) && current)
     {
-        gs_id = ctx_data->glsl_program->gs.id;
+        gs_id = current->gs.id;
     }
     else if (gshader)
     {
@@ -10456,10 +11125,10 @@ static void set_glsl_shader_program(const struct wined3d_context *context, const
         ps_id = 0;
         ps_list = NULL;
     }
-    else if (!(context->shader_update_mask & (1u << WINED3D_SHADER_TYPE_PIXEL)) && ctx_data->glsl_program)
+    else if (!(context->shader_update_mask & (1u << WINED3D_SHADER_TYPE_PIXEL)) && current)
     {
-        ps_id = ctx_data->glsl_program->ps.id;
-        ps_list = &ctx_data->glsl_program->ps.shader_entry;
+        ps_id = current->ps.id;
+        ps_list = &current->ps.shader_entry;
 
         if (use_ps(state))
             pshader = state->shader[WINED3D_SHADER_TYPE_PIXEL];
@@ -10493,7 +11162,7 @@ static void set_glsl_shader_program(const struct wined3d_context *context, const
     key.cs_id = 0;
     if ((!vs_id && !hs_id && !ds_id && !gs_id && !ps_id) || (entry = get_glsl_program_entry(priv, &key)))
     {
-        ctx_data->glsl_program = entry;
+        ctx_data->glsl_program = shader_glsl_get_linked_program(context, priv, ctx_data, entry, vshader);
         return;
     }
 
@@ -10510,15 +11179,18 @@ static void set_glsl_shader_program(const struct wined3d_context *context, const
     entry->gs.id = gs_id;
     entry->ps.id = ps_id;
     entry->cs.id = 0;
+    entry->shaders[WINED3D_SHADER_TYPE_PIXEL] = pshader;
+    entry->shaders[WINED3D_SHADER_TYPE_VERTEX] = vshader;
+    entry->shaders[WINED3D_SHADER_TYPE_GEOMETRY] = gshader;
+    entry->shaders[WINED3D_SHADER_TYPE_HULL] = hshader;
+    entry->shaders[WINED3D_SHADER_TYPE_DOMAIN] = dshader;
     entry->constant_version = 0;
     entry->shader_controlled_clip_distances = 0;
+    entry->link_pending = 1;
     entry->ps.np2_fixup_info = np2fixup_info;
     /* Add the hash table entry */
     add_glsl_program_entry(priv, entry);
 
-    /* Set the current program */
-    ctx_data->glsl_program = entry;
-
     /* Attach GLSL vshader */
     if (vs_id)
     {
@@ -10631,159 +11303,11 @@ static void set_glsl_shader_program(const struct wined3d_context *context, const
         list_add_head(ps_list, &entry->ps.shader_entry);
     }
 
-    /* Link the program */
-    TRACE("Linking GLSL shader program %u.\n", program_id);
-    GL_EXTCALL(glLinkProgram(program_id));
-    shader_glsl_validate_link(gl_info, program_id);
-
-    shader_glsl_init_vs_uniform_locations(gl_info, priv, program_id, &entry->vs,
-            vshader ? vshader->limits->constant_float : 0);
-    shader_glsl_init_ds_uniform_locations(gl_info, priv, program_id, &entry->ds);
-    shader_glsl_init_gs_uniform_locations(gl_info, priv, program_id, &entry->gs);
-    shader_glsl_init_ps_uniform_locations(gl_info, priv, program_id, &entry->ps,
-            pshader ? pshader->limits->constant_float : 0);
-    checkGLcall("find glsl program uniform locations");
+    /* Link the program. Transform feedback varyings aren't part of the
+     * shader source, so programs using stream output aren't cached. */
+    shader_glsl_link_program(priv, gl_info, entry, !gshader || !gshader->u.gs.so_desc.element_count);
 
-    pre_rasterization_shader = gshader ? gshader : dshader ? dshader : vshader;
-    if (pre_rasterization_shader && pre_rasterization_shader->reg_maps.shader_version.major >= 4)
-    {
-        unsigned int clip_distance_count = wined3d_popcount(pre_rasterization_shader->reg_maps.clip_distance_mask);
-        entry->shader_controlled_clip_distances = 1;
-        entry->clip_distance_mask = (1u << clip_distance_count) - 1;
-    }
-
-    if (needs_legacy_glsl_syntax(gl_info))
-    {
-        if (pshader && pshader->reg_maps.shader_version.major >= 3
-                && pshader->u.ps.declared_in_count > vec4_varyings(3, gl_info))
-        {
-            TRACE("Shader %d needs vertex color clamping disabled.\n", program_id);
-            entry->vs.vertex_color_clamp = GL_FALSE;
-        }
-        else
-        {
-            entry->vs.vertex_color_clamp = GL_FIXED_ONLY_ARB;
-        }
-    }
-    else
-    {
-        /* With core profile we never change vertex_color_clamp from
-         * GL_FIXED_ONLY_MODE (which is also the initial value) so we never call
-         * glClampColorARB(). */
-        entry->vs.vertex_color_clamp = GL_FIXED_ONLY_ARB;
-    }
-
-    /* Set the shader to allow uniform loading on it */
-    GL_EXTCALL(glUseProgram(program_id));
-    checkGLcall("glUseProgram");
-
-    entry->constant_update_mask = 0;
-    if (vshader)
-    {
-        entry->constant_update_mask |= WINED3D_SHADER_CONST_VS_F;
-        if (vshader->reg_maps.integer_constants)
-            entry->constant_update_mask |= WINED3D_SHADER_CONST_VS_I;
-        if (vshader->reg_maps.boolean_constants)
-            entry->constant_update_mask |= WINED3D_SHADER_CONST_VS_B;
-        if (entry->vs.pos_fixup_location != -1)
-            entry->constant_update_mask |= WINED3D_SHADER_CONST_POS_FIXUP;
-
-        shader_glsl_load_program_resources(context, priv, program_id, vshader);
-    }
-    else
-    {
-        entry->constant_update_mask |= WINED3D_SHADER_CONST_FFP_MODELVIEW
-                | WINED3D_SHADER_CONST_FFP_PROJ;
-
-        for (i = 1; i < MAX_VERTEX_BLENDS; ++i)
-        {
-            if (entry->vs.modelview_matrix_location[i] != -1)
-            {
-                entry->constant_update_mask |= WINED3D_SHADER_CONST_FFP_VERTEXBLEND;
-                break;
-            }
-        }
-
-        for (i = 0; i < MAX_TEXTURES; ++i)
-        {
-            if (entry->vs.texture_matrix_location[i] != -1)
-            {
-                entry->constant_update_mask |= WINED3D_SHADER_CONST_FFP_TEXMATRIX;
-                break;
-            }
-        }
-        if (entry->vs.material_ambient_location != -1 || entry->vs.material_diffuse_location != -1
-                || entry->vs.material_specular_location != -1
-                || entry->vs.material_emissive_location != -1
-                || entry->vs.material_shininess_location != -1)
-            entry->constant_update_mask |= WINED3D_SHADER_CONST_FFP_MATERIAL;
-        if (entry->vs.light_ambient_location != -1)
-            entry->constant_update_mask |= WINED3D_SHADER_CONST_FFP_LIGHTS;
-    }
-    if (entry->vs.clip_planes_location != -1)
-        entry->constant_update_mask |= WINED3D_SHADER_CONST_VS_CLIP_PLANES;
-    if (entry->vs.pointsize_min_location != -1)
-        entry->constant_update_mask |= WINED3D_SHADER_CONST_VS_POINTSIZE;
-
-    if (hshader)
-        shader_glsl_load_program_resources(context, priv, program_id, hshader);
-
-    if (dshader)
-    {
-        if (entry->ds.pos_fixup_location != -1)
-            entry->constant_update_mask |= WINED3D_SHADER_CONST_POS_FIXUP;
-
-        shader_glsl_load_program_resources(context, priv, program_id, dshader);
-    }
-
-    if (gshader)
-    {
-        if (entry->gs.pos_fixup_location != -1)
-            entry->constant_update_mask |= WINED3D_SHADER_CONST_POS_FIXUP;
-
-        shader_glsl_load_program_resources(context, priv, program_id, gshader);
-    }
-
-    if (ps_id)
-    {
-        if (pshader)
-        {
-            entry->constant_update_mask |= WINED3D_SHADER_CONST_PS_F;
-            if (pshader->reg_maps.integer_constants)
-                entry->constant_update_mask |= WINED3D_SHADER_CONST_PS_I;
-            if (pshader->reg_maps.boolean_constants)
-                entry->constant_update_mask |= WINED3D_SHADER_CONST_PS_B;
-            if (entry->ps.ycorrection_location != -1)
-                entry->constant_update_mask |= WINED3D_SHADER_CONST_PS_Y_CORR;
-
-            shader_glsl_load_program_resources(context, priv, program_id, pshader);
-            shader_glsl_load_images(gl_info, priv, program_id, &pshader->reg_maps);
-        }
-        else
-        {
-            entry->constant_update_mask |= WINED3D_SHADER_CONST_FFP_PS;
-
-            shader_glsl_load_samplers(context, priv, program_id, NULL);
-        }
-
-        for (i = 0; i < MAX_TEXTURES; ++i)
-        {
-            if (entry->ps.bumpenv_mat_location[i] != -1)
-            {
-                entry->constant_update_mask |= WINED3D_SHADER_CONST_PS_BUMP_ENV;
-                break;
-            }
-        }
-
-        if (entry->ps.fog_color_location != -1)
-            entry->constant_update_mask |= WINED3D_SHADER_CONST_PS_FOG;
-        if (entry->ps.alpha_test_ref_location != -1)
-            entry->constant_update_mask |= WINED3D_SHADER_CONST_PS_ALPHA_TEST;
-        if (entry->ps.np2_fixup_location != -1)
-            entry->constant_update_mask |= WINED3D_SHADER_CONST_PS_NP2_FIXUP;
-        if (entry->ps.color_key_location != -1)
-            entry->constant_update_mask |= WINED3D_SHADER_CONST_FFP_COLOR_KEY;
-    }
+    ctx_data->glsl_program = shader_glsl_get_linked_program(context, priv, ctx_data, entry, vshader);
 }
 
 static void shader_glsl_precompile(void *shader_priv, struct wined3d_shader *shader)
@@ -10892,6 +11416,8 @@ static void shader_glsl_invalidate_current_program(struct wined3d_context *conte
     struct glsl_context_data *ctx_data = context->shader_backend_data;
 
     ctx_data->glsl_program = NULL;
+    ctx_data->pending_program = NULL;
+    context->shader_link_pending = 0;
     context->shader_update_mask = (1u << WINED3D_SHADER_TYPE_PIXEL)
             | (1u << WINED3D_SHADER_TYPE_VERTEX)
             | (1u << WINED3D_SHADER_TYPE_GEOMETRY)
@@ -10934,7 +11460,7 @@ static void shader_glsl_invalidate_contexts_program(struct wined3d_device *devic
         context = device->contexts[i];
         ctx_data = context->shader_backend_data;
 
-        if (ctx_data->glsl_program == program)
+        if (ctx_data->glsl_program == program || ctx_data->pending_program == program)
             shader_glsl_invalidate_current_program(context);
     }
 }
@@ -11250,6 +11776,11 @@ static void shader_glsl_free(struct wined3d_device *device)
 {
     struct shader_glsl_priv *priv = device->shader_priv;
 
+    if (priv->program_cache.enabled)
+        TRACE("Program binary cache: %u hits, %u misses, %u rejects, %u stores, %s bytes used.\n",
+                priv->program_cache.hits, priv->program_cache.misses, priv->program_cache.rejects,
+                priv->program_cache.stores, wine_dbgstr_longlong(priv->program_cache.size));
+
     wine_rb_destroy(&priv->program_lookup, NULL, NULL);
     constant_heap_free(&priv->pconst_heap);
     constant_heap_free(&priv->vconst_heap);
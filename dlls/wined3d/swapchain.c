@@ -486,6 +486,12 @@ static void swapchain_gl_present(struct wined3d_swapchain *swapchain,
     wined3d_swapchain_rotate(swapchain, context);
 
     TRACE("SwapBuffers called, Starting new frame\n");
+    if (swapchain->device->shader_stalls_avoided)
+    {
+        TRACE("%u draws used a fallback program instead of waiting for a link.\n",
+                swapchain->device->shader_stalls_avoided);
+        swapchain->device->shader_stalls_avoided = 0;
+    }
     /* FPS support */
     if (TRACE_ON(fps))
     {
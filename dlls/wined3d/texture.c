@@ -29,6 +29,8 @@ WINE_DECLARE_DEBUG_CHANNEL(d3d_perf);
 WINE_DECLARE_DEBUG_CHANNEL(winediag);
 
 #define WINED3D_TEXTURE_DYNAMIC_MAP_THRESHOLD 50
+#define WINED3D_TEXTURE_CONVERT_BAND_SIZE 0x10000
+#define WINED3D_TEXTURE_CONVERT_MAX_WORKERS 3
 
 struct wined3d_texture_idx
 {
@@ -36,6 +38,31 @@ struct wined3d_texture_idx
     unsigned int sub_resource_idx;
 };
 
+typedef void (*wined3d_texture_convert_func)(const BYTE *src, BYTE *dst,
+        unsigned int src_row_pitch, unsigned int src_slice_pitch,
+        unsigned int dst_row_pitch, unsigned dst_slice_pitch,
+        unsigned int width, unsigned int height, unsigned int depth);
+
+/* Shared between the CS thread and the threadpool workers helping it convert
+ * an upload. Each band is "band_height" rows of a single slice. Workers that
+ * only start after the conversion is done keep the structure alive through
+ * their reference, but find no band left to convert. */
+struct wined3d_texture_convert
+{
+    LONG refcount;
+    wined3d_texture_convert_func convert;
+    const BYTE *src;
+    BYTE *dst;
+    unsigned int src_row_pitch, src_slice_pitch;
+    unsigned int dst_row_pitch, dst_slice_pitch;
+    unsigned int width, height, depth;
+    unsigned int src_block_height;
+    unsigned int band_height, slice_band_count, band_count;
+    LONG next_band;
+    LONG done_bands;
+    HANDLE event;
+};
+
 struct wined3d_rect_f
 {
     float l;
@@ -1892,6 +1919,162 @@ HRESULT CDECL wined3d_texture_add_dirty_region(struct wined3d_texture *texture,
     return WINED3D_OK;
 }
 
+static void wined3d_texture_convert_release(struct wined3d_texture_convert *c)
+{
+    if (InterlockedDecrement(&c->refcount))
+        return;
+
+    CloseHandle(c->event);
+    heap_free(c);
+}
+
+static void wined3d_texture_convert_bands(struct wined3d_texture_convert *c)
+{
+    unsigned int band, y, z, h;
+    LONG idx;
+
+    while ((idx = InterlockedIncrement(&c->next_band) - 1) < (LONG)c->band_count)
+    {
+        band = idx % c->slice_band_count;
+        z = idx / c->slice_band_count;
+        y = band * c->band_height;
+        h = min(c->band_height, c->height - y);
+
+        c->convert(c->src + z * c->src_slice_pitch + (y / c->src_block_height) * c->src_row_pitch,
+                c->dst + z * c->dst_slice_pitch + y * c->dst_row_pitch,
+                c->src_row_pitch, c->src_slice_pitch, c->dst_row_pitch, c->dst_slice_pitch, c->width, h, 1);
+
+        if (InterlockedIncrement(&c->done_bands) == (LONG)c->band_count)
+            SetEvent(c->event);
+    }
+}
+
+static void CALLBACK wined3d_texture_convert_worker(TP_CALLBACK_INSTANCE *instance, void *ctx)
+{
+    struct wined3d_texture_convert *c = ctx;
+
+    wined3d_texture_convert_bands(c);
+    wined3d_texture_convert_release(c);
+}
+
+/* Format conversion is pure CPU work that doesn't touch GL, so large uploads
+ * are split into row bands that threadpool workers convert alongside the CS
+ * thread. The CS thread converts every band no worker has claimed yet, and
+ * then only waits for the bands still being converted. Waiting for workers
+ * to start could stall rendering behind a busy threadpool, or deadlock if
+ * starting them needs a lock we hold. */
+static void wined3d_texture_convert_upload(wined3d_texture_convert_func convert, const BYTE *src, BYTE *dst,
+        unsigned int src_row_pitch, unsigned int src_slice_pitch, unsigned int dst_row_pitch,
+        unsigned int dst_slice_pitch, unsigned int width, unsigned int height, unsigned int depth,
+        unsigned int src_block_height)
+{
+    unsigned int band_height, slice_band_count, band_count;
+    struct wined3d_texture_convert *c;
+    unsigned int worker_count, i;
+    SYSTEM_INFO info;
+
+    band_height = WINED3D_TEXTURE_CONVERT_BAND_SIZE / max(dst_row_pitch, 1);
+    band_height = max(band_height - band_height % src_block_height, src_block_height);
+    slice_band_count = (height + band_height - 1) / band_height;
+    band_count = slice_band_count * depth;
+
+    GetSystemInfo(&info);
+    worker_count = min(min(band_count - 1, info.dwNumberOfProcessors - 1), WINED3D_TEXTURE_CONVERT_MAX_WORKERS);
+    /* New threadpool threads can't start while the loader lock is held. */
+    if (!worker_count || RtlIsCriticalSectionLockedByThread(NtCurrentTeb()->Peb->LoaderLock)
+            || !(c = heap_alloc(sizeof(*c))))
+    {
+        convert(src, dst, src_row_pitch, src_slice_pitch, dst_row_pitch, dst_slice_pitch, width, height, depth);
+        return;
+    }
+    if (!(c->event = CreateEventW(NULL, FALSE, FALSE, NULL)))
+    {
+        heap_free(c);
+        convert(src, dst, src_row_pitch, src_slice_pitch, dst_row_pitch, dst_slice_pitch, width, height, depth);
+        return;
+    }
+
+    TRACE("Converting %u bands of %u rows on %u workers.\n", band_count, band_height, worker_count);
+
+    c->refcount = worker_count + 1;
+    c->convert = convert;
+    c->src = src;
+    c->dst = dst;
+    c->src_row_pitch = src_row_pitch;
+    c->src_slice_pitch = src_slice_pitch;
+    c->dst_row_pitch = dst_row_pitch;
+    c->dst_slice_pitch = dst_slice_pitch;
+    c->width = width;
+    c->height = height;
+    c->depth = depth;
+    c->src_block_height = src_block_height;
+    c->band_height = band_height;
+    c->slice_band_count = slice_band_count;
+    c->band_count = band_count;
+    c->next_band = 0;
+    c->done_bands = 0;
+
+    for (i = 0; i < worker_count; ++i)
+    {
+        if (!TrySubmitThreadpoolCallback(wined3d_texture_convert_worker, c, NULL))
+        {
+            WARN("Failed to submit conversion work item.\n");
+            InterlockedDecrement(&c->refcount);
+        }
+    }
+
+    /* Every band has been claimed once this returns, and whoever converts the
+     * last one signals the event. */
+    wined3d_texture_convert_bands(c);
+    WaitForSingleObject(c->event, INFINITE);
+    wined3d_texture_convert_release(c);
+}
+
+/* Context activation is done by the caller. Returns a write-only mapping of
+ * the device's staging buffer object, bound to GL_PIXEL_UNPACK_BUFFER.
+ * Orphaning the storage on every use lets the driver keep earlier uploads
+ * from it in flight while we write the next one. */
+static BYTE *wined3d_texture_map_staging_bo(struct wined3d_device *device,
+        struct wined3d_context *context, unsigned int size)
+{
+    const struct wined3d_gl_info *gl_info = context->gl_info;
+    BYTE *mem;
+
+    if (!gl_info->supported[ARB_PIXEL_BUFFER_OBJECT] || !gl_info->supported[ARB_MAP_BUFFER_RANGE])
+        return NULL;
+
+    if (!device->staging_bo)
+    {
+        GL_EXTCALL(glGenBuffers(1, &device->staging_bo));
+        checkGLcall("glGenBuffers");
+        if (!device->staging_bo)
+            return NULL;
+        TRACE("Created staging buffer object %u.\n", device->staging_bo);
+    }
+
+    GL_EXTCALL(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, device->staging_bo));
+    GL_EXTCALL(glBufferData(GL_PIXEL_UNPACK_BUFFER, size, NULL, GL_STREAM_DRAW));
+    mem = GL_EXTCALL(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size,
+            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+    GL_EXTCALL(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+    checkGLcall("Map staging buffer object");
+
+    return mem;
+}
+
+/* Context activation is done by the caller. */
+void wined3d_texture_destroy_staging_bo(struct wined3d_device *device, struct wined3d_context *context)
+{
+    const struct wined3d_gl_info *gl_info = context->gl_info;
+
+    if (!device->staging_bo)
+        return;
+
+    GL_EXTCALL(glDeleteBuffers(1, &device->staging_bo));
+    checkGLcall("glDeleteBuffers");
+    device->staging_bo = 0;
+}
+
 /* This call just uploads data, the caller is responsible for binding the
  * correct texture. */
 /* Context activation is done by the caller. */
@@ -1965,6 +2148,9 @@ void wined3d_texture_upload_data(struct wined3d_texture *texture, unsigned int s
     {
         const struct wined3d_format *compressed_format = format;
         unsigned int dst_row_pitch, dst_slice_pitch;
+        unsigned int src_block_height = 1;
+        wined3d_texture_convert_func convert;
+        BYTE *dst_mem;
         void *src_mem;
 
         if (decompress)
@@ -1983,26 +2169,56 @@ void wined3d_texture_upload_data(struct wined3d_texture *texture, unsigned int s
 
         wined3d_format_calculate_pitch(format, 1, update_w, update_h, &dst_row_pitch, &dst_slice_pitch);
 
-        /* Note that uploading 3D textures may require quite some address
-         * space; it may make sense to upload them per-slice instead. */
-        if (!(converted_mem = heap_calloc(update_d, dst_slice_pitch)))
+        /* Convert straight into a staging buffer object where possible, so
+         * the GL upload doesn't need another copy of the data. Note that
+         * uploading 3D textures may require quite some address space; it may
+         * make sense to upload them per-slice instead. */
+        if (!(dst_mem = wined3d_texture_map_staging_bo(texture->resource.device,
+                context, update_d * dst_slice_pitch)))
         {
-            ERR("Failed to allocate upload buffer.\n");
-            return;
+            if (!(converted_mem = heap_calloc(update_d, dst_slice_pitch)))
+            {
+                ERR("Failed to allocate upload buffer.\n");
+                return;
+            }
+            dst_mem = converted_mem;
+        }
+
+        if (decompress)
+        {
+            convert = compressed_format->decompress;
+            src_block_height = compressed_format->block_height;
+        }
+        else
+        {
+            convert = format->upload;
         }
 
         src_mem = context_map_bo_address(context, &bo, src_slice_pitch,
                 GL_PIXEL_UNPACK_BUFFER, WINED3D_MAP_READ);
-        if (decompress)
-            compressed_format->decompress(src_mem, converted_mem, src_row_pitch, src_slice_pitch,
-                    dst_row_pitch, dst_slice_pitch, update_w, update_h, update_d);
+        if (update_d * dst_slice_pitch >= 2 * WINED3D_TEXTURE_CONVERT_BAND_SIZE
+                && !(format->flags[WINED3D_GL_RES_TYPE_TEX_2D] & WINED3DFMT_FLAG_HEIGHT_SCALE))
+            wined3d_texture_convert_upload(convert, src_mem, dst_mem, src_row_pitch, src_slice_pitch,
+                    dst_row_pitch, dst_slice_pitch, update_w, update_h, update_d, src_block_height);
         else
-            format->upload(src_mem, converted_mem, src_row_pitch, src_slice_pitch,
+            convert(src_mem, dst_mem, src_row_pitch, src_slice_pitch,
                     dst_row_pitch, dst_slice_pitch, update_w, update_h, update_d);
         context_unmap_bo_address(context, &bo, GL_PIXEL_UNPACK_BUFFER);
 
-        bo.buffer_object = 0;
-        bo.addr = converted_mem;
+        if (converted_mem)
+        {
+            bo.buffer_object = 0;
+            bo.addr = converted_mem;
+        }
+        else
+        {
+            GL_EXTCALL(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, texture->resource.device->staging_bo));
+            GL_EXTCALL(glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER));
+            GL_EXTCALL(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+            checkGLcall("Unmap staging buffer object");
+            bo.buffer_object = texture->resource.device->staging_bo;
+            bo.addr = NULL;
+        }
         src_row_pitch = dst_row_pitch;
         src_slice_pitch = dst_slice_pitch;
     }
@@ -91,6 +91,9 @@ struct wined3d_settings wined3d_settings =
     ~0U,            /* No PS shader model limit by default. */
     ~0u,            /* No CS shader model limit by default. */
     FALSE,          /* 3D support enabled by default. */
+    NULL,           /* Store program binaries in the default location. */
+    128,            /* Limit the program binary cache to 128 MiB. */
+    0,              /* Don't merge consecutive draws by default. */
 };
 
 struct wined3d * CDECL wined3d_create(DWORD flags)
@@ -313,6 +316,29 @@ static BOOL wined3d_dll_init(HINSTANCE hInstDLL)
             TRACE("Disabling 3D support.\n");
             wined3d_settings.no_3d = TRUE;
         }
+        if (!get_config_key(hkey, appkey, "ShaderCache", buffer, size))
+        {
+            size_t len = strlen(buffer) + 1;
+
+            if (!strcmp(buffer, "disabled"))
+            {
+                TRACE("Disabling the program binary cache.\n");
+                wined3d_settings.shader_cache_size = 0;
+            }
+            else if (!(wined3d_settings.shader_cache = heap_alloc(len)))
+                ERR("Failed to allocate shader cache path memory.\n");
+            else
+                memcpy(wined3d_settings.shader_cache, buffer, len);
+        }
+        /* ShaderCache="disabled" wins over any size limit. */
+        if (wined3d_settings.shader_cache_size
+                && !get_config_key_dword(hkey, appkey, "ShaderCacheSize", &wined3d_settings.shader_cache_size))
+            TRACE("Limiting the program binary cache to %u MiB.\n", wined3d_settings.shader_cache_size);
+        if (!get_config_key_dword(hkey, appkey, "DrawBatchSize", &wined3d_settings.draw_batch_size))
+        {
+            wined3d_settings.draw_batch_size = min(wined3d_settings.draw_batch_size, WINED3D_MAX_DRAW_BATCH_SIZE);
+            ERR_(winediag)("Merging up to %u consecutive draws.\n", wined3d_settings.draw_batch_size);
+        }
     }
 
     if (appkey) RegCloseKey( appkey );
@@ -344,6 +370,7 @@ static BOOL wined3d_dll_destroy(HINSTANCE hInstDLL)
     }
     heap_free(wndproc_table.entries);
 
+    heap_free(wined3d_settings.shader_cache);
     heap_free(wined3d_settings.logo);
     UnregisterClassA(WINED3D_OPENGL_WINDOW_CLASS_NAME, hInstDLL);
 
@@ -388,6 +388,9 @@ struct wined3d_settings
     unsigned int max_sm_ps;
     unsigned int max_sm_cs;
     BOOL no_3d;
+    char *shader_cache;
+    unsigned int shader_cache_size;
+    unsigned int draw_batch_size;
 };
 
 extern struct wined3d_settings wined3d_settings DECLSPEC_HIDDEN;
@@ -1525,6 +1528,16 @@ struct wined3d_indirect_draw_parameters
     unsigned int offset;
 };
 
+#define WINED3D_MAX_DRAW_BATCH_SIZE 64
+
+/* Consecutive indexed draws that share all state except for their index
+ * range and base vertex. */
+struct wined3d_draw_batch
+{
+    unsigned int count;
+    struct wined3d_direct_draw_parameters draws[WINED3D_MAX_DRAW_BATCH_SIZE];
+};
+
 struct wined3d_draw_parameters
 {
     BOOL indirect;
@@ -1534,6 +1547,7 @@ struct wined3d_draw_parameters
         struct wined3d_indirect_draw_parameters indirect;
     } u;
     BOOL indexed;
+    const struct wined3d_draw_batch *batch;
 };
 
 void draw_primitive(struct wined3d_device *device, const struct wined3d_state *state,
@@ -1842,15 +1856,10 @@ struct wined3d_context
     const struct wined3d_gl_info *gl_info;
     const struct wined3d_d3d_info *d3d_info;
     const struct StateEntry *state_table;
-    /* State dirtification
-     * dirtyArray is an array that contains markers for dirty states. numDirtyEntries states are dirty, their numbers are in indices
-     * 0...numDirtyEntries - 1. isStateDirty is a redundant copy of the dirtyArray. Technically only one of them would be needed,
-     * but with the help of both it is easy to find out if a state is dirty(just check the array index), and for applying dirty states
-     * only numDirtyEntries array elements have to be checked, not STATE_HIGHEST states.
-     */
-    DWORD                   dirtyArray[STATE_HIGHEST + 1]; /* Won't get bigger than that, a state is never marked dirty 2 times */
-    DWORD                   numDirtyEntries;
-    DWORD isStateDirty[STATE_HIGHEST / (sizeof(DWORD) * CHAR_BIT) + 1]; /* Bitmap to find out quickly if a state is dirty */
+    /* State dirtification. Dirty graphics states are tracked only by their
+     * representative's bit; context_apply_draw_state() finds them by
+     * scanning the bitmap a word at a time, skipping clean words. */
+    unsigned int dirty_graphics_states[STATE_HIGHEST / (sizeof(unsigned int) * CHAR_BIT) + 1];
     unsigned int dirty_compute_states[STATE_COMPUTE_COUNT / (sizeof(unsigned int) * CHAR_BIT) + 1];
 
     struct wined3d_device *device;
@@ -1902,7 +1911,8 @@ struct wined3d_context
     DWORD shader_update_mask : 6; /* WINED3D_SHADER_TYPE_COUNT, 6 */
     DWORD clip_distance_mask : 8; /* MAX_CLIP_DISTANCES, 8 */
     DWORD num_untracked_materials : 2;  /* Max value 2 */
-    DWORD padding : 7;
+    DWORD shader_link_pending : 1;
+    DWORD padding : 6;
 
     DWORD constant_update_mask;
     DWORD numbered_array_mask;
@@ -2952,6 +2962,35 @@ struct wined3d_vr_gl_context
     const struct wined3d_gl_info *gl_info;
 };
 
+#define WINED3D_UPLOAD_RING_SIZE            (16 * 1024 * 1024)
+#define WINED3D_UPLOAD_RING_MAX_FENCES      16
+
+/* A persistently mapped buffer object that the application thread writes
+ * DISCARD buffer maps into directly. The CS thread copies each region into
+ * its destination buffer and fences it; "tail" trails "head" by the amount of
+ * memory the GPU may still be reading from. */
+struct wined3d_upload_ring
+{
+    GLuint buffer_object;
+    BYTE *map_ptr;
+    unsigned int size;
+
+    /* Application thread. */
+    unsigned int head;
+    unsigned int allocations, full;
+
+    /* CS thread. */
+    LONG tail;
+    unsigned int submitted;
+    unsigned int fenced;
+    struct
+    {
+        GLsync sync;
+        unsigned int position;
+    } fences[WINED3D_UPLOAD_RING_MAX_FENCES];
+    unsigned int fence_start, fence_count;
+};
+
 struct wined3d_device
 {
     LONG ref;
@@ -2973,6 +3012,8 @@ struct wined3d_device
     /* Array of functions for states which are handled by more than one pipeline part */
     APPLYSTATEFUNC *multistate_funcs[STATE_HIGHEST + 1];
     struct wined3d_blitter *blitter;
+    /* Draws this frame that used a fallback program instead of waiting for a link. */
+    unsigned int shader_stalls_avoided;
 
     BYTE bCursorVisible : 1;
     BYTE d3d_initialized : 1;
@@ -3025,6 +3066,9 @@ struct wined3d_device
     struct wined3d_sampler *default_sampler;
     struct wined3d_sampler *null_sampler;
 
+    struct wined3d_upload_ring upload_ring;
+    GLuint staging_bo;
+
     /* Command stream */
     struct wined3d_cs *cs;
 
@@ -3051,9 +3095,9 @@ void device_invalidate_state(const struct wined3d_device *device, DWORD state) D
 
 static inline BOOL isStateDirty(const struct wined3d_context *context, DWORD state)
 {
-    DWORD idx = state / (sizeof(*context->isStateDirty) * CHAR_BIT);
-    BYTE shift = state & ((sizeof(*context->isStateDirty) * CHAR_BIT) - 1);
-    return context->isStateDirty[idx] & (1u << shift);
+    DWORD idx = state / (sizeof(*context->dirty_graphics_states) * CHAR_BIT);
+    BYTE shift = state & ((sizeof(*context->dirty_graphics_states) * CHAR_BIT) - 1);
+    return context->dirty_graphics_states[idx] & (1u << shift);
 }
 
 const char *wined3d_debug_resource_access(DWORD access) DECLSPEC_HIDDEN;
@@ -3350,6 +3394,8 @@ void wined3d_texture_bind_and_dirtify(struct wined3d_texture *texture,
         struct wined3d_context *context, BOOL srgb) DECLSPEC_HIDDEN;
 HRESULT wined3d_texture_check_box_dimensions(const struct wined3d_texture *texture,
         unsigned int level, const struct wined3d_box *box) DECLSPEC_HIDDEN;
+void wined3d_texture_destroy_staging_bo(struct wined3d_device *device,
+        struct wined3d_context *context) DECLSPEC_HIDDEN;
 GLenum wined3d_texture_get_gl_buffer(const struct wined3d_texture *texture) DECLSPEC_HIDDEN;
 void wined3d_texture_get_memory(struct wined3d_texture *texture, unsigned int sub_resource_idx,
         struct wined3d_bo_address *data, DWORD locations) DECLSPEC_HIDDEN;
@@ -3560,10 +3606,14 @@ enum wined3d_push_constants
 #define WINED3D_CS_QUERY_POLL_INTERVAL  10u
 #define WINED3D_CS_QUEUE_SIZE           0x100000u
 #define WINED3D_CS_SPIN_COUNT           10000000u
+#define WINED3D_CS_MAX_DELAYED_SIZE     0x4000u
 
 struct wined3d_cs_queue
 {
     LONG head, tail;
+    /* Packets between "head" and "end" have been written, but not yet made
+     * visible to the CS thread. */
+    LONG end;
     BYTE data[WINED3D_CS_QUEUE_SIZE];
 };
 
@@ -3571,6 +3621,7 @@ struct wined3d_cs_ops
 {
     void *(*require_space)(struct wined3d_cs *cs, size_t size, enum wined3d_cs_queue_id queue_id);
     void (*submit)(struct wined3d_cs *cs, enum wined3d_cs_queue_id queue_id);
+    void (*submit_delayed)(struct wined3d_cs *cs, enum wined3d_cs_queue_id queue_id);
     void (*finish)(struct wined3d_cs *cs, enum wined3d_cs_queue_id queue_id);
     void (*push_constants)(struct wined3d_cs *cs, enum wined3d_push_constants p,
             unsigned int start_idx, unsigned int count, const void *constants);
@@ -3595,6 +3646,16 @@ struct wined3d_cs
     HANDLE event;
     BOOL waiting_for_event;
     LONG pending_presents;
+
+    /* Compatible consecutive draws, merged by the CS thread. */
+    struct wined3d_draw_batch draw_batch;
+    GLenum draw_batch_primitive_type;
+    GLint draw_batch_patch_vertex_count;
+
+    /* Per-frame statistics, updated by the CS thread. */
+    unsigned int packet_count, wait_count;
+    SIZE_T packet_bytes;
+    DWORD idle_time;
 };
 
 struct wined3d_cs *wined3d_cs_create(struct wined3d_device *device) DECLSPEC_HIDDEN;
@@ -3683,6 +3744,8 @@ void wined3d_cs_emit_unload_resource(struct wined3d_cs *cs, struct wined3d_resou
 void wined3d_cs_emit_update_sub_resource(struct wined3d_cs *cs, struct wined3d_resource *resource,
         unsigned int sub_resource_idx, const struct wined3d_box *box, const void *data, unsigned int row_pitch,
         unsigned int slice_pitch) DECLSPEC_HIDDEN;
+void wined3d_cs_emit_upload_buffer(struct wined3d_cs *cs, struct wined3d_buffer *buffer,
+        unsigned int ring_offset, unsigned int ring_end) DECLSPEC_HIDDEN;
 void wined3d_cs_init_object(struct wined3d_cs *cs,
         void (*callback)(void *object), void *object) DECLSPEC_HIDDEN;
 HRESULT wined3d_cs_map(struct wined3d_cs *cs, struct wined3d_resource *resource, unsigned int sub_resource_idx,
@@ -3756,6 +3819,10 @@ struct wined3d_buffer
     UINT stride;                                            /* 0 if no conversion */
     enum wined3d_buffer_conversion_type *conversion_map;    /* NULL if no conversion */
     UINT conversion_stride;                                 /* 0 if no shifted conversion */
+
+    /* DISCARD maps served from the device upload ring. */
+    unsigned int upload_offset, upload_end, upload_map_count;
+    unsigned int upload_position;
 };
 
 static inline struct wined3d_buffer *buffer_from_resource(struct wined3d_resource *resource)
@@ -3775,6 +3842,15 @@ void wined3d_buffer_copy(struct wined3d_buffer *dst_buffer, unsigned int dst_off
         struct wined3d_buffer *src_buffer, unsigned int src_offset, unsigned int size) DECLSPEC_HIDDEN;
 void wined3d_buffer_upload_data(struct wined3d_buffer *buffer, struct wined3d_context *context,
         const struct wined3d_box *box, const void *data) DECLSPEC_HIDDEN;
+BOOL wined3d_buffer_map_upload(struct wined3d_buffer *buffer, struct wined3d_map_desc *map_desc,
+        const struct wined3d_box *box, DWORD flags) DECLSPEC_HIDDEN;
+BOOL wined3d_buffer_unmap_upload(struct wined3d_buffer *buffer) DECLSPEC_HIDDEN;
+void wined3d_buffer_upload_from_ring(struct wined3d_buffer *buffer, struct wined3d_context *context,
+        unsigned int ring_offset, unsigned int ring_end) DECLSPEC_HIDDEN;
+
+void wined3d_upload_ring_cleanup(struct wined3d_upload_ring *ring, struct wined3d_context *context) DECLSPEC_HIDDEN;
+void wined3d_upload_ring_init(struct wined3d_upload_ring *ring, struct wined3d_context *context) DECLSPEC_HIDDEN;
+void wined3d_upload_ring_retire(struct wined3d_device *device) DECLSPEC_HIDDEN;
 
 struct wined3d_rendertarget_view
 {
@@ -222,6 +222,7 @@ static const struct window_surface_funcs macdrv_surface_funcs =
     macdrv_surface_set_region,
     macdrv_surface_flush,
     macdrv_surface_destroy,
+    NULL, /* add_damage */
 };
 
 /***********************************************************************
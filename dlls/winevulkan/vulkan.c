@@ -18,6 +18,7 @@
  */
 
 #include <stdarg.h>
+#include <stdio.h>
 #include <math.h>
 
 #include "windef.h"
@@ -57,6 +58,7 @@ static void *wine_vk_find_struct_(void *s, VkStructureType t)
 }
 
 static void *wine_vk_get_global_proc_addr(const char *name);
+static void wine_vk_device_save_pipeline_cache(VkDevice device);
 
 static const struct vulkan_funcs *vk_funcs;
 static VkResult (*p_vkEnumerateInstanceVersion)(uint32_t *version);
@@ -320,6 +322,19 @@ static void wine_vk_device_free(struct VkDevice_T *device)
         device->queues = NULL;
     }
 
+    if (device->pipeline_cache)
+    {
+        LARGE_INTEGER freq;
+
+        QueryPerformanceFrequency(&freq);
+        TRACE("Created %u internal pipelines in %s us.\n", device->pipeline_count,
+                wine_dbgstr_longlong(device->pipeline_time * 1000000 / freq.QuadPart));
+
+        wine_vk_device_save_pipeline_cache(device);
+        device->funcs.p_vkDestroyPipelineCache(device->device, device->pipeline_cache, NULL);
+    }
+    heap_free(device->pipeline_cache_data);
+
     if (device->device && device->funcs.p_vkDestroyDevice)
     {
         device->funcs.p_vkDestroyDevice(device->device, NULL /* pAllocator */);
@@ -1390,8 +1405,151 @@ const uint32_t blit_comp_spv[] = {
 	0x000100fd,0x00010038
 };
 
-static VkResult create_pipeline(VkDevice device, struct VkSwapchainKHR_T *swapchain, struct fs_hack_image *hack, VkShaderModule shaderModule)
+/* Reads the on-disk cache and creates the pipeline cache from it. This does
+ * file I/O, so it's called without holding swapchain_lock; if another thread
+ * gets there first, its cache is kept. */
+static void wine_vk_device_init_pipeline_cache(VkDevice device)
+{
+    static const char default_dir[] = "\\winevulkan";
+    VkPipelineCacheCreateInfo cacheInfo = {0};
+    VkPhysicalDeviceProperties properties;
+    VkPipelineCache cache = VK_NULL_HANDLE;
+    LARGE_INTEGER file_size;
+    char path[MAX_PATH];
+    void *data = NULL;
+    unsigned int i;
+    HANDLE file;
+    VkResult res;
+    DWORD len;
+    char *p;
+
+    len = GetEnvironmentVariableA("LOCALAPPDATA", path, sizeof(path));
+    /* Directory, vendor and device IDs, UUID and extension. */
+    if(!len || len + strlen(default_dir) + 1 + 17 + 2 * VK_UUID_SIZE + 4 >= sizeof(path)){
+        WARN("Failed to get the local application data directory.\n");
+        path[0] = 0;
+    }else{
+        strcat(path, default_dir);
+        if(!CreateDirectoryA(path, NULL) && GetLastError() != ERROR_ALREADY_EXISTS){
+            WARN("Failed to create pipeline cache directory %s, error %u.\n", debugstr_a(path), GetLastError());
+            path[0] = 0;
+        }
+    }
+
+    if(path[0]){
+        /* The driver validates the cache header itself, but keying the file
+         * on the device avoids multiple GPUs evicting each other's data. */
+        wine_vkGetPhysicalDeviceProperties(device->phys_dev, &properties);
+        p = path + strlen(path);
+        p += sprintf(p, "\\%08x%08x-", properties.vendorID, properties.deviceID);
+        for(i = 0; i < VK_UUID_SIZE; ++i)
+            p += sprintf(p, "%02x", properties.pipelineCacheUUID[i]);
+        strcpy(p, ".bin");
+
+        if((file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL,
+                OPEN_EXISTING, 0, NULL)) != INVALID_HANDLE_VALUE){
+            if(GetFileSizeEx(file, &file_size) && file_size.QuadPart && file_size.QuadPart < 0x10000000
+                    && (data = heap_alloc(file_size.QuadPart))
+                    && ReadFile(file, data, file_size.QuadPart, &len, NULL) && len == file_size.QuadPart){
+                cacheInfo.initialDataSize = len;
+                cacheInfo.pInitialData = data;
+            }else{
+                WARN("Failed to read pipeline cache %s.\n", debugstr_a(path));
+            }
+            CloseHandle(file);
+        }
+    }
+
+    cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    res = device->funcs.p_vkCreatePipelineCache(device->device, &cacheInfo, NULL, &cache);
+    if(res != VK_SUCCESS && cacheInfo.initialDataSize){
+        WARN("Failed to create pipeline cache with initial data, res=%d.\n", res);
+        cacheInfo.initialDataSize = 0;
+        cacheInfo.pInitialData = NULL;
+        res = device->funcs.p_vkCreatePipelineCache(device->device, &cacheInfo, NULL, &cache);
+    }
+    if(res != VK_SUCCESS){
+        WARN("vkCreatePipelineCache: %d\n", res);
+        cache = VK_NULL_HANDLE;
+    }
+
+    TRACE("Using pipeline cache %s, %lu bytes of initial data.\n",
+            debugstr_a(path), (unsigned long)cacheInfo.initialDataSize);
+
+    EnterCriticalSection(&device->swapchain_lock);
+    if(!device->pipeline_cache_initialized){
+        device->pipeline_cache_initialized = TRUE;
+        device->pipeline_cache = cache;
+        strcpy(device->pipeline_cache_path, path);
+        cache = VK_NULL_HANDLE;
+        /* Kept to tell whether there is anything new to store. */
+        if(cacheInfo.pInitialData){
+            device->pipeline_cache_data = data;
+            device->pipeline_cache_size = cacheInfo.initialDataSize;
+            data = NULL;
+        }
+    }
+    LeaveCriticalSection(&device->swapchain_lock);
+
+    if(cache)
+        device->funcs.p_vkDestroyPipelineCache(device->device, cache, NULL);
+    heap_free(data);
+}
+
+static void wine_vk_device_save_pipeline_cache(VkDevice device)
 {
+    char path[MAX_PATH + 4];
+    void *data = NULL;
+    size_t size = 0;
+    HANDLE file;
+    DWORD written;
+
+    if(!device->pipeline_cache_path[0])
+        return;
+
+    if(device->funcs.p_vkGetPipelineCacheData(device->device, device->pipeline_cache, &size, NULL) != VK_SUCCESS
+            || !size || size > 0x10000000 || !(data = heap_alloc(size))
+            || device->funcs.p_vkGetPipelineCacheData(device->device, device->pipeline_cache, &size, data) != VK_SUCCESS){
+        WARN("Failed to get pipeline cache data.\n");
+        heap_free(data);
+        return;
+    }
+
+    /* Pipelines found in the cache don't change its data. */
+    if(size == device->pipeline_cache_size && !memcmp(data, device->pipeline_cache_data, size)){
+        TRACE("Pipeline cache %s is up to date.\n", debugstr_a(device->pipeline_cache_path));
+        heap_free(data);
+        return;
+    }
+
+    /* Write a temporary file first, so a concurrent reader never sees a
+     * partial cache. */
+    sprintf(path, "%s.tmp", device->pipeline_cache_path);
+    if((file = CreateFileA(path, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, 0, NULL)) == INVALID_HANDLE_VALUE){
+        WARN("Failed to create %s, error %u.\n", debugstr_a(path), GetLastError());
+        heap_free(data);
+        return;
+    }
+    if(WriteFile(file, data, size, &written, NULL) && written == size){
+        CloseHandle(file);
+        if(MoveFileExA(path, device->pipeline_cache_path, MOVEFILE_REPLACE_EXISTING))
+            TRACE("Stored %lu bytes of pipeline cache data to %s.\n",
+                    (unsigned long)size, debugstr_a(device->pipeline_cache_path));
+        else
+            WARN("Failed to replace %s, error %u.\n", debugstr_a(device->pipeline_cache_path), GetLastError());
+    }else{
+        WARN("Failed to write %s.\n", debugstr_a(path));
+        CloseHandle(file);
+        DeleteFileA(path);
+    }
+
+    heap_free(data);
+}
+
+static VkResult create_pipeline(VkDevice device, struct VkSwapchainKHR_T *swapchain, VkShaderModule shaderModule)
+{
+    LARGE_INTEGER start, end, freq;
+    BOOL initialized;
     VkResult res;
 #if defined(USE_STRUCT_CONVERSION)
     VkComputePipelineCreateInfo_host pipelineInfo = {0};
@@ -1408,12 +1566,31 @@ static VkResult create_pipeline(VkDevice device, struct VkSwapchainKHR_T *swapch
     pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
     pipelineInfo.basePipelineIndex = -1;
 
-    res = device->funcs.p_vkCreateComputePipelines(device->device, VK_NULL_HANDLE, 1, &pipelineInfo, NULL, &hack->pipeline);
+    EnterCriticalSection(&device->swapchain_lock);
+    initialized = device->pipeline_cache_initialized;
+    LeaveCriticalSection(&device->swapchain_lock);
+    if(!initialized)
+        wine_vk_device_init_pipeline_cache(device);
+
+    QueryPerformanceCounter(&start);
+    res = device->funcs.p_vkCreateComputePipelines(device->device, device->pipeline_cache, 1, &pipelineInfo, NULL, &swapchain->pipeline);
+    QueryPerformanceCounter(&end);
     if(res != VK_SUCCESS){
         ERR("vkCreateComputePipelines: %d\n", res);
         return res;
     }
 
+    EnterCriticalSection(&device->swapchain_lock);
+    ++device->pipeline_count;
+    device->pipeline_time += end.QuadPart - start.QuadPart;
+    LeaveCriticalSection(&device->swapchain_lock);
+
+    if(TRACE_ON(vulkan)){
+        QueryPerformanceFrequency(&freq);
+        TRACE("Created pipeline 0x%s in %s us.\n", wine_dbgstr_longlong(swapchain->pipeline),
+                wine_dbgstr_longlong((end.QuadPart - start.QuadPart) * 1000000 / freq.QuadPart));
+    }
+
     return VK_SUCCESS;
 }
 
@@ -1471,7 +1648,6 @@ static VkResult create_descriptor_set(VkDevice device, struct VkSwapchainKHR_T *
 
 static void destroy_fs_hack_image(VkDevice device, struct VkSwapchainKHR_T *swapchain, struct fs_hack_image *hack)
 {
-    device->funcs.p_vkDestroyPipeline(device->device, hack->pipeline, NULL);
     device->funcs.p_vkFreeDescriptorSets(device->device, swapchain->descriptor_pool, 1, &hack->descriptor_set);
     device->funcs.p_vkDestroyImageView(device->device, hack->user_view, NULL);
     device->funcs.p_vkDestroyImageView(device->device, hack->blit_view, NULL);
@@ -1799,6 +1975,7 @@ void WINAPI wine_vkDestroySwapchainKHR(VkDevice device, VkSwapchainKHR swapchain
             if(object->cmd_pools[i])
                 device->funcs.p_vkDestroyCommandPool(device->device, object->cmd_pools[i], NULL);
 
+        device->funcs.p_vkDestroyPipeline(device->device, object->pipeline, NULL);
         device->funcs.p_vkDestroyPipelineLayout(device->device, object->pipeline_layout, NULL);
         device->funcs.p_vkDestroyDescriptorSetLayout(device->device, object->descriptor_set_layout, NULL);
         device->funcs.p_vkDestroyDescriptorPool(device->device, object->descriptor_pool, NULL);
@@ -2102,23 +2279,24 @@ static VkResult init_blit_images(VkDevice device, struct VkSwapchainKHR_T *swapc
         res = create_descriptor_set(device, swapchain, hack);
         if(res != VK_SUCCESS)
             goto fail;
-
-        res = create_pipeline(device, swapchain, hack, shaderModule);
-        if(res != VK_SUCCESS)
-            goto fail;
     }
 
+    /* All images share the layout and shader, so one pipeline serves them all. */
+    res = create_pipeline(device, swapchain, shaderModule);
+    if(res != VK_SUCCESS)
+        goto fail;
+
     device->funcs.p_vkDestroyShaderModule(device->device, shaderModule, NULL);
 
     return VK_SUCCESS;
 
 fail:
+    device->funcs.p_vkDestroyPipeline(device->device, swapchain->pipeline, NULL);
+    swapchain->pipeline = VK_NULL_HANDLE;
+
     for(i = 0; i < swapchain->n_images; ++i){
         struct fs_hack_image *hack = &swapchain->fs_hack_images[i];
 
-        device->funcs.p_vkDestroyPipeline(device->device, hack->pipeline, NULL);
-        hack->pipeline = VK_NULL_HANDLE;
-
         device->funcs.p_vkFreeDescriptorSets(device->device, swapchain->descriptor_pool, 1, &hack->descriptor_set);
         hack->descriptor_set = VK_NULL_HANDLE;
 
@@ -2220,7 +2398,7 @@ static VkResult record_compute_cmd(VkDevice device, struct VkSwapchainKHR_T *swa
 
     /* perform blit shader */
     device->funcs.p_vkCmdBindPipeline(hack->cmd,
-            VK_PIPELINE_BIND_POINT_COMPUTE, hack->pipeline);
+            VK_PIPELINE_BIND_POINT_COMPUTE, swapchain->pipeline);
 
     device->funcs.p_vkCmdBindDescriptorSets(hack->cmd,
             VK_PIPELINE_BIND_POINT_COMPUTE, swapchain->pipeline_layout,
@@ -2640,6 +2818,7 @@ void WINAPI wine_vkCmdPipelineBarrier(VkCommandBuffer commandBuffer,
     VkImageMemoryBarrier_host *pImageMemoryBarriers_host = NULL;
     uint32_t i, j, k;
     int old, new;
+    BOOL locked;
 
     TRACE("%p, %#x, %#x, %#x, %u, %p, %u, %p, %u, %p\n", commandBuffer, srcStageMask, dstStageMask, dependencyFlags, memoryBarrierCount, pMemoryBarriers, bufferMemoryBarrierCount, pBufferMemoryBarriers, imageMemoryBarrierCount, pImageMemoryBarriers);
 
@@ -2649,9 +2828,16 @@ void WINAPI wine_vkCmdPipelineBarrier(VkCommandBuffer commandBuffer,
 #endif
 
     /* if the client is trying to transition a user image to PRESENT_SRC,
-     * transition it to GENERAL instead. */
-    EnterCriticalSection(&commandBuffer->device->swapchain_lock);
+     * transition it to GENERAL instead. This runs for every barrier the
+     * application records, so only take the lock if there is one. */
     for(i = 0; i < imageMemoryBarrierCount; ++i){
+        if(pImageMemoryBarriers[i].oldLayout == VK_IMAGE_LAYOUT_PRESENT_SRC_KHR ||
+                pImageMemoryBarriers[i].newLayout == VK_IMAGE_LAYOUT_PRESENT_SRC_KHR)
+            break;
+    }
+    if((locked = i < imageMemoryBarrierCount))
+        EnterCriticalSection(&commandBuffer->device->swapchain_lock);
+    for(; i < imageMemoryBarrierCount; ++i){
         old = pImageMemoryBarriers[i].oldLayout == VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
         new = pImageMemoryBarriers[i].newLayout == VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
         if(old || new){
@@ -2677,7 +2863,8 @@ void WINAPI wine_vkCmdPipelineBarrier(VkCommandBuffer commandBuffer,
         }
 next:   ;
     }
-    LeaveCriticalSection(&commandBuffer->device->swapchain_lock);
+    if(locked)
+        LeaveCriticalSection(&commandBuffer->device->swapchain_lock);
 
     commandBuffer->device->funcs.p_vkCmdPipelineBarrier(commandBuffer->command_buffer,
             srcStageMask, dstStageMask, dependencyFlags, memoryBarrierCount,
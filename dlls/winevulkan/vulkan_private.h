@@ -84,6 +84,15 @@ struct VkDevice_T
     VkQueueFamilyProperties *queue_props;
 
     CRITICAL_SECTION swapchain_lock;
+
+    /* Implicit on-disk cache for our own pipelines, created on first use. */
+    VkPipelineCache pipeline_cache;
+    BOOL pipeline_cache_initialized;
+    char pipeline_cache_path[MAX_PATH];
+    void *pipeline_cache_data;
+    size_t pipeline_cache_size;
+    unsigned int pipeline_count;
+    LONGLONG pipeline_time;
 };
 
 struct VkInstance_T
@@ -147,7 +156,6 @@ struct fs_hack_image
     VkSemaphore blit_finished;
     VkImageView user_view, blit_view;
     VkDescriptorSet descriptor_set;
-    VkPipeline pipeline;
 };
 
 struct VkSwapchainKHR_T
@@ -169,6 +177,7 @@ struct VkSwapchainKHR_T
     VkDescriptorPool descriptor_pool;
     VkDescriptorSetLayout descriptor_set_layout;
     VkPipelineLayout pipeline_layout;
+    VkPipeline pipeline;
 };
 
 void *wine_vk_get_device_proc_addr(const char *name) DECLSPEC_HIDDEN;
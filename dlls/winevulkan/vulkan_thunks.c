@@ -1061,11 +1061,14 @@ static inline void free_VkCopyDescriptorSet_array(VkCopyDescriptorSet_host *in,
 VkBufferMemoryBarrier_host *convert_VkBufferMemoryBarrier_array_win_to_host(const VkBufferMemoryBarrier *in, uint32_t count)
 {
     VkBufferMemoryBarrier_host *out;
+#if defined(USE_STRUCT_CONVERSION)
     unsigned int i;
+#endif
 
     if (!in) return NULL;
 
     out = heap_alloc(count * sizeof(*out));
+#if defined(USE_STRUCT_CONVERSION)
     for (i = 0; i < count; i++)
     {
         out[i].sType = in[i].sType;
@@ -1078,6 +1081,9 @@ VkBufferMemoryBarrier_host *convert_VkBufferMemoryBarrier_array_win_to_host(cons
         out[i].offset = in[i].offset;
         out[i].size = in[i].size;
     }
+#else
+    memcpy(out, in, count * sizeof(*out));
+#endif
 
     return out;
 }
@@ -1092,11 +1098,14 @@ void free_VkBufferMemoryBarrier_array(VkBufferMemoryBarrier_host *in, uint32_t c
 VkImageMemoryBarrier_host *convert_VkImageMemoryBarrier_array_win_to_host(const VkImageMemoryBarrier *in, uint32_t count)
 {
     VkImageMemoryBarrier_host *out;
+#if defined(USE_STRUCT_CONVERSION)
     unsigned int i;
+#endif
 
     if (!in) return NULL;
 
     out = heap_alloc(count * sizeof(*out));
+#if defined(USE_STRUCT_CONVERSION)
     for (i = 0; i < count; i++)
     {
         out[i].sType = in[i].sType;
@@ -1110,6 +1119,9 @@ VkImageMemoryBarrier_host *convert_VkImageMemoryBarrier_array_win_to_host(const
         out[i].image = in[i].image;
         out[i].subresourceRange = in[i].subresourceRange;
     }
+#else
+    memcpy(out, in, count * sizeof(*out));
+#endif
 
     return out;
 }
@@ -1121,6 +1133,450 @@ void free_VkImageMemoryBarrier_array(VkImageMemoryBarrier_host *in, uint32_t cou
     heap_free(in);
 }
 
+#if !defined(USE_STRUCT_CONVERSION)
+C_ASSERT(sizeof(VkAcquireNextImageInfoKHR_host) == sizeof(VkAcquireNextImageInfoKHR));
+C_ASSERT(FIELD_OFFSET(VkAcquireNextImageInfoKHR_host, sType) == FIELD_OFFSET(VkAcquireNextImageInfoKHR, sType));
+C_ASSERT(FIELD_OFFSET(VkAcquireNextImageInfoKHR_host, pNext) == FIELD_OFFSET(VkAcquireNextImageInfoKHR, pNext));
+C_ASSERT(FIELD_OFFSET(VkAcquireNextImageInfoKHR_host, swapchain) == FIELD_OFFSET(VkAcquireNextImageInfoKHR, swapchain));
+C_ASSERT(FIELD_OFFSET(VkAcquireNextImageInfoKHR_host, timeout) == FIELD_OFFSET(VkAcquireNextImageInfoKHR, timeout));
+C_ASSERT(FIELD_OFFSET(VkAcquireNextImageInfoKHR_host, semaphore) == FIELD_OFFSET(VkAcquireNextImageInfoKHR, semaphore));
+C_ASSERT(FIELD_OFFSET(VkAcquireNextImageInfoKHR_host, fence) == FIELD_OFFSET(VkAcquireNextImageInfoKHR, fence));
+C_ASSERT(FIELD_OFFSET(VkAcquireNextImageInfoKHR_host, deviceMask) == FIELD_OFFSET(VkAcquireNextImageInfoKHR, deviceMask));
+C_ASSERT(sizeof(VkCommandBufferAllocateInfo_host) == sizeof(VkCommandBufferAllocateInfo));
+C_ASSERT(FIELD_OFFSET(VkCommandBufferAllocateInfo_host, sType) == FIELD_OFFSET(VkCommandBufferAllocateInfo, sType));
+C_ASSERT(FIELD_OFFSET(VkCommandBufferAllocateInfo_host, pNext) == FIELD_OFFSET(VkCommandBufferAllocateInfo, pNext));
+C_ASSERT(FIELD_OFFSET(VkCommandBufferAllocateInfo_host, commandPool) == FIELD_OFFSET(VkCommandBufferAllocateInfo, commandPool));
+C_ASSERT(FIELD_OFFSET(VkCommandBufferAllocateInfo_host, level) == FIELD_OFFSET(VkCommandBufferAllocateInfo, level));
+C_ASSERT(FIELD_OFFSET(VkCommandBufferAllocateInfo_host, commandBufferCount) == FIELD_OFFSET(VkCommandBufferAllocateInfo, commandBufferCount));
+C_ASSERT(sizeof(VkDescriptorSetAllocateInfo_host) == sizeof(VkDescriptorSetAllocateInfo));
+C_ASSERT(FIELD_OFFSET(VkDescriptorSetAllocateInfo_host, sType) == FIELD_OFFSET(VkDescriptorSetAllocateInfo, sType));
+C_ASSERT(FIELD_OFFSET(VkDescriptorSetAllocateInfo_host, pNext) == FIELD_OFFSET(VkDescriptorSetAllocateInfo, pNext));
+C_ASSERT(FIELD_OFFSET(VkDescriptorSetAllocateInfo_host, descriptorPool) == FIELD_OFFSET(VkDescriptorSetAllocateInfo, descriptorPool));
+C_ASSERT(FIELD_OFFSET(VkDescriptorSetAllocateInfo_host, descriptorSetCount) == FIELD_OFFSET(VkDescriptorSetAllocateInfo, descriptorSetCount));
+C_ASSERT(FIELD_OFFSET(VkDescriptorSetAllocateInfo_host, pSetLayouts) == FIELD_OFFSET(VkDescriptorSetAllocateInfo, pSetLayouts));
+C_ASSERT(sizeof(VkMemoryAllocateInfo_host) == sizeof(VkMemoryAllocateInfo));
+C_ASSERT(FIELD_OFFSET(VkMemoryAllocateInfo_host, sType) == FIELD_OFFSET(VkMemoryAllocateInfo, sType));
+C_ASSERT(FIELD_OFFSET(VkMemoryAllocateInfo_host, pNext) == FIELD_OFFSET(VkMemoryAllocateInfo, pNext));
+C_ASSERT(FIELD_OFFSET(VkMemoryAllocateInfo_host, allocationSize) == FIELD_OFFSET(VkMemoryAllocateInfo, allocationSize));
+C_ASSERT(FIELD_OFFSET(VkMemoryAllocateInfo_host, memoryTypeIndex) == FIELD_OFFSET(VkMemoryAllocateInfo, memoryTypeIndex));
+C_ASSERT(sizeof(VkCommandBufferInheritanceInfo_host) == sizeof(VkCommandBufferInheritanceInfo));
+C_ASSERT(FIELD_OFFSET(VkCommandBufferInheritanceInfo_host, sType) == FIELD_OFFSET(VkCommandBufferInheritanceInfo, sType));
+C_ASSERT(FIELD_OFFSET(VkCommandBufferInheritanceInfo_host, pNext) == FIELD_OFFSET(VkCommandBufferInheritanceInfo, pNext));
+C_ASSERT(FIELD_OFFSET(VkCommandBufferInheritanceInfo_host, renderPass) == FIELD_OFFSET(VkCommandBufferInheritanceInfo, renderPass));
+C_ASSERT(FIELD_OFFSET(VkCommandBufferInheritanceInfo_host, subpass) == FIELD_OFFSET(VkCommandBufferInheritanceInfo, subpass));
+C_ASSERT(FIELD_OFFSET(VkCommandBufferInheritanceInfo_host, framebuffer) == FIELD_OFFSET(VkCommandBufferInheritanceInfo, framebuffer));
+C_ASSERT(FIELD_OFFSET(VkCommandBufferInheritanceInfo_host, occlusionQueryEnable) == FIELD_OFFSET(VkCommandBufferInheritanceInfo, occlusionQueryEnable));
+C_ASSERT(FIELD_OFFSET(VkCommandBufferInheritanceInfo_host, queryFlags) == FIELD_OFFSET(VkCommandBufferInheritanceInfo, queryFlags));
+C_ASSERT(FIELD_OFFSET(VkCommandBufferInheritanceInfo_host, pipelineStatistics) == FIELD_OFFSET(VkCommandBufferInheritanceInfo, pipelineStatistics));
+C_ASSERT(sizeof(VkCommandBufferBeginInfo_host) == sizeof(VkCommandBufferBeginInfo));
+C_ASSERT(FIELD_OFFSET(VkCommandBufferBeginInfo_host, sType) == FIELD_OFFSET(VkCommandBufferBeginInfo, sType));
+C_ASSERT(FIELD_OFFSET(VkCommandBufferBeginInfo_host, pNext) == FIELD_OFFSET(VkCommandBufferBeginInfo, pNext));
+C_ASSERT(FIELD_OFFSET(VkCommandBufferBeginInfo_host, flags) == FIELD_OFFSET(VkCommandBufferBeginInfo, flags));
+C_ASSERT(FIELD_OFFSET(VkCommandBufferBeginInfo_host, pInheritanceInfo) == FIELD_OFFSET(VkCommandBufferBeginInfo, pInheritanceInfo));
+C_ASSERT(sizeof(VkBindBufferMemoryInfo_host) == sizeof(VkBindBufferMemoryInfo));
+C_ASSERT(FIELD_OFFSET(VkBindBufferMemoryInfo_host, sType) == FIELD_OFFSET(VkBindBufferMemoryInfo, sType));
+C_ASSERT(FIELD_OFFSET(VkBindBufferMemoryInfo_host, pNext) == FIELD_OFFSET(VkBindBufferMemoryInfo, pNext));
+C_ASSERT(FIELD_OFFSET(VkBindBufferMemoryInfo_host, buffer) == FIELD_OFFSET(VkBindBufferMemoryInfo, buffer));
+C_ASSERT(FIELD_OFFSET(VkBindBufferMemoryInfo_host, memory) == FIELD_OFFSET(VkBindBufferMemoryInfo, memory));
+C_ASSERT(FIELD_OFFSET(VkBindBufferMemoryInfo_host, memoryOffset) == FIELD_OFFSET(VkBindBufferMemoryInfo, memoryOffset));
+C_ASSERT(sizeof(VkBindImageMemoryInfo_host) == sizeof(VkBindImageMemoryInfo));
+C_ASSERT(FIELD_OFFSET(VkBindImageMemoryInfo_host, sType) == FIELD_OFFSET(VkBindImageMemoryInfo, sType));
+C_ASSERT(FIELD_OFFSET(VkBindImageMemoryInfo_host, pNext) == FIELD_OFFSET(VkBindImageMemoryInfo, pNext));
+C_ASSERT(FIELD_OFFSET(VkBindImageMemoryInfo_host, image) == FIELD_OFFSET(VkBindImageMemoryInfo, image));
+C_ASSERT(FIELD_OFFSET(VkBindImageMemoryInfo_host, memory) == FIELD_OFFSET(VkBindImageMemoryInfo, memory));
+C_ASSERT(FIELD_OFFSET(VkBindImageMemoryInfo_host, memoryOffset) == FIELD_OFFSET(VkBindImageMemoryInfo, memoryOffset));
+C_ASSERT(sizeof(VkConditionalRenderingBeginInfoEXT_host) == sizeof(VkConditionalRenderingBeginInfoEXT));
+C_ASSERT(FIELD_OFFSET(VkConditionalRenderingBeginInfoEXT_host, sType) == FIELD_OFFSET(VkConditionalRenderingBeginInfoEXT, sType));
+C_ASSERT(FIELD_OFFSET(VkConditionalRenderingBeginInfoEXT_host, pNext) == FIELD_OFFSET(VkConditionalRenderingBeginInfoEXT, pNext));
+C_ASSERT(FIELD_OFFSET(VkConditionalRenderingBeginInfoEXT_host, buffer) == FIELD_OFFSET(VkConditionalRenderingBeginInfoEXT, buffer));
+C_ASSERT(FIELD_OFFSET(VkConditionalRenderingBeginInfoEXT_host, offset) == FIELD_OFFSET(VkConditionalRenderingBeginInfoEXT, offset));
+C_ASSERT(FIELD_OFFSET(VkConditionalRenderingBeginInfoEXT_host, flags) == FIELD_OFFSET(VkConditionalRenderingBeginInfoEXT, flags));
+C_ASSERT(sizeof(VkRenderPassBeginInfo_host) == sizeof(VkRenderPassBeginInfo));
+C_ASSERT(FIELD_OFFSET(VkRenderPassBeginInfo_host, sType) == FIELD_OFFSET(VkRenderPassBeginInfo, sType));
+C_ASSERT(FIELD_OFFSET(VkRenderPassBeginInfo_host, pNext) == FIELD_OFFSET(VkRenderPassBeginInfo, pNext));
+C_ASSERT(FIELD_OFFSET(VkRenderPassBeginInfo_host, renderPass) == FIELD_OFFSET(VkRenderPassBeginInfo, renderPass));
+C_ASSERT(FIELD_OFFSET(VkRenderPassBeginInfo_host, framebuffer) == FIELD_OFFSET(VkRenderPassBeginInfo, framebuffer));
+C_ASSERT(FIELD_OFFSET(VkRenderPassBeginInfo_host, renderArea) == FIELD_OFFSET(VkRenderPassBeginInfo, renderArea));
+C_ASSERT(FIELD_OFFSET(VkRenderPassBeginInfo_host, clearValueCount) == FIELD_OFFSET(VkRenderPassBeginInfo, clearValueCount));
+C_ASSERT(FIELD_OFFSET(VkRenderPassBeginInfo_host, pClearValues) == FIELD_OFFSET(VkRenderPassBeginInfo, pClearValues));
+C_ASSERT(sizeof(VkBufferCopy_host) == sizeof(VkBufferCopy));
+C_ASSERT(FIELD_OFFSET(VkBufferCopy_host, srcOffset) == FIELD_OFFSET(VkBufferCopy, srcOffset));
+C_ASSERT(FIELD_OFFSET(VkBufferCopy_host, dstOffset) == FIELD_OFFSET(VkBufferCopy, dstOffset));
+C_ASSERT(FIELD_OFFSET(VkBufferCopy_host, size) == FIELD_OFFSET(VkBufferCopy, size));
+C_ASSERT(sizeof(VkBufferImageCopy_host) == sizeof(VkBufferImageCopy));
+C_ASSERT(FIELD_OFFSET(VkBufferImageCopy_host, bufferOffset) == FIELD_OFFSET(VkBufferImageCopy, bufferOffset));
+C_ASSERT(FIELD_OFFSET(VkBufferImageCopy_host, bufferRowLength) == FIELD_OFFSET(VkBufferImageCopy, bufferRowLength));
+C_ASSERT(FIELD_OFFSET(VkBufferImageCopy_host, bufferImageHeight) == FIELD_OFFSET(VkBufferImageCopy, bufferImageHeight));
+C_ASSERT(FIELD_OFFSET(VkBufferImageCopy_host, imageSubresource) == FIELD_OFFSET(VkBufferImageCopy, imageSubresource));
+C_ASSERT(FIELD_OFFSET(VkBufferImageCopy_host, imageOffset) == FIELD_OFFSET(VkBufferImageCopy, imageOffset));
+C_ASSERT(FIELD_OFFSET(VkBufferImageCopy_host, imageExtent) == FIELD_OFFSET(VkBufferImageCopy, imageExtent));
+C_ASSERT(sizeof(VkBufferMemoryBarrier_host) == sizeof(VkBufferMemoryBarrier));
+C_ASSERT(FIELD_OFFSET(VkBufferMemoryBarrier_host, sType) == FIELD_OFFSET(VkBufferMemoryBarrier, sType));
+C_ASSERT(FIELD_OFFSET(VkBufferMemoryBarrier_host, pNext) == FIELD_OFFSET(VkBufferMemoryBarrier, pNext));
+C_ASSERT(FIELD_OFFSET(VkBufferMemoryBarrier_host, srcAccessMask) == FIELD_OFFSET(VkBufferMemoryBarrier, srcAccessMask));
+C_ASSERT(FIELD_OFFSET(VkBufferMemoryBarrier_host, dstAccessMask) == FIELD_OFFSET(VkBufferMemoryBarrier, dstAccessMask));
+C_ASSERT(FIELD_OFFSET(VkBufferMemoryBarrier_host, srcQueueFamilyIndex) == FIELD_OFFSET(VkBufferMemoryBarrier, srcQueueFamilyIndex));
+C_ASSERT(FIELD_OFFSET(VkBufferMemoryBarrier_host, dstQueueFamilyIndex) == FIELD_OFFSET(VkBufferMemoryBarrier, dstQueueFamilyIndex));
+C_ASSERT(FIELD_OFFSET(VkBufferMemoryBarrier_host, buffer) == FIELD_OFFSET(VkBufferMemoryBarrier, buffer));
+C_ASSERT(FIELD_OFFSET(VkBufferMemoryBarrier_host, offset) == FIELD_OFFSET(VkBufferMemoryBarrier, offset));
+C_ASSERT(FIELD_OFFSET(VkBufferMemoryBarrier_host, size) == FIELD_OFFSET(VkBufferMemoryBarrier, size));
+C_ASSERT(sizeof(VkImageMemoryBarrier_host) == sizeof(VkImageMemoryBarrier));
+C_ASSERT(FIELD_OFFSET(VkImageMemoryBarrier_host, sType) == FIELD_OFFSET(VkImageMemoryBarrier, sType));
+C_ASSERT(FIELD_OFFSET(VkImageMemoryBarrier_host, pNext) == FIELD_OFFSET(VkImageMemoryBarrier, pNext));
+C_ASSERT(FIELD_OFFSET(VkImageMemoryBarrier_host, srcAccessMask) == FIELD_OFFSET(VkImageMemoryBarrier, srcAccessMask));
+C_ASSERT(FIELD_OFFSET(VkImageMemoryBarrier_host, dstAccessMask) == FIELD_OFFSET(VkImageMemoryBarrier, dstAccessMask));
+C_ASSERT(FIELD_OFFSET(VkImageMemoryBarrier_host, oldLayout) == FIELD_OFFSET(VkImageMemoryBarrier, oldLayout));
+C_ASSERT(FIELD_OFFSET(VkImageMemoryBarrier_host, newLayout) == FIELD_OFFSET(VkImageMemoryBarrier, newLayout));
+C_ASSERT(FIELD_OFFSET(VkImageMemoryBarrier_host, srcQueueFamilyIndex) == FIELD_OFFSET(VkImageMemoryBarrier, srcQueueFamilyIndex));
+C_ASSERT(FIELD_OFFSET(VkImageMemoryBarrier_host, dstQueueFamilyIndex) == FIELD_OFFSET(VkImageMemoryBarrier, dstQueueFamilyIndex));
+C_ASSERT(FIELD_OFFSET(VkImageMemoryBarrier_host, image) == FIELD_OFFSET(VkImageMemoryBarrier, image));
+C_ASSERT(FIELD_OFFSET(VkImageMemoryBarrier_host, subresourceRange) == FIELD_OFFSET(VkImageMemoryBarrier, subresourceRange));
+C_ASSERT(sizeof(VkDescriptorImageInfo_host) == sizeof(VkDescriptorImageInfo));
+C_ASSERT(FIELD_OFFSET(VkDescriptorImageInfo_host, sampler) == FIELD_OFFSET(VkDescriptorImageInfo, sampler));
+C_ASSERT(FIELD_OFFSET(VkDescriptorImageInfo_host, imageView) == FIELD_OFFSET(VkDescriptorImageInfo, imageView));
+C_ASSERT(FIELD_OFFSET(VkDescriptorImageInfo_host, imageLayout) == FIELD_OFFSET(VkDescriptorImageInfo, imageLayout));
+C_ASSERT(sizeof(VkDescriptorBufferInfo_host) == sizeof(VkDescriptorBufferInfo));
+C_ASSERT(FIELD_OFFSET(VkDescriptorBufferInfo_host, buffer) == FIELD_OFFSET(VkDescriptorBufferInfo, buffer));
+C_ASSERT(FIELD_OFFSET(VkDescriptorBufferInfo_host, offset) == FIELD_OFFSET(VkDescriptorBufferInfo, offset));
+C_ASSERT(FIELD_OFFSET(VkDescriptorBufferInfo_host, range) == FIELD_OFFSET(VkDescriptorBufferInfo, range));
+C_ASSERT(sizeof(VkWriteDescriptorSet_host) == sizeof(VkWriteDescriptorSet));
+C_ASSERT(FIELD_OFFSET(VkWriteDescriptorSet_host, sType) == FIELD_OFFSET(VkWriteDescriptorSet, sType));
+C_ASSERT(FIELD_OFFSET(VkWriteDescriptorSet_host, pNext) == FIELD_OFFSET(VkWriteDescriptorSet, pNext));
+C_ASSERT(FIELD_OFFSET(VkWriteDescriptorSet_host, dstSet) == FIELD_OFFSET(VkWriteDescriptorSet, dstSet));
+C_ASSERT(FIELD_OFFSET(VkWriteDescriptorSet_host, dstBinding) == FIELD_OFFSET(VkWriteDescriptorSet, dstBinding));
+C_ASSERT(FIELD_OFFSET(VkWriteDescriptorSet_host, dstArrayElement) == FIELD_OFFSET(VkWriteDescriptorSet, dstArrayElement));
+C_ASSERT(FIELD_OFFSET(VkWriteDescriptorSet_host, descriptorCount) == FIELD_OFFSET(VkWriteDescriptorSet, descriptorCount));
+C_ASSERT(FIELD_OFFSET(VkWriteDescriptorSet_host, descriptorType) == FIELD_OFFSET(VkWriteDescriptorSet, descriptorType));
+C_ASSERT(FIELD_OFFSET(VkWriteDescriptorSet_host, pImageInfo) == FIELD_OFFSET(VkWriteDescriptorSet, pImageInfo));
+C_ASSERT(FIELD_OFFSET(VkWriteDescriptorSet_host, pBufferInfo) == FIELD_OFFSET(VkWriteDescriptorSet, pBufferInfo));
+C_ASSERT(FIELD_OFFSET(VkWriteDescriptorSet_host, pTexelBufferView) == FIELD_OFFSET(VkWriteDescriptorSet, pTexelBufferView));
+C_ASSERT(sizeof(VkBufferCreateInfo_host) == sizeof(VkBufferCreateInfo));
+C_ASSERT(FIELD_OFFSET(VkBufferCreateInfo_host, sType) == FIELD_OFFSET(VkBufferCreateInfo, sType));
+C_ASSERT(FIELD_OFFSET(VkBufferCreateInfo_host, pNext) == FIELD_OFFSET(VkBufferCreateInfo, pNext));
+C_ASSERT(FIELD_OFFSET(VkBufferCreateInfo_host, flags) == FIELD_OFFSET(VkBufferCreateInfo, flags));
+C_ASSERT(FIELD_OFFSET(VkBufferCreateInfo_host, size) == FIELD_OFFSET(VkBufferCreateInfo, size));
+C_ASSERT(FIELD_OFFSET(VkBufferCreateInfo_host, usage) == FIELD_OFFSET(VkBufferCreateInfo, usage));
+C_ASSERT(FIELD_OFFSET(VkBufferCreateInfo_host, sharingMode) == FIELD_OFFSET(VkBufferCreateInfo, sharingMode));
+C_ASSERT(FIELD_OFFSET(VkBufferCreateInfo_host, queueFamilyIndexCount) == FIELD_OFFSET(VkBufferCreateInfo, queueFamilyIndexCount));
+C_ASSERT(FIELD_OFFSET(VkBufferCreateInfo_host, pQueueFamilyIndices) == FIELD_OFFSET(VkBufferCreateInfo, pQueueFamilyIndices));
+C_ASSERT(sizeof(VkBufferViewCreateInfo_host) == sizeof(VkBufferViewCreateInfo));
+C_ASSERT(FIELD_OFFSET(VkBufferViewCreateInfo_host, sType) == FIELD_OFFSET(VkBufferViewCreateInfo, sType));
+C_ASSERT(FIELD_OFFSET(VkBufferViewCreateInfo_host, pNext) == FIELD_OFFSET(VkBufferViewCreateInfo, pNext));
+C_ASSERT(FIELD_OFFSET(VkBufferViewCreateInfo_host, flags) == FIELD_OFFSET(VkBufferViewCreateInfo, flags));
+C_ASSERT(FIELD_OFFSET(VkBufferViewCreateInfo_host, buffer) == FIELD_OFFSET(VkBufferViewCreateInfo, buffer));
+C_ASSERT(FIELD_OFFSET(VkBufferViewCreateInfo_host, format) == FIELD_OFFSET(VkBufferViewCreateInfo, format));
+C_ASSERT(FIELD_OFFSET(VkBufferViewCreateInfo_host, offset) == FIELD_OFFSET(VkBufferViewCreateInfo, offset));
+C_ASSERT(FIELD_OFFSET(VkBufferViewCreateInfo_host, range) == FIELD_OFFSET(VkBufferViewCreateInfo, range));
+C_ASSERT(sizeof(VkPipelineShaderStageCreateInfo_host) == sizeof(VkPipelineShaderStageCreateInfo));
+C_ASSERT(FIELD_OFFSET(VkPipelineShaderStageCreateInfo_host, sType) == FIELD_OFFSET(VkPipelineShaderStageCreateInfo, sType));
+C_ASSERT(FIELD_OFFSET(VkPipelineShaderStageCreateInfo_host, pNext) == FIELD_OFFSET(VkPipelineShaderStageCreateInfo, pNext));
+C_ASSERT(FIELD_OFFSET(VkPipelineShaderStageCreateInfo_host, flags) == FIELD_OFFSET(VkPipelineShaderStageCreateInfo, flags));
+C_ASSERT(FIELD_OFFSET(VkPipelineShaderStageCreateInfo_host, stage) == FIELD_OFFSET(VkPipelineShaderStageCreateInfo, stage));
+C_ASSERT(FIELD_OFFSET(VkPipelineShaderStageCreateInfo_host, module) == FIELD_OFFSET(VkPipelineShaderStageCreateInfo, module));
+C_ASSERT(FIELD_OFFSET(VkPipelineShaderStageCreateInfo_host, pName) == FIELD_OFFSET(VkPipelineShaderStageCreateInfo, pName));
+C_ASSERT(FIELD_OFFSET(VkPipelineShaderStageCreateInfo_host, pSpecializationInfo) == FIELD_OFFSET(VkPipelineShaderStageCreateInfo, pSpecializationInfo));
+C_ASSERT(sizeof(VkComputePipelineCreateInfo_host) == sizeof(VkComputePipelineCreateInfo));
+C_ASSERT(FIELD_OFFSET(VkComputePipelineCreateInfo_host, sType) == FIELD_OFFSET(VkComputePipelineCreateInfo, sType));
+C_ASSERT(FIELD_OFFSET(VkComputePipelineCreateInfo_host, pNext) == FIELD_OFFSET(VkComputePipelineCreateInfo, pNext));
+C_ASSERT(FIELD_OFFSET(VkComputePipelineCreateInfo_host, flags) == FIELD_OFFSET(VkComputePipelineCreateInfo, flags));
+C_ASSERT(FIELD_OFFSET(VkComputePipelineCreateInfo_host, stage) == FIELD_OFFSET(VkComputePipelineCreateInfo, stage));
+C_ASSERT(FIELD_OFFSET(VkComputePipelineCreateInfo_host, layout) == FIELD_OFFSET(VkComputePipelineCreateInfo, layout));
+C_ASSERT(FIELD_OFFSET(VkComputePipelineCreateInfo_host, basePipelineHandle) == FIELD_OFFSET(VkComputePipelineCreateInfo, basePipelineHandle));
+C_ASSERT(FIELD_OFFSET(VkComputePipelineCreateInfo_host, basePipelineIndex) == FIELD_OFFSET(VkComputePipelineCreateInfo, basePipelineIndex));
+C_ASSERT(sizeof(VkDescriptorUpdateTemplateCreateInfo_host) == sizeof(VkDescriptorUpdateTemplateCreateInfo));
+C_ASSERT(FIELD_OFFSET(VkDescriptorUpdateTemplateCreateInfo_host, sType) == FIELD_OFFSET(VkDescriptorUpdateTemplateCreateInfo, sType));
+C_ASSERT(FIELD_OFFSET(VkDescriptorUpdateTemplateCreateInfo_host, pNext) == FIELD_OFFSET(VkDescriptorUpdateTemplateCreateInfo, pNext));
+C_ASSERT(FIELD_OFFSET(VkDescriptorUpdateTemplateCreateInfo_host, flags) == FIELD_OFFSET(VkDescriptorUpdateTemplateCreateInfo, flags));
+C_ASSERT(FIELD_OFFSET(VkDescriptorUpdateTemplateCreateInfo_host, descriptorUpdateEntryCount) == FIELD_OFFSET(VkDescriptorUpdateTemplateCreateInfo, descriptorUpdateEntryCount));
+C_ASSERT(FIELD_OFFSET(VkDescriptorUpdateTemplateCreateInfo_host, pDescriptorUpdateEntries) == FIELD_OFFSET(VkDescriptorUpdateTemplateCreateInfo, pDescriptorUpdateEntries));
+C_ASSERT(FIELD_OFFSET(VkDescriptorUpdateTemplateCreateInfo_host, templateType) == FIELD_OFFSET(VkDescriptorUpdateTemplateCreateInfo, templateType));
+C_ASSERT(FIELD_OFFSET(VkDescriptorUpdateTemplateCreateInfo_host, descriptorSetLayout) == FIELD_OFFSET(VkDescriptorUpdateTemplateCreateInfo, descriptorSetLayout));
+C_ASSERT(FIELD_OFFSET(VkDescriptorUpdateTemplateCreateInfo_host, pipelineBindPoint) == FIELD_OFFSET(VkDescriptorUpdateTemplateCreateInfo, pipelineBindPoint));
+C_ASSERT(FIELD_OFFSET(VkDescriptorUpdateTemplateCreateInfo_host, pipelineLayout) == FIELD_OFFSET(VkDescriptorUpdateTemplateCreateInfo, pipelineLayout));
+C_ASSERT(FIELD_OFFSET(VkDescriptorUpdateTemplateCreateInfo_host, set) == FIELD_OFFSET(VkDescriptorUpdateTemplateCreateInfo, set));
+C_ASSERT(sizeof(VkFramebufferCreateInfo_host) == sizeof(VkFramebufferCreateInfo));
+C_ASSERT(FIELD_OFFSET(VkFramebufferCreateInfo_host, sType) == FIELD_OFFSET(VkFramebufferCreateInfo, sType));
+C_ASSERT(FIELD_OFFSET(VkFramebufferCreateInfo_host, pNext) == FIELD_OFFSET(VkFramebufferCreateInfo, pNext));
+C_ASSERT(FIELD_OFFSET(VkFramebufferCreateInfo_host, flags) == FIELD_OFFSET(VkFramebufferCreateInfo, flags));
+C_ASSERT(FIELD_OFFSET(VkFramebufferCreateInfo_host, renderPass) == FIELD_OFFSET(VkFramebufferCreateInfo, renderPass));
+C_ASSERT(FIELD_OFFSET(VkFramebufferCreateInfo_host, attachmentCount) == FIELD_OFFSET(VkFramebufferCreateInfo, attachmentCount));
+C_ASSERT(FIELD_OFFSET(VkFramebufferCreateInfo_host, pAttachments) == FIELD_OFFSET(VkFramebufferCreateInfo, pAttachments));
+C_ASSERT(FIELD_OFFSET(VkFramebufferCreateInfo_host, width) == FIELD_OFFSET(VkFramebufferCreateInfo, width));
+C_ASSERT(FIELD_OFFSET(VkFramebufferCreateInfo_host, height) == FIELD_OFFSET(VkFramebufferCreateInfo, height));
+C_ASSERT(FIELD_OFFSET(VkFramebufferCreateInfo_host, layers) == FIELD_OFFSET(VkFramebufferCreateInfo, layers));
+C_ASSERT(sizeof(VkGraphicsPipelineCreateInfo_host) == sizeof(VkGraphicsPipelineCreateInfo));
+C_ASSERT(FIELD_OFFSET(VkGraphicsPipelineCreateInfo_host, sType) == FIELD_OFFSET(VkGraphicsPipelineCreateInfo, sType));
+C_ASSERT(FIELD_OFFSET(VkGraphicsPipelineCreateInfo_host, pNext) == FIELD_OFFSET(VkGraphicsPipelineCreateInfo, pNext));
+C_ASSERT(FIELD_OFFSET(VkGraphicsPipelineCreateInfo_host, flags) == FIELD_OFFSET(VkGraphicsPipelineCreateInfo, flags));
+C_ASSERT(FIELD_OFFSET(VkGraphicsPipelineCreateInfo_host, stageCount) == FIELD_OFFSET(VkGraphicsPipelineCreateInfo, stageCount));
+C_ASSERT(FIELD_OFFSET(VkGraphicsPipelineCreateInfo_host, pStages) == FIELD_OFFSET(VkGraphicsPipelineCreateInfo, pStages));
+C_ASSERT(FIELD_OFFSET(VkGraphicsPipelineCreateInfo_host, pVertexInputState) == FIELD_OFFSET(VkGraphicsPipelineCreateInfo, pVertexInputState));
+C_ASSERT(FIELD_OFFSET(VkGraphicsPipelineCreateInfo_host, pInputAssemblyState) == FIELD_OFFSET(VkGraphicsPipelineCreateInfo, pInputAssemblyState));
+C_ASSERT(FIELD_OFFSET(VkGraphicsPipelineCreateInfo_host, pTessellationState) == FIELD_OFFSET(VkGraphicsPipelineCreateInfo, pTessellationState));
+C_ASSERT(FIELD_OFFSET(VkGraphicsPipelineCreateInfo_host, pViewportState) == FIELD_OFFSET(VkGraphicsPipelineCreateInfo, pViewportState));
+C_ASSERT(FIELD_OFFSET(VkGraphicsPipelineCreateInfo_host, pRasterizationState) == FIELD_OFFSET(VkGraphicsPipelineCreateInfo, pRasterizationState));
+C_ASSERT(FIELD_OFFSET(VkGraphicsPipelineCreateInfo_host, pMultisampleState) == FIELD_OFFSET(VkGraphicsPipelineCreateInfo, pMultisampleState));
+C_ASSERT(FIELD_OFFSET(VkGraphicsPipelineCreateInfo_host, pDepthStencilState) == FIELD_OFFSET(VkGraphicsPipelineCreateInfo, pDepthStencilState));
+C_ASSERT(FIELD_OFFSET(VkGraphicsPipelineCreateInfo_host, pColorBlendState) == FIELD_OFFSET(VkGraphicsPipelineCreateInfo, pColorBlendState));
+C_ASSERT(FIELD_OFFSET(VkGraphicsPipelineCreateInfo_host, pDynamicState) == FIELD_OFFSET(VkGraphicsPipelineCreateInfo, pDynamicState));
+C_ASSERT(FIELD_OFFSET(VkGraphicsPipelineCreateInfo_host, layout) == FIELD_OFFSET(VkGraphicsPipelineCreateInfo, layout));
+C_ASSERT(FIELD_OFFSET(VkGraphicsPipelineCreateInfo_host, renderPass) == FIELD_OFFSET(VkGraphicsPipelineCreateInfo, renderPass));
+C_ASSERT(FIELD_OFFSET(VkGraphicsPipelineCreateInfo_host, subpass) == FIELD_OFFSET(VkGraphicsPipelineCreateInfo, subpass));
+C_ASSERT(FIELD_OFFSET(VkGraphicsPipelineCreateInfo_host, basePipelineHandle) == FIELD_OFFSET(VkGraphicsPipelineCreateInfo, basePipelineHandle));
+C_ASSERT(FIELD_OFFSET(VkGraphicsPipelineCreateInfo_host, basePipelineIndex) == FIELD_OFFSET(VkGraphicsPipelineCreateInfo, basePipelineIndex));
+C_ASSERT(sizeof(VkImageViewCreateInfo_host) == sizeof(VkImageViewCreateInfo));
+C_ASSERT(FIELD_OFFSET(VkImageViewCreateInfo_host, sType) == FIELD_OFFSET(VkImageViewCreateInfo, sType));
+C_ASSERT(FIELD_OFFSET(VkImageViewCreateInfo_host, pNext) == FIELD_OFFSET(VkImageViewCreateInfo, pNext));
+C_ASSERT(FIELD_OFFSET(VkImageViewCreateInfo_host, flags) == FIELD_OFFSET(VkImageViewCreateInfo, flags));
+C_ASSERT(FIELD_OFFSET(VkImageViewCreateInfo_host, image) == FIELD_OFFSET(VkImageViewCreateInfo, image));
+C_ASSERT(FIELD_OFFSET(VkImageViewCreateInfo_host, viewType) == FIELD_OFFSET(VkImageViewCreateInfo, viewType));
+C_ASSERT(FIELD_OFFSET(VkImageViewCreateInfo_host, format) == FIELD_OFFSET(VkImageViewCreateInfo, format));
+C_ASSERT(FIELD_OFFSET(VkImageViewCreateInfo_host, components) == FIELD_OFFSET(VkImageViewCreateInfo, components));
+C_ASSERT(FIELD_OFFSET(VkImageViewCreateInfo_host, subresourceRange) == FIELD_OFFSET(VkImageViewCreateInfo, subresourceRange));
+C_ASSERT(sizeof(VkSwapchainCreateInfoKHR_host) == sizeof(VkSwapchainCreateInfoKHR));
+C_ASSERT(FIELD_OFFSET(VkSwapchainCreateInfoKHR_host, sType) == FIELD_OFFSET(VkSwapchainCreateInfoKHR, sType));
+C_ASSERT(FIELD_OFFSET(VkSwapchainCreateInfoKHR_host, pNext) == FIELD_OFFSET(VkSwapchainCreateInfoKHR, pNext));
+C_ASSERT(FIELD_OFFSET(VkSwapchainCreateInfoKHR_host, flags) == FIELD_OFFSET(VkSwapchainCreateInfoKHR, flags));
+C_ASSERT(FIELD_OFFSET(VkSwapchainCreateInfoKHR_host, surface) == FIELD_OFFSET(VkSwapchainCreateInfoKHR, surface));
+C_ASSERT(FIELD_OFFSET(VkSwapchainCreateInfoKHR_host, minImageCount) == FIELD_OFFSET(VkSwapchainCreateInfoKHR, minImageCount));
+C_ASSERT(FIELD_OFFSET(VkSwapchainCreateInfoKHR_host, imageFormat) == FIELD_OFFSET(VkSwapchainCreateInfoKHR, imageFormat));
+C_ASSERT(FIELD_OFFSET(VkSwapchainCreateInfoKHR_host, imageColorSpace) == FIELD_OFFSET(VkSwapchainCreateInfoKHR, imageColorSpace));
+C_ASSERT(FIELD_OFFSET(VkSwapchainCreateInfoKHR_host, imageExtent) == FIELD_OFFSET(VkSwapchainCreateInfoKHR, imageExtent));
+C_ASSERT(FIELD_OFFSET(VkSwapchainCreateInfoKHR_host, imageArrayLayers) == FIELD_OFFSET(VkSwapchainCreateInfoKHR, imageArrayLayers));
+C_ASSERT(FIELD_OFFSET(VkSwapchainCreateInfoKHR_host, imageUsage) == FIELD_OFFSET(VkSwapchainCreateInfoKHR, imageUsage));
+C_ASSERT(FIELD_OFFSET(VkSwapchainCreateInfoKHR_host, imageSharingMode) == FIELD_OFFSET(VkSwapchainCreateInfoKHR, imageSharingMode));
+C_ASSERT(FIELD_OFFSET(VkSwapchainCreateInfoKHR_host, queueFamilyIndexCount) == FIELD_OFFSET(VkSwapchainCreateInfoKHR, queueFamilyIndexCount));
+C_ASSERT(FIELD_OFFSET(VkSwapchainCreateInfoKHR_host, pQueueFamilyIndices) == FIELD_OFFSET(VkSwapchainCreateInfoKHR, pQueueFamilyIndices));
+C_ASSERT(FIELD_OFFSET(VkSwapchainCreateInfoKHR_host, preTransform) == FIELD_OFFSET(VkSwapchainCreateInfoKHR, preTransform));
+C_ASSERT(FIELD_OFFSET(VkSwapchainCreateInfoKHR_host, compositeAlpha) == FIELD_OFFSET(VkSwapchainCreateInfoKHR, compositeAlpha));
+C_ASSERT(FIELD_OFFSET(VkSwapchainCreateInfoKHR_host, presentMode) == FIELD_OFFSET(VkSwapchainCreateInfoKHR, presentMode));
+C_ASSERT(FIELD_OFFSET(VkSwapchainCreateInfoKHR_host, clipped) == FIELD_OFFSET(VkSwapchainCreateInfoKHR, clipped));
+C_ASSERT(FIELD_OFFSET(VkSwapchainCreateInfoKHR_host, oldSwapchain) == FIELD_OFFSET(VkSwapchainCreateInfoKHR, oldSwapchain));
+C_ASSERT(sizeof(VkMappedMemoryRange_host) == sizeof(VkMappedMemoryRange));
+C_ASSERT(FIELD_OFFSET(VkMappedMemoryRange_host, sType) == FIELD_OFFSET(VkMappedMemoryRange, sType));
+C_ASSERT(FIELD_OFFSET(VkMappedMemoryRange_host, pNext) == FIELD_OFFSET(VkMappedMemoryRange, pNext));
+C_ASSERT(FIELD_OFFSET(VkMappedMemoryRange_host, memory) == FIELD_OFFSET(VkMappedMemoryRange, memory));
+C_ASSERT(FIELD_OFFSET(VkMappedMemoryRange_host, offset) == FIELD_OFFSET(VkMappedMemoryRange, offset));
+C_ASSERT(FIELD_OFFSET(VkMappedMemoryRange_host, size) == FIELD_OFFSET(VkMappedMemoryRange, size));
+C_ASSERT(sizeof(VkMemoryRequirements_host) == sizeof(VkMemoryRequirements));
+C_ASSERT(FIELD_OFFSET(VkMemoryRequirements_host, size) == FIELD_OFFSET(VkMemoryRequirements, size));
+C_ASSERT(FIELD_OFFSET(VkMemoryRequirements_host, alignment) == FIELD_OFFSET(VkMemoryRequirements, alignment));
+C_ASSERT(FIELD_OFFSET(VkMemoryRequirements_host, memoryTypeBits) == FIELD_OFFSET(VkMemoryRequirements, memoryTypeBits));
+C_ASSERT(sizeof(VkBufferMemoryRequirementsInfo2_host) == sizeof(VkBufferMemoryRequirementsInfo2));
+C_ASSERT(FIELD_OFFSET(VkBufferMemoryRequirementsInfo2_host, sType) == FIELD_OFFSET(VkBufferMemoryRequirementsInfo2, sType));
+C_ASSERT(FIELD_OFFSET(VkBufferMemoryRequirementsInfo2_host, pNext) == FIELD_OFFSET(VkBufferMemoryRequirementsInfo2, pNext));
+C_ASSERT(FIELD_OFFSET(VkBufferMemoryRequirementsInfo2_host, buffer) == FIELD_OFFSET(VkBufferMemoryRequirementsInfo2, buffer));
+C_ASSERT(sizeof(VkMemoryRequirements2_host) == sizeof(VkMemoryRequirements2));
+C_ASSERT(FIELD_OFFSET(VkMemoryRequirements2_host, sType) == FIELD_OFFSET(VkMemoryRequirements2, sType));
+C_ASSERT(FIELD_OFFSET(VkMemoryRequirements2_host, pNext) == FIELD_OFFSET(VkMemoryRequirements2, pNext));
+C_ASSERT(FIELD_OFFSET(VkMemoryRequirements2_host, memoryRequirements) == FIELD_OFFSET(VkMemoryRequirements2, memoryRequirements));
+C_ASSERT(sizeof(VkImageMemoryRequirementsInfo2_host) == sizeof(VkImageMemoryRequirementsInfo2));
+C_ASSERT(FIELD_OFFSET(VkImageMemoryRequirementsInfo2_host, sType) == FIELD_OFFSET(VkImageMemoryRequirementsInfo2, sType));
+C_ASSERT(FIELD_OFFSET(VkImageMemoryRequirementsInfo2_host, pNext) == FIELD_OFFSET(VkImageMemoryRequirementsInfo2, pNext));
+C_ASSERT(FIELD_OFFSET(VkImageMemoryRequirementsInfo2_host, image) == FIELD_OFFSET(VkImageMemoryRequirementsInfo2, image));
+C_ASSERT(sizeof(VkImageSparseMemoryRequirementsInfo2_host) == sizeof(VkImageSparseMemoryRequirementsInfo2));
+C_ASSERT(FIELD_OFFSET(VkImageSparseMemoryRequirementsInfo2_host, sType) == FIELD_OFFSET(VkImageSparseMemoryRequirementsInfo2, sType));
+C_ASSERT(FIELD_OFFSET(VkImageSparseMemoryRequirementsInfo2_host, pNext) == FIELD_OFFSET(VkImageSparseMemoryRequirementsInfo2, pNext));
+C_ASSERT(FIELD_OFFSET(VkImageSparseMemoryRequirementsInfo2_host, image) == FIELD_OFFSET(VkImageSparseMemoryRequirementsInfo2, image));
+C_ASSERT(sizeof(VkSubresourceLayout_host) == sizeof(VkSubresourceLayout));
+C_ASSERT(FIELD_OFFSET(VkSubresourceLayout_host, offset) == FIELD_OFFSET(VkSubresourceLayout, offset));
+C_ASSERT(FIELD_OFFSET(VkSubresourceLayout_host, size) == FIELD_OFFSET(VkSubresourceLayout, size));
+C_ASSERT(FIELD_OFFSET(VkSubresourceLayout_host, rowPitch) == FIELD_OFFSET(VkSubresourceLayout, rowPitch));
+C_ASSERT(FIELD_OFFSET(VkSubresourceLayout_host, arrayPitch) == FIELD_OFFSET(VkSubresourceLayout, arrayPitch));
+C_ASSERT(FIELD_OFFSET(VkSubresourceLayout_host, depthPitch) == FIELD_OFFSET(VkSubresourceLayout, depthPitch));
+C_ASSERT(sizeof(VkImageFormatProperties_host) == sizeof(VkImageFormatProperties));
+C_ASSERT(FIELD_OFFSET(VkImageFormatProperties_host, maxExtent) == FIELD_OFFSET(VkImageFormatProperties, maxExtent));
+C_ASSERT(FIELD_OFFSET(VkImageFormatProperties_host, maxMipLevels) == FIELD_OFFSET(VkImageFormatProperties, maxMipLevels));
+C_ASSERT(FIELD_OFFSET(VkImageFormatProperties_host, maxArrayLayers) == FIELD_OFFSET(VkImageFormatProperties, maxArrayLayers));
+C_ASSERT(FIELD_OFFSET(VkImageFormatProperties_host, sampleCounts) == FIELD_OFFSET(VkImageFormatProperties, sampleCounts));
+C_ASSERT(FIELD_OFFSET(VkImageFormatProperties_host, maxResourceSize) == FIELD_OFFSET(VkImageFormatProperties, maxResourceSize));
+C_ASSERT(sizeof(VkImageFormatProperties2_host) == sizeof(VkImageFormatProperties2));
+C_ASSERT(FIELD_OFFSET(VkImageFormatProperties2_host, sType) == FIELD_OFFSET(VkImageFormatProperties2, sType));
+C_ASSERT(FIELD_OFFSET(VkImageFormatProperties2_host, pNext) == FIELD_OFFSET(VkImageFormatProperties2, pNext));
+C_ASSERT(FIELD_OFFSET(VkImageFormatProperties2_host, imageFormatProperties) == FIELD_OFFSET(VkImageFormatProperties2, imageFormatProperties));
+C_ASSERT(sizeof(VkMemoryHeap_host) == sizeof(VkMemoryHeap));
+C_ASSERT(FIELD_OFFSET(VkMemoryHeap_host, size) == FIELD_OFFSET(VkMemoryHeap, size));
+C_ASSERT(FIELD_OFFSET(VkMemoryHeap_host, flags) == FIELD_OFFSET(VkMemoryHeap, flags));
+C_ASSERT(sizeof(VkPhysicalDeviceMemoryProperties_host) == sizeof(VkPhysicalDeviceMemoryProperties));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceMemoryProperties_host, memoryTypeCount) == FIELD_OFFSET(VkPhysicalDeviceMemoryProperties, memoryTypeCount));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceMemoryProperties_host, memoryTypes) == FIELD_OFFSET(VkPhysicalDeviceMemoryProperties, memoryTypes));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceMemoryProperties_host, memoryHeapCount) == FIELD_OFFSET(VkPhysicalDeviceMemoryProperties, memoryHeapCount));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceMemoryProperties_host, memoryHeaps) == FIELD_OFFSET(VkPhysicalDeviceMemoryProperties, memoryHeaps));
+C_ASSERT(sizeof(VkPhysicalDeviceMemoryProperties2_host) == sizeof(VkPhysicalDeviceMemoryProperties2));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceMemoryProperties2_host, sType) == FIELD_OFFSET(VkPhysicalDeviceMemoryProperties2, sType));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceMemoryProperties2_host, pNext) == FIELD_OFFSET(VkPhysicalDeviceMemoryProperties2, pNext));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceMemoryProperties2_host, memoryProperties) == FIELD_OFFSET(VkPhysicalDeviceMemoryProperties2, memoryProperties));
+C_ASSERT(sizeof(VkPhysicalDeviceLimits_host) == sizeof(VkPhysicalDeviceLimits));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxImageDimension1D) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxImageDimension1D));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxImageDimension2D) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxImageDimension2D));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxImageDimension3D) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxImageDimension3D));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxImageDimensionCube) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxImageDimensionCube));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxImageArrayLayers) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxImageArrayLayers));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxTexelBufferElements) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxTexelBufferElements));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxUniformBufferRange) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxUniformBufferRange));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxStorageBufferRange) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxStorageBufferRange));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxPushConstantsSize) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxPushConstantsSize));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxMemoryAllocationCount) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxMemoryAllocationCount));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxSamplerAllocationCount) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxSamplerAllocationCount));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, bufferImageGranularity) == FIELD_OFFSET(VkPhysicalDeviceLimits, bufferImageGranularity));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, sparseAddressSpaceSize) == FIELD_OFFSET(VkPhysicalDeviceLimits, sparseAddressSpaceSize));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxBoundDescriptorSets) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxBoundDescriptorSets));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxPerStageDescriptorSamplers) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxPerStageDescriptorSamplers));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxPerStageDescriptorUniformBuffers) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxPerStageDescriptorUniformBuffers));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxPerStageDescriptorStorageBuffers) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxPerStageDescriptorStorageBuffers));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxPerStageDescriptorSampledImages) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxPerStageDescriptorSampledImages));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxPerStageDescriptorStorageImages) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxPerStageDescriptorStorageImages));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxPerStageDescriptorInputAttachments) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxPerStageDescriptorInputAttachments));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxPerStageResources) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxPerStageResources));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxDescriptorSetSamplers) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxDescriptorSetSamplers));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxDescriptorSetUniformBuffers) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxDescriptorSetUniformBuffers));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxDescriptorSetUniformBuffersDynamic) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxDescriptorSetUniformBuffersDynamic));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxDescriptorSetStorageBuffers) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxDescriptorSetStorageBuffers));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxDescriptorSetStorageBuffersDynamic) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxDescriptorSetStorageBuffersDynamic));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxDescriptorSetSampledImages) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxDescriptorSetSampledImages));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxDescriptorSetStorageImages) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxDescriptorSetStorageImages));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxDescriptorSetInputAttachments) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxDescriptorSetInputAttachments));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxVertexInputAttributes) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxVertexInputAttributes));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxVertexInputBindings) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxVertexInputBindings));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxVertexInputAttributeOffset) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxVertexInputAttributeOffset));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxVertexInputBindingStride) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxVertexInputBindingStride));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxVertexOutputComponents) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxVertexOutputComponents));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxTessellationGenerationLevel) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxTessellationGenerationLevel));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxTessellationPatchSize) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxTessellationPatchSize));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxTessellationControlPerVertexInputComponents) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxTessellationControlPerVertexInputComponents));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxTessellationControlPerVertexOutputComponents) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxTessellationControlPerVertexOutputComponents));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxTessellationControlPerPatchOutputComponents) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxTessellationControlPerPatchOutputComponents));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxTessellationControlTotalOutputComponents) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxTessellationControlTotalOutputComponents));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxTessellationEvaluationInputComponents) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxTessellationEvaluationInputComponents));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxTessellationEvaluationOutputComponents) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxTessellationEvaluationOutputComponents));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxGeometryShaderInvocations) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxGeometryShaderInvocations));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxGeometryInputComponents) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxGeometryInputComponents));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxGeometryOutputComponents) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxGeometryOutputComponents));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxGeometryOutputVertices) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxGeometryOutputVertices));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxGeometryTotalOutputComponents) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxGeometryTotalOutputComponents));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxFragmentInputComponents) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxFragmentInputComponents));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxFragmentOutputAttachments) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxFragmentOutputAttachments));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxFragmentDualSrcAttachments) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxFragmentDualSrcAttachments));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxFragmentCombinedOutputResources) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxFragmentCombinedOutputResources));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxComputeSharedMemorySize) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxComputeSharedMemorySize));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxComputeWorkGroupCount) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxComputeWorkGroupCount));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxComputeWorkGroupInvocations) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxComputeWorkGroupInvocations));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxComputeWorkGroupSize) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxComputeWorkGroupSize));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, subPixelPrecisionBits) == FIELD_OFFSET(VkPhysicalDeviceLimits, subPixelPrecisionBits));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, subTexelPrecisionBits) == FIELD_OFFSET(VkPhysicalDeviceLimits, subTexelPrecisionBits));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, mipmapPrecisionBits) == FIELD_OFFSET(VkPhysicalDeviceLimits, mipmapPrecisionBits));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxDrawIndexedIndexValue) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxDrawIndexedIndexValue));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxDrawIndirectCount) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxDrawIndirectCount));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxSamplerLodBias) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxSamplerLodBias));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxSamplerAnisotropy) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxSamplerAnisotropy));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxViewports) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxViewports));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxViewportDimensions) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxViewportDimensions));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, viewportBoundsRange) == FIELD_OFFSET(VkPhysicalDeviceLimits, viewportBoundsRange));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, viewportSubPixelBits) == FIELD_OFFSET(VkPhysicalDeviceLimits, viewportSubPixelBits));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, minMemoryMapAlignment) == FIELD_OFFSET(VkPhysicalDeviceLimits, minMemoryMapAlignment));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, minTexelBufferOffsetAlignment) == FIELD_OFFSET(VkPhysicalDeviceLimits, minTexelBufferOffsetAlignment));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, minUniformBufferOffsetAlignment) == FIELD_OFFSET(VkPhysicalDeviceLimits, minUniformBufferOffsetAlignment));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, minStorageBufferOffsetAlignment) == FIELD_OFFSET(VkPhysicalDeviceLimits, minStorageBufferOffsetAlignment));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, minTexelOffset) == FIELD_OFFSET(VkPhysicalDeviceLimits, minTexelOffset));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxTexelOffset) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxTexelOffset));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, minTexelGatherOffset) == FIELD_OFFSET(VkPhysicalDeviceLimits, minTexelGatherOffset));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxTexelGatherOffset) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxTexelGatherOffset));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, minInterpolationOffset) == FIELD_OFFSET(VkPhysicalDeviceLimits, minInterpolationOffset));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxInterpolationOffset) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxInterpolationOffset));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, subPixelInterpolationOffsetBits) == FIELD_OFFSET(VkPhysicalDeviceLimits, subPixelInterpolationOffsetBits));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxFramebufferWidth) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxFramebufferWidth));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxFramebufferHeight) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxFramebufferHeight));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxFramebufferLayers) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxFramebufferLayers));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, framebufferColorSampleCounts) == FIELD_OFFSET(VkPhysicalDeviceLimits, framebufferColorSampleCounts));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, framebufferDepthSampleCounts) == FIELD_OFFSET(VkPhysicalDeviceLimits, framebufferDepthSampleCounts));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, framebufferStencilSampleCounts) == FIELD_OFFSET(VkPhysicalDeviceLimits, framebufferStencilSampleCounts));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, framebufferNoAttachmentsSampleCounts) == FIELD_OFFSET(VkPhysicalDeviceLimits, framebufferNoAttachmentsSampleCounts));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxColorAttachments) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxColorAttachments));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, sampledImageColorSampleCounts) == FIELD_OFFSET(VkPhysicalDeviceLimits, sampledImageColorSampleCounts));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, sampledImageIntegerSampleCounts) == FIELD_OFFSET(VkPhysicalDeviceLimits, sampledImageIntegerSampleCounts));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, sampledImageDepthSampleCounts) == FIELD_OFFSET(VkPhysicalDeviceLimits, sampledImageDepthSampleCounts));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, sampledImageStencilSampleCounts) == FIELD_OFFSET(VkPhysicalDeviceLimits, sampledImageStencilSampleCounts));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, storageImageSampleCounts) == FIELD_OFFSET(VkPhysicalDeviceLimits, storageImageSampleCounts));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxSampleMaskWords) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxSampleMaskWords));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, timestampComputeAndGraphics) == FIELD_OFFSET(VkPhysicalDeviceLimits, timestampComputeAndGraphics));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, timestampPeriod) == FIELD_OFFSET(VkPhysicalDeviceLimits, timestampPeriod));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxClipDistances) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxClipDistances));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxCullDistances) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxCullDistances));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, maxCombinedClipAndCullDistances) == FIELD_OFFSET(VkPhysicalDeviceLimits, maxCombinedClipAndCullDistances));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, discreteQueuePriorities) == FIELD_OFFSET(VkPhysicalDeviceLimits, discreteQueuePriorities));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, pointSizeRange) == FIELD_OFFSET(VkPhysicalDeviceLimits, pointSizeRange));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, lineWidthRange) == FIELD_OFFSET(VkPhysicalDeviceLimits, lineWidthRange));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, pointSizeGranularity) == FIELD_OFFSET(VkPhysicalDeviceLimits, pointSizeGranularity));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, lineWidthGranularity) == FIELD_OFFSET(VkPhysicalDeviceLimits, lineWidthGranularity));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, strictLines) == FIELD_OFFSET(VkPhysicalDeviceLimits, strictLines));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, standardSampleLocations) == FIELD_OFFSET(VkPhysicalDeviceLimits, standardSampleLocations));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, optimalBufferCopyOffsetAlignment) == FIELD_OFFSET(VkPhysicalDeviceLimits, optimalBufferCopyOffsetAlignment));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, optimalBufferCopyRowPitchAlignment) == FIELD_OFFSET(VkPhysicalDeviceLimits, optimalBufferCopyRowPitchAlignment));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceLimits_host, nonCoherentAtomSize) == FIELD_OFFSET(VkPhysicalDeviceLimits, nonCoherentAtomSize));
+C_ASSERT(sizeof(VkPhysicalDeviceProperties_host) == sizeof(VkPhysicalDeviceProperties));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceProperties_host, apiVersion) == FIELD_OFFSET(VkPhysicalDeviceProperties, apiVersion));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceProperties_host, driverVersion) == FIELD_OFFSET(VkPhysicalDeviceProperties, driverVersion));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceProperties_host, vendorID) == FIELD_OFFSET(VkPhysicalDeviceProperties, vendorID));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceProperties_host, deviceID) == FIELD_OFFSET(VkPhysicalDeviceProperties, deviceID));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceProperties_host, deviceType) == FIELD_OFFSET(VkPhysicalDeviceProperties, deviceType));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceProperties_host, deviceName) == FIELD_OFFSET(VkPhysicalDeviceProperties, deviceName));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceProperties_host, pipelineCacheUUID) == FIELD_OFFSET(VkPhysicalDeviceProperties, pipelineCacheUUID));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceProperties_host, limits) == FIELD_OFFSET(VkPhysicalDeviceProperties, limits));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceProperties_host, sparseProperties) == FIELD_OFFSET(VkPhysicalDeviceProperties, sparseProperties));
+C_ASSERT(sizeof(VkPhysicalDeviceProperties2_host) == sizeof(VkPhysicalDeviceProperties2));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceProperties2_host, sType) == FIELD_OFFSET(VkPhysicalDeviceProperties2, sType));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceProperties2_host, pNext) == FIELD_OFFSET(VkPhysicalDeviceProperties2, pNext));
+C_ASSERT(FIELD_OFFSET(VkPhysicalDeviceProperties2_host, properties) == FIELD_OFFSET(VkPhysicalDeviceProperties2, properties));
+C_ASSERT(sizeof(VkSparseMemoryBind_host) == sizeof(VkSparseMemoryBind));
+C_ASSERT(FIELD_OFFSET(VkSparseMemoryBind_host, resourceOffset) == FIELD_OFFSET(VkSparseMemoryBind, resourceOffset));
+C_ASSERT(FIELD_OFFSET(VkSparseMemoryBind_host, size) == FIELD_OFFSET(VkSparseMemoryBind, size));
+C_ASSERT(FIELD_OFFSET(VkSparseMemoryBind_host, memory) == FIELD_OFFSET(VkSparseMemoryBind, memory));
+C_ASSERT(FIELD_OFFSET(VkSparseMemoryBind_host, memoryOffset) == FIELD_OFFSET(VkSparseMemoryBind, memoryOffset));
+C_ASSERT(FIELD_OFFSET(VkSparseMemoryBind_host, flags) == FIELD_OFFSET(VkSparseMemoryBind, flags));
+C_ASSERT(sizeof(VkSparseBufferMemoryBindInfo_host) == sizeof(VkSparseBufferMemoryBindInfo));
+C_ASSERT(FIELD_OFFSET(VkSparseBufferMemoryBindInfo_host, buffer) == FIELD_OFFSET(VkSparseBufferMemoryBindInfo, buffer));
+C_ASSERT(FIELD_OFFSET(VkSparseBufferMemoryBindInfo_host, bindCount) == FIELD_OFFSET(VkSparseBufferMemoryBindInfo, bindCount));
+C_ASSERT(FIELD_OFFSET(VkSparseBufferMemoryBindInfo_host, pBinds) == FIELD_OFFSET(VkSparseBufferMemoryBindInfo, pBinds));
+C_ASSERT(sizeof(VkSparseImageOpaqueMemoryBindInfo_host) == sizeof(VkSparseImageOpaqueMemoryBindInfo));
+C_ASSERT(FIELD_OFFSET(VkSparseImageOpaqueMemoryBindInfo_host, image) == FIELD_OFFSET(VkSparseImageOpaqueMemoryBindInfo, image));
+C_ASSERT(FIELD_OFFSET(VkSparseImageOpaqueMemoryBindInfo_host, bindCount) == FIELD_OFFSET(VkSparseImageOpaqueMemoryBindInfo, bindCount));
+C_ASSERT(FIELD_OFFSET(VkSparseImageOpaqueMemoryBindInfo_host, pBinds) == FIELD_OFFSET(VkSparseImageOpaqueMemoryBindInfo, pBinds));
+C_ASSERT(sizeof(VkSparseImageMemoryBind_host) == sizeof(VkSparseImageMemoryBind));
+C_ASSERT(FIELD_OFFSET(VkSparseImageMemoryBind_host, subresource) == FIELD_OFFSET(VkSparseImageMemoryBind, subresource));
+C_ASSERT(FIELD_OFFSET(VkSparseImageMemoryBind_host, offset) == FIELD_OFFSET(VkSparseImageMemoryBind, offset));
+C_ASSERT(FIELD_OFFSET(VkSparseImageMemoryBind_host, extent) == FIELD_OFFSET(VkSparseImageMemoryBind, extent));
+C_ASSERT(FIELD_OFFSET(VkSparseImageMemoryBind_host, memory) == FIELD_OFFSET(VkSparseImageMemoryBind, memory));
+C_ASSERT(FIELD_OFFSET(VkSparseImageMemoryBind_host, memoryOffset) == FIELD_OFFSET(VkSparseImageMemoryBind, memoryOffset));
+C_ASSERT(FIELD_OFFSET(VkSparseImageMemoryBind_host, flags) == FIELD_OFFSET(VkSparseImageMemoryBind, flags));
+C_ASSERT(sizeof(VkSparseImageMemoryBindInfo_host) == sizeof(VkSparseImageMemoryBindInfo));
+C_ASSERT(FIELD_OFFSET(VkSparseImageMemoryBindInfo_host, image) == FIELD_OFFSET(VkSparseImageMemoryBindInfo, image));
+C_ASSERT(FIELD_OFFSET(VkSparseImageMemoryBindInfo_host, bindCount) == FIELD_OFFSET(VkSparseImageMemoryBindInfo, bindCount));
+C_ASSERT(FIELD_OFFSET(VkSparseImageMemoryBindInfo_host, pBinds) == FIELD_OFFSET(VkSparseImageMemoryBindInfo, pBinds));
+C_ASSERT(sizeof(VkBindSparseInfo_host) == sizeof(VkBindSparseInfo));
+C_ASSERT(FIELD_OFFSET(VkBindSparseInfo_host, sType) == FIELD_OFFSET(VkBindSparseInfo, sType));
+C_ASSERT(FIELD_OFFSET(VkBindSparseInfo_host, pNext) == FIELD_OFFSET(VkBindSparseInfo, pNext));
+C_ASSERT(FIELD_OFFSET(VkBindSparseInfo_host, waitSemaphoreCount) == FIELD_OFFSET(VkBindSparseInfo, waitSemaphoreCount));
+C_ASSERT(FIELD_OFFSET(VkBindSparseInfo_host, pWaitSemaphores) == FIELD_OFFSET(VkBindSparseInfo, pWaitSemaphores));
+C_ASSERT(FIELD_OFFSET(VkBindSparseInfo_host, bufferBindCount) == FIELD_OFFSET(VkBindSparseInfo, bufferBindCount));
+C_ASSERT(FIELD_OFFSET(VkBindSparseInfo_host, pBufferBinds) == FIELD_OFFSET(VkBindSparseInfo, pBufferBinds));
+C_ASSERT(FIELD_OFFSET(VkBindSparseInfo_host, imageOpaqueBindCount) == FIELD_OFFSET(VkBindSparseInfo, imageOpaqueBindCount));
+C_ASSERT(FIELD_OFFSET(VkBindSparseInfo_host, pImageOpaqueBinds) == FIELD_OFFSET(VkBindSparseInfo, pImageOpaqueBinds));
+C_ASSERT(FIELD_OFFSET(VkBindSparseInfo_host, imageBindCount) == FIELD_OFFSET(VkBindSparseInfo, imageBindCount));
+C_ASSERT(FIELD_OFFSET(VkBindSparseInfo_host, pImageBinds) == FIELD_OFFSET(VkBindSparseInfo, pImageBinds));
+C_ASSERT(FIELD_OFFSET(VkBindSparseInfo_host, signalSemaphoreCount) == FIELD_OFFSET(VkBindSparseInfo, signalSemaphoreCount));
+C_ASSERT(FIELD_OFFSET(VkBindSparseInfo_host, pSignalSemaphores) == FIELD_OFFSET(VkBindSparseInfo, pSignalSemaphores));
+C_ASSERT(sizeof(VkCopyDescriptorSet_host) == sizeof(VkCopyDescriptorSet));
+C_ASSERT(FIELD_OFFSET(VkCopyDescriptorSet_host, sType) == FIELD_OFFSET(VkCopyDescriptorSet, sType));
+C_ASSERT(FIELD_OFFSET(VkCopyDescriptorSet_host, pNext) == FIELD_OFFSET(VkCopyDescriptorSet, pNext));
+C_ASSERT(FIELD_OFFSET(VkCopyDescriptorSet_host, srcSet) == FIELD_OFFSET(VkCopyDescriptorSet, srcSet));
+C_ASSERT(FIELD_OFFSET(VkCopyDescriptorSet_host, srcBinding) == FIELD_OFFSET(VkCopyDescriptorSet, srcBinding));
+C_ASSERT(FIELD_OFFSET(VkCopyDescriptorSet_host, srcArrayElement) == FIELD_OFFSET(VkCopyDescriptorSet, srcArrayElement));
+C_ASSERT(FIELD_OFFSET(VkCopyDescriptorSet_host, dstSet) == FIELD_OFFSET(VkCopyDescriptorSet, dstSet));
+C_ASSERT(FIELD_OFFSET(VkCopyDescriptorSet_host, dstBinding) == FIELD_OFFSET(VkCopyDescriptorSet, dstBinding));
+C_ASSERT(FIELD_OFFSET(VkCopyDescriptorSet_host, dstArrayElement) == FIELD_OFFSET(VkCopyDescriptorSet, dstArrayElement));
+C_ASSERT(FIELD_OFFSET(VkCopyDescriptorSet_host, descriptorCount) == FIELD_OFFSET(VkCopyDescriptorSet, descriptorCount));
+#endif /* USE_STRUCT_CONVERSION */
+
 VkResult WINAPI wine_vkAcquireNextImage2KHR(VkDevice device, const VkAcquireNextImageInfoKHR *pAcquireInfo, uint32_t *pImageIndex)
 {
 #if defined(USE_STRUCT_CONVERSION)
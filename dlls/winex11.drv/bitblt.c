@@ -1556,6 +1556,8 @@ DWORD get_pixmap_image( Pixmap pixmap, int width, int height, const XVisualInfo
 }
 
 
+#define MAX_SURFACE_DAMAGE 16
+
 struct x11drv_window_surface
 {
     struct window_surface header;
@@ -1569,6 +1571,9 @@ struct x11drv_window_surface
     COLORREF              color_key;
     HRGN                  region;
     void                 *bits;
+    RECT                  damage[MAX_SURFACE_DAMAGE];  /* damaged areas since the last flush */
+    int                   damage_count;
+    RECT                  damage_bounds;                /* union of the damaged areas */
 #ifdef HAVE_LIBXXSHM
     XShmSegmentInfo       shminfo;
 #endif
@@ -1886,14 +1891,96 @@ static void x11drv_surface_set_region( struct window_surface *window_surface, HR
 }
 
 /***********************************************************************
- *           x11drv_surface_flush
+ *           x11drv_surface_add_damage
  */
-static void x11drv_surface_flush( struct window_surface *window_surface )
+static void x11drv_surface_add_damage( struct window_surface *window_surface, const RECT *rect )
 {
     struct x11drv_window_surface *surface = get_x11_surface( window_surface );
+    RECT tmp;
+    int i, best = 0, area, best_area = INT_MAX;
+
+    add_bounds_rect( &surface->bounds, rect );
+    add_bounds_rect( &surface->damage_bounds, rect );
+
+    /* merge with an overlapping area, or with the one that grows least once the list is full */
+    for (i = 0; i < surface->damage_count; i++)
+    {
+        if (IntersectRect( &tmp, &surface->damage[i], rect )) break;
+        if (surface->damage_count < MAX_SURFACE_DAMAGE) continue;
+        UnionRect( &tmp, &surface->damage[i], rect );
+        area = (tmp.right - tmp.left) * (tmp.bottom - tmp.top) -
+               (surface->damage[i].right - surface->damage[i].left) *
+               (surface->damage[i].bottom - surface->damage[i].top);
+        if (area < best_area)
+        {
+            best_area = area;
+            best = i;
+        }
+    }
+    if (i < surface->damage_count) UnionRect( &surface->damage[i], &surface->damage[i], rect );
+    else if (surface->damage_count < MAX_SURFACE_DAMAGE) surface->damage[surface->damage_count++] = *rect;
+    else UnionRect( &surface->damage[best], &surface->damage[best], rect );
+}
+
+/***********************************************************************
+ *           flush_surface_rect
+ *
+ * Converts the bits of a surface area if needed and sends them to the window.
+ */
+static void flush_surface_rect( struct x11drv_window_surface *surface, const RECT *rect )
+{
     unsigned char *src = surface->bits;
     unsigned char *dst = (unsigned char *)surface->image->data;
+
+    if (src != dst)
+    {
+        const int *mapping = NULL;
+        int width_bytes = surface->image->bytes_per_line;
+
+        if (surface->image->bits_per_pixel == 4 || surface->image->bits_per_pixel == 8)
+            mapping = X11DRV_PALETTE_PaletteToXPixel;
+
+        src += rect->top * width_bytes;
+        dst += rect->top * width_bytes;
+        copy_image_byteswap( &surface->info, src, dst, width_bytes, width_bytes,
+                             rect->bottom - rect->top,
+                             surface->byteswap, mapping, ~0u, surface->alpha_bits );
+    }
+    else if (surface->alpha_bits)
+    {
+        int x, y, stride = surface->image->bytes_per_line / sizeof(ULONG);
+        ULONG *ptr = (ULONG *)dst + rect->top * stride;
+
+        for (y = rect->top; y < rect->bottom; y++, ptr += stride)
+            for (x = rect->left; x < rect->right; x++)
+                ptr[x] |= surface->alpha_bits;
+    }
+
+#ifdef HAVE_LIBXXSHM
+    if (surface->shminfo.shmid != -1)
+        XShmPutImage( gdi_display, surface->window, surface->gc, surface->image,
+                      rect->left, rect->top,
+                      surface->header.rect.left + rect->left,
+                      surface->header.rect.top + rect->top,
+                      rect->right - rect->left, rect->bottom - rect->top, False );
+    else
+#endif
+    XPutImage( gdi_display, surface->window, surface->gc, surface->image,
+               rect->left, rect->top,
+               surface->header.rect.left + rect->left,
+               surface->header.rect.top + rect->top,
+               rect->right - rect->left, rect->bottom - rect->top );
+}
+
+/***********************************************************************
+ *           x11drv_surface_flush
+ */
+static void x11drv_surface_flush( struct window_surface *window_surface )
+{
+    struct x11drv_window_surface *surface = get_x11_surface( window_surface );
     struct bitblt_coords coords;
+    RECT rect;
+    int i;
 
     window_surface->funcs->lock( window_surface );
     coords.x = 0;
@@ -1901,57 +1988,27 @@ static void x11drv_surface_flush( struct window_surface *window_surface )
     coords.width  = surface->header.rect.right - surface->header.rect.left;
     coords.height = surface->header.rect.bottom - surface->header.rect.top;
     SetRect( &coords.visrect, 0, 0, coords.width, coords.height );
-    if (IntersectRect( &coords.visrect, &coords.visrect, &surface->bounds ))
+    if (IntersectRect( &rect, &coords.visrect, &surface->bounds ))
     {
-        TRACE( "flushing %p %dx%d bounds %s bits %p\n",
+        TRACE( "flushing %p %dx%d bounds %s bits %p damage %d\n",
                surface, coords.width, coords.height,
-               wine_dbgstr_rect( &surface->bounds ), surface->bits );
+               wine_dbgstr_rect( &surface->bounds ), surface->bits, surface->damage_count );
 
         if (surface->is_argb || surface->color_key != CLR_INVALID) update_surface_region( surface );
 
-        if (src != dst)
-        {
-            const int *mapping = NULL;
-            int width_bytes = surface->image->bytes_per_line;
-
-            if (surface->image->bits_per_pixel == 4 || surface->image->bits_per_pixel == 8)
-                mapping = X11DRV_PALETTE_PaletteToXPixel;
-
-            src += coords.visrect.top * width_bytes;
-            dst += coords.visrect.top * width_bytes;
-            copy_image_byteswap( &surface->info, src, dst, width_bytes, width_bytes,
-                                 coords.visrect.bottom - coords.visrect.top,
-                                 surface->byteswap, mapping, ~0u, surface->alpha_bits );
-        }
-        else if (surface->alpha_bits)
+        /* the damaged areas can only be used if nothing else was added to the bounds */
+        if (surface->damage_count && EqualRect( &surface->bounds, &surface->damage_bounds ))
         {
-            int x, y, stride = surface->image->bytes_per_line / sizeof(ULONG);
-            ULONG *ptr = (ULONG *)dst + coords.visrect.top * stride;
-
-            for (y = coords.visrect.top; y < coords.visrect.bottom; y++, ptr += stride)
-                for (x = coords.visrect.left; x < coords.visrect.right; x++)
-                    ptr[x] |= surface->alpha_bits;
+            for (i = 0; i < surface->damage_count; i++)
+                if (IntersectRect( &rect, &coords.visrect, &surface->damage[i] ))
+                    flush_surface_rect( surface, &rect );
         }
-
-#ifdef HAVE_LIBXXSHM
-        if (surface->shminfo.shmid != -1)
-            XShmPutImage( gdi_display, surface->window, surface->gc, surface->image,
-                          coords.visrect.left, coords.visrect.top,
-                          surface->header.rect.left + coords.visrect.left,
-                          surface->header.rect.top + coords.visrect.top,
-                          coords.visrect.right - coords.visrect.left,
-                          coords.visrect.bottom - coords.visrect.top, False );
-        else
-#endif
-        XPutImage( gdi_display, surface->window, surface->gc, surface->image,
-                   coords.visrect.left, coords.visrect.top,
-                   surface->header.rect.left + coords.visrect.left,
-                   surface->header.rect.top + coords.visrect.top,
-                   coords.visrect.right - coords.visrect.left,
-                   coords.visrect.bottom - coords.visrect.top );
+        else flush_surface_rect( surface, &rect );
         XFlush( gdi_display );
     }
     reset_bounds( &surface->bounds );
+    reset_bounds( &surface->damage_bounds );
+    surface->damage_count = 0;
     window_surface->funcs->unlock( window_surface );
 }
 
@@ -1993,7 +2050,8 @@ static const struct window_surface_funcs x11drv_surface_funcs =
     x11drv_surface_get_bounds,
     x11drv_surface_set_region,
     x11drv_surface_flush,
-    x11drv_surface_destroy
+    x11drv_surface_destroy,
+    x11drv_surface_add_damage
 };
 
 /***********************************************************************
@@ -2028,6 +2086,7 @@ struct window_surface *create_surface( Window window, const XVisualInfo *vis, co
     surface->is_argb = (use_alpha && vis->depth == 32 && surface->info.bmiHeader.biCompression == BI_RGB);
     set_color_key( surface, color_key );
     reset_bounds( &surface->bounds );
+    reset_bounds( &surface->damage_bounds );
 
 #ifdef HAVE_LIBXXSHM
     surface->image = create_shm_image( vis, width, height, &surface->shminfo );
@@ -2098,7 +2157,7 @@ HRGN expose_surface( struct window_surface *window_surface, const RECT *rect )
 
     window_surface->funcs->lock( window_surface );
     OffsetRect( &rc, -window_surface->rect.left, -window_surface->rect.top );
-    add_bounds_rect( &surface->bounds, &rc );
+    x11drv_surface_add_damage( window_surface, &rc );
     if (surface->region)
     {
         region = CreateRectRgnIndirect( rect );
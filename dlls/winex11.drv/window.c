@@ -2838,7 +2838,8 @@ BOOL CDECL X11DRV_UpdateLayeredWindow( HWND hwnd, const UPDATELAYEREDWINDOWINFO
     if (ret)
     {
         memcpy( dst_bits, src_bits, bmi->bmiHeader.biSizeImage );
-        add_bounds_rect( surface->funcs->get_bounds( surface ), &rect );
+        if (surface->funcs->add_damage) surface->funcs->add_damage( surface, &rect );
+        else add_bounds_rect( surface->funcs->get_bounds( surface ), &rect );
     }
 
     surface->funcs->unlock( surface );
@@ -43,6 +43,7 @@ WINE_DEFAULT_DEBUG_CHANNEL(xrender);
 #ifdef SONAME_LIBXRENDER
 
 WINE_DECLARE_DEBUG_CHANNEL(winediag);
+WINE_DECLARE_DEBUG_CHANNEL(xrender_glyphs);
 
 #include <X11/Xlib.h>
 #include <X11/extensions/Xrender.h>
@@ -134,9 +135,26 @@ typedef struct
     LFANDSIZE lfsz;
     gsCacheEntryFormat *format[GLYPH_NBTYPES][AA_MAXVALUE];
     INT count;
-    INT next;
+    INT next;       /* next entry in mru order, or in the free list */
+    INT prev;       /* previous entry in mru order */
+    INT hash_next;  /* next entry in the same hash bucket */
 } gsCacheEntry;
 
+/* glyphs waiting to be sent to the X server in a single request */
+struct glyph_upload
+{
+    GlyphSet     glyphset;
+    unsigned int count;
+    unsigned int max;
+    Glyph       *gids;
+    XGlyphInfo  *gis;
+    char        *data;
+    unsigned int size;
+    unsigned int data_max;
+};
+
+#define GLYPH_UPLOAD_MAX_SIZE 0x10000
+
 struct xrender_physdev
 {
     struct gdi_physdev dev;
@@ -162,8 +180,15 @@ static gsCacheEntry *glyphsetCache = NULL;
 static DWORD glyphsetCacheSize = 0;
 static INT lastfree = -1;
 static INT mru = -1;
+static INT lru = -1;
 
 #define INIT_CACHE_SIZE 10
+#define GLYPHSET_HASH_SIZE 64
+
+static INT glyphset_hash[GLYPHSET_HASH_SIZE];
+
+/* glyph upload statistics, reported on the xrender_glyphs channel */
+static unsigned int glyphs_uploaded, glyph_requests, text_calls;
 
 static void *xrender_handle;
 
@@ -379,6 +404,7 @@ const struct gdi_dc_funcs *X11DRV_XRender_Init(void)
         glyphsetCache[i].count = -1;
     }
     glyphsetCache[i-1].next = -1;
+    for (i = 0; i < GLYPHSET_HASH_SIZE; i++) glyphset_hash[i] = -1;
 
     return &xrender_funcs;
 }
@@ -594,25 +620,46 @@ static BOOL fontcmp(LFANDSIZE *p1, LFANDSIZE *p2)
   return strcmpiW(p1->lf.lfFaceName, p2->lf.lfFaceName);
 }
 
+static void mru_unlink( int i )
+{
+    if (glyphsetCache[i].prev >= 0) glyphsetCache[glyphsetCache[i].prev].next = glyphsetCache[i].next;
+    else mru = glyphsetCache[i].next;
+    if (glyphsetCache[i].next >= 0) glyphsetCache[glyphsetCache[i].next].prev = glyphsetCache[i].prev;
+    else lru = glyphsetCache[i].prev;
+}
+
+static void mru_push( int i )
+{
+    glyphsetCache[i].prev = -1;
+    glyphsetCache[i].next = mru;
+    if (mru >= 0) glyphsetCache[mru].prev = i;
+    else lru = i;
+    mru = i;
+}
+
+static void hash_unlink( int i )
+{
+    INT *ptr = &glyphset_hash[glyphsetCache[i].lfsz.hash % GLYPHSET_HASH_SIZE];
+
+    while (*ptr >= 0 && *ptr != i) ptr = &glyphsetCache[*ptr].hash_next;
+    if (*ptr == i) *ptr = glyphsetCache[i].hash_next;
+}
+
 static int LookupEntry(LFANDSIZE *plfsz)
 {
-  int i, prev_i = -1;
+  int i;
 
-  for(i = mru; i >= 0; i = glyphsetCache[i].next) {
+  for(i = glyphset_hash[plfsz->hash % GLYPHSET_HASH_SIZE]; i >= 0; i = glyphsetCache[i].hash_next) {
     TRACE("%d\n", i);
-    if(glyphsetCache[i].count == -1) break; /* reached free list so stop */
-
     if(!fontcmp(&glyphsetCache[i].lfsz, plfsz)) {
       glyphsetCache[i].count++;
-      if(prev_i >= 0) {
-	glyphsetCache[prev_i].next = glyphsetCache[i].next;
-	glyphsetCache[i].next = mru;
-	mru = i;
+      if(i != mru) {
+        mru_unlink(i);
+        mru_push(i);
       }
       TRACE("found font in cache %d\n", i);
       return i;
     }
-    prev_i = i;
   }
   TRACE("font not in cache\n");
   return -1;
@@ -652,7 +699,7 @@ static void FreeEntry(int entry)
 
 static int AllocEntry(void)
 {
-  int best = -1, prev_best = -1, i, prev_i = -1;
+  int best, i;
 
   if(lastfree >= 0) {
     assert(glyphsetCache[lastfree].count == -1);
@@ -660,31 +707,24 @@ static int AllocEntry(void)
     best = lastfree;
     lastfree = glyphsetCache[lastfree].next;
     assert(best != mru);
-    glyphsetCache[best].next = mru;
-    mru = best;
+    mru_push(best);
 
     TRACE("empty space at %d, next lastfree = %d\n", mru, lastfree);
     return mru;
   }
 
-  for(i = mru; i >= 0; i = glyphsetCache[i].next) {
-    if(glyphsetCache[i].count == 0) {
-      best = i;
-      prev_best = prev_i;
-    }
-    prev_i = i;
-  }
+  /* reuse the least recently used glyphset that isn't selected anywhere */
+  for(best = lru; best >= 0; best = glyphsetCache[best].prev)
+    if(glyphsetCache[best].count == 0) break;
 
   if(best >= 0) {
     TRACE("freeing unused glyphset at cache %d\n", best);
     FreeEntry(best);
+    hash_unlink(best);
     glyphsetCache[best].count = 1;
-    if(prev_best >= 0) {
-      glyphsetCache[prev_best].next = glyphsetCache[best].next;
-      glyphsetCache[best].next = mru;
-      mru = best;
-    } else {
-      assert(mru == best);
+    if(best != mru) {
+      mru_unlink(best);
+      mru_push(best);
     }
     return mru;
   }
@@ -711,8 +751,7 @@ static int AllocEntry(void)
 
   lastfree = glyphsetCache[best].next;
   glyphsetCache[best].count = 1;
-  glyphsetCache[best].next = mru;
-  mru = best;
+  mru_push(best);
   TRACE("new free cache slot at %d\n", mru);
   return mru;
 }
@@ -727,6 +766,8 @@ static int GetCacheEntry( LFANDSIZE *plfsz )
     ret = AllocEntry();
     entry = glyphsetCache + ret;
     entry->lfsz = *plfsz;
+    entry->hash_next = glyphset_hash[plfsz->hash % GLYPHSET_HASH_SIZE];
+    glyphset_hash[plfsz->hash % GLYPHSET_HASH_SIZE] = ret;
     return ret;
 }
 
@@ -1017,12 +1058,85 @@ static void xrenderdrv_SetDeviceClipping( PHYSDEV dev, HRGN rgn )
 }
 
 
+/************************************************************************
+ *   flush_glyph_upload
+ *
+ * Sends the pending glyphs to the X server.  Must be called inside xrender_cs
+ */
+static void flush_glyph_upload( struct glyph_upload *upload )
+{
+    if (!upload->count) return;
+
+    pXRenderAddGlyphs( gdi_display, upload->glyphset, upload->gids, upload->gis, upload->count,
+                       upload->data, upload->size );
+    glyphs_uploaded += upload->count;
+    glyph_requests++;
+    upload->count = upload->size = 0;
+}
+
+static void free_glyph_upload( struct glyph_upload *upload )
+{
+    HeapFree( GetProcessHeap(), 0, upload->gids );
+    HeapFree( GetProcessHeap(), 0, upload->gis );
+    HeapFree( GetProcessHeap(), 0, upload->data );
+}
+
+/************************************************************************
+ *   add_glyph_upload
+ *
+ * Queues a glyph for upload, sending the pending ones first if they belong
+ * to another glyphset or the request would get too large.
+ */
+static BOOL add_glyph_upload( struct glyph_upload *upload, GlyphSet glyphset, Glyph gid,
+                              const XGlyphInfo *gi, const char *data, unsigned int size )
+{
+    if (upload->glyphset != glyphset || upload->size + size > GLYPH_UPLOAD_MAX_SIZE)
+        flush_glyph_upload( upload );
+    upload->glyphset = glyphset;
+
+    if (upload->count == upload->max)
+    {
+        unsigned int new_max = upload->max ? upload->max * 2 : 32;
+        Glyph *gids;
+        XGlyphInfo *gis;
+
+        if (upload->gids) gids = HeapReAlloc( GetProcessHeap(), 0, upload->gids, new_max * sizeof(*gids) );
+        else gids = HeapAlloc( GetProcessHeap(), 0, new_max * sizeof(*gids) );
+        if (!gids) return FALSE;
+        upload->gids = gids;
+        if (upload->gis) gis = HeapReAlloc( GetProcessHeap(), 0, upload->gis, new_max * sizeof(*gis) );
+        else gis = HeapAlloc( GetProcessHeap(), 0, new_max * sizeof(*gis) );
+        if (!gis) return FALSE;
+        upload->gis = gis;
+        upload->max = new_max;
+    }
+    if (upload->size + size > upload->data_max)
+    {
+        unsigned int new_max = max( upload->data_max * 2, upload->size + size );
+        char *ptr;
+
+        if (upload->data) ptr = HeapReAlloc( GetProcessHeap(), 0, upload->data, new_max );
+        else ptr = HeapAlloc( GetProcessHeap(), 0, new_max );
+        if (!ptr) return FALSE;
+        upload->data = ptr;
+        upload->data_max = new_max;
+    }
+
+    upload->gids[upload->count] = gid;
+    upload->gis[upload->count] = *gi;
+    memcpy( upload->data + upload->size, data, size );
+    upload->count++;
+    upload->size += size;
+    return TRUE;
+}
+
 /************************************************************************
  *   UploadGlyph
  *
  * Helper to ExtTextOut.  Must be called inside xrender_cs
  */
-static void UploadGlyph(struct xrender_physdev *physDev, UINT glyph, enum glyph_type type)
+static void UploadGlyph(struct xrender_physdev *physDev, UINT glyph, enum glyph_type type,
+                        struct glyph_upload *upload)
 {
     unsigned int buflen;
     char *buf;
@@ -1207,8 +1321,15 @@ static void UploadGlyph(struct xrender_physdev *physDev, UINT glyph, enum glyph_
         if(buflen == 0)
             gi.width = gi.height = 1;
 
-	pXRenderAddGlyphs(gdi_display, formatEntry->glyphset, &gid, &gi, 1,
-                          buflen ? buf : zero, buflen ? buflen : sizeof(zero));
+        if (!add_glyph_upload(upload, formatEntry->glyphset, gid, &gi,
+                              buflen ? buf : zero, buflen ? buflen : sizeof(zero)))
+        {
+            flush_glyph_upload(upload);
+            pXRenderAddGlyphs(gdi_display, formatEntry->glyphset, &gid, &gi, 1,
+                              buflen ? buf : zero, buflen ? buflen : sizeof(zero));
+            glyphs_uploaded++;
+            glyph_requests++;
+        }
     }
 
     HeapFree(GetProcessHeap(), 0, buf);
@@ -1316,6 +1437,7 @@ static BOOL xrenderdrv_ExtTextOut( PHYSDEV dev, INT x, INT y, UINT flags,
     XRenderColor col;
     RECT rect, bounds;
     enum glyph_type type = (flags & ETO_GLYPH_INDEX) ? GLYPH_INDEX : GLYPH_WCHAR;
+    struct glyph_upload upload;
 
     get_xrender_color( physdev, GetTextColor( physdev->dev.hdc ), &col );
     pict = get_xrender_picture( physdev, 0, (flags & ETO_CLIPPED) ? lprect : NULL );
@@ -1346,15 +1468,34 @@ static BOOL xrenderdrv_ExtTextOut( PHYSDEV dev, INT x, INT y, UINT flags,
     entry = glyphsetCache + physdev->cache_index;
     formatEntry = entry->format[type][aa_type_from_flags( physdev->aa_flags )];
 
+    /* the missing glyphs are sent in as few requests as possible */
+    memset( &upload, 0, sizeof(upload) );
     for(idx = 0; idx < count; idx++) {
         if( !formatEntry ) {
-	    UploadGlyph(physdev, wstr[idx], type);
+	    UploadGlyph(physdev, wstr[idx], type, &upload);
             /* re-evaluate format entry since aa_flags may have changed */
             formatEntry = entry->format[type][aa_type_from_flags( physdev->aa_flags )];
         } else if( wstr[idx] >= formatEntry->nrealized || formatEntry->realized[wstr[idx]] == FALSE) {
-	    UploadGlyph(physdev, wstr[idx], type);
+	    UploadGlyph(physdev, wstr[idx], type, &upload);
 	}
     }
+    flush_glyph_upload( &upload );
+    free_glyph_upload( &upload );
+    text_calls++;
+
+    if (TRACE_ON(xrender_glyphs))
+    {
+        static DWORD prev_time;
+        DWORD time = GetTickCount();
+
+        if (time - prev_time > 1500)
+        {
+            TRACE_(xrender_glyphs)( "%u text calls, %u glyphs uploaded in %u requests\n",
+                                    text_calls, glyphs_uploaded, glyph_requests );
+            prev_time = time;
+        }
+    }
+
     if (!formatEntry)
     {
         WARN("could not upload requested glyphs\n");
@@ -716,6 +716,57 @@ struct rawinput_device
 };
 
 
+struct desktop_shared_memory
+{
+    unsigned int   hooks_serial;
+    unsigned int   active_hooks;
+    int            seq;
+    int            cursor_x;
+    int            cursor_y;
+    unsigned int   cursor_last_change;
+    unsigned char  keystate[256];
+};
+
+
+struct input_shared_memory
+{
+    unsigned int   attach_serial;
+    unsigned char  keystate[256];
+};
+
+
+struct process_info
+{
+    process_id_t   pid;
+    process_id_t   parent_pid;
+    int            thread_count;
+    int            priority;
+    int            handle_count;
+    int            unix_pid;
+    data_size_t    name_len;
+
+
+};
+
+struct thread_info
+{
+    thread_id_t    tid;
+    int            base_priority;
+    int            current_priority;
+    int            unix_tid;
+};
+
+
+struct request_stats
+{
+    unsigned int     calls;
+    unsigned int     max_time;
+    unsigned __int64 total_time;
+    unsigned __int64 bytes_in;
+    unsigned __int64 bytes_out;
+};
+
+
 
 
 
@@ -2413,6 +2464,21 @@ struct next_thread_reply
 
 
 
+struct list_processes_request
+{
+    struct request_header __header;
+    char __pad_12[4];
+};
+struct list_processes_reply
+{
+    struct reply_header __header;
+    data_size_t    info_size;
+    int            process_count;
+    /* VARARG(data,process_info); */
+};
+
+
+
 struct wait_debug_event_request
 {
     struct request_header __header;
@@ -4106,6 +4172,20 @@ struct set_thread_desktop_reply
 
 
 
+struct get_desktop_shared_memory_request
+{
+    struct request_header __header;
+    char __pad_12[4];
+};
+struct get_desktop_shared_memory_reply
+{
+    struct reply_header __header;
+    obj_handle_t handle;
+    char __pad_12[4];
+};
+
+
+
 struct enum_desktop_request
 {
     struct request_header __header;
@@ -4259,6 +4339,21 @@ struct set_key_state_reply
 };
 
 
+
+struct get_input_shared_memory_request
+{
+    struct request_header __header;
+    char __pad_12[4];
+};
+struct get_input_shared_memory_reply
+{
+    struct reply_header __header;
+    obj_handle_t handle;
+    unsigned int attach_serial;
+};
+
+
+
 struct set_foreground_window_request
 {
     struct request_header __header;
@@ -5518,6 +5613,23 @@ struct update_rawinput_devices_reply
 
 
 
+struct get_rawinput_buffer_request
+{
+    struct request_header __header;
+    data_size_t  mouse_size;
+    data_size_t  kbd_size;
+    data_size_t  buffer_size;
+};
+struct get_rawinput_buffer_reply
+{
+    struct reply_header __header;
+    data_size_t  next_size;
+    unsigned int count;
+    /* VARARG(data,bytes); */
+};
+
+
+
 struct get_suspend_context_request
 {
     struct request_header __header;
@@ -5720,6 +5832,21 @@ struct esync_msgwait_reply
     struct reply_header __header;
 };
 
+
+struct get_server_stats_request
+{
+    struct request_header __header;
+    char __pad_12[4];
+};
+struct get_server_stats_reply
+{
+    struct reply_header __header;
+    timeout_t    elapsed;
+    int          enabled;
+    /* VARARG(stats,request_stats); */
+    char __pad_20[4];
+};
+
 enum esync_type
 {
     ESYNC_SEMAPHORE = 1,
@@ -5829,6 +5956,7 @@ enum request
     REQ_create_snapshot,
     REQ_next_process,
     REQ_next_thread,
+    REQ_list_processes,
     REQ_wait_debug_event,
     REQ_queue_exception_event,
     REQ_get_exception_status,
@@ -5931,6 +6059,7 @@ enum request
     REQ_close_desktop,
     REQ_get_thread_desktop,
     REQ_set_thread_desktop,
+    REQ_get_desktop_shared_memory,
     REQ_enum_desktop,
     REQ_set_user_object_info,
     REQ_register_hotkey,
@@ -5940,6 +6069,7 @@ enum request
     REQ_get_last_input_time,
     REQ_get_key_state,
     REQ_set_key_state,
+    REQ_get_input_shared_memory,
     REQ_set_foreground_window,
     REQ_set_focus_window,
     REQ_set_active_window,
@@ -6015,6 +6145,7 @@ enum request
     REQ_free_user_handle,
     REQ_set_cursor,
     REQ_update_rawinput_devices,
+    REQ_get_rawinput_buffer,
     REQ_get_suspend_context,
     REQ_set_suspend_context,
     REQ_create_job,
@@ -6029,6 +6160,7 @@ enum request
     REQ_get_esync_fd,
     REQ_get_esync_apc_fd,
     REQ_esync_msgwait,
+    REQ_get_server_stats,
     REQ_NB_REQUESTS
 };
 
@@ -6131,6 +6263,7 @@ union generic_request
     struct create_snapshot_request create_snapshot_request;
     struct next_process_request next_process_request;
     struct next_thread_request next_thread_request;
+    struct list_processes_request list_processes_request;
     struct wait_debug_event_request wait_debug_event_request;
     struct queue_exception_event_request queue_exception_event_request;
     struct get_exception_status_request get_exception_status_request;
@@ -6233,6 +6366,7 @@ union generic_request
     struct close_desktop_request close_desktop_request;
     struct get_thread_desktop_request get_thread_desktop_request;
     struct set_thread_desktop_request set_thread_desktop_request;
+    struct get_desktop_shared_memory_request get_desktop_shared_memory_request;
     struct enum_desktop_request enum_desktop_request;
     struct set_user_object_info_request set_user_object_info_request;
     struct register_hotkey_request register_hotkey_request;
@@ -6242,6 +6376,7 @@ union generic_request
     struct get_last_input_time_request get_last_input_time_request;
     struct get_key_state_request get_key_state_request;
     struct set_key_state_request set_key_state_request;
+    struct get_input_shared_memory_request get_input_shared_memory_request;
     struct set_foreground_window_request set_foreground_window_request;
     struct set_focus_window_request set_focus_window_request;
     struct set_active_window_request set_active_window_request;
@@ -6317,6 +6452,7 @@ union generic_request
     struct free_user_handle_request free_user_handle_request;
     struct set_cursor_request set_cursor_request;
     struct update_rawinput_devices_request update_rawinput_devices_request;
+    struct get_rawinput_buffer_request get_rawinput_buffer_request;
     struct get_suspend_context_request get_suspend_context_request;
     struct set_suspend_context_request set_suspend_context_request;
     struct create_job_request create_job_request;
@@ -6331,6 +6467,7 @@ union generic_request
     struct get_esync_fd_request get_esync_fd_request;
     struct get_esync_apc_fd_request get_esync_apc_fd_request;
     struct esync_msgwait_request esync_msgwait_request;
+    struct get_server_stats_request get_server_stats_request;
 };
 union generic_reply
 {
@@ -6431,6 +6568,7 @@ union generic_reply
     struct create_snapshot_reply create_snapshot_reply;
     struct next_process_reply next_process_reply;
     struct next_thread_reply next_thread_reply;
+    struct list_processes_reply list_processes_reply;
     struct wait_debug_event_reply wait_debug_event_reply;
     struct queue_exception_event_reply queue_exception_event_reply;
     struct get_exception_status_reply get_exception_status_reply;
@@ -6533,6 +6671,7 @@ union generic_reply
     struct close_desktop_reply close_desktop_reply;
     struct get_thread_desktop_reply get_thread_desktop_reply;
     struct set_thread_desktop_reply set_thread_desktop_reply;
+    struct get_desktop_shared_memory_reply get_desktop_shared_memory_reply;
     struct enum_desktop_reply enum_desktop_reply;
     struct set_user_object_info_reply set_user_object_info_reply;
     struct register_hotkey_reply register_hotkey_reply;
@@ -6542,6 +6681,7 @@ union generic_reply
     struct get_last_input_time_reply get_last_input_time_reply;
     struct get_key_state_reply get_key_state_reply;
     struct set_key_state_reply set_key_state_reply;
+    struct get_input_shared_memory_reply get_input_shared_memory_reply;
     struct set_foreground_window_reply set_foreground_window_reply;
     struct set_focus_window_reply set_focus_window_reply;
     struct set_active_window_reply set_active_window_reply;
@@ -6617,6 +6757,7 @@ union generic_reply
     struct free_user_handle_reply free_user_handle_reply;
     struct set_cursor_reply set_cursor_reply;
     struct update_rawinput_devices_reply update_rawinput_devices_reply;
+    struct get_rawinput_buffer_reply get_rawinput_buffer_reply;
     struct get_suspend_context_reply get_suspend_context_reply;
     struct set_suspend_context_reply set_suspend_context_reply;
     struct create_job_reply create_job_reply;
@@ -6631,8 +6772,9 @@ union generic_reply
     struct get_esync_fd_reply get_esync_fd_reply;
     struct get_esync_apc_fd_reply get_esync_apc_fd_reply;
     struct esync_msgwait_reply esync_msgwait_reply;
+    struct get_server_stats_reply get_server_stats_reply;
 };
 
-#define SERVER_PROTOCOL_VERSION 573
+#define SERVER_PROTOCOL_VERSION 580
 
 #endif /* __WINE_WINE_SERVER_PROTOCOL_H */
@@ -5638,6 +5638,22 @@ static FORCEINLINE void *RtlSecureZeroMemory(void *buffer, SIZE_T length)
     return buffer;
 }
 
+#if defined(__GNUC__)
+static FORCEINLINE void MemoryBarrier(void)
+{
+    __sync_synchronize();
+}
+#elif defined(__i386__) && defined(_MSC_VER)
+static FORCEINLINE void MemoryBarrier(void)
+{
+    LONG barrier;
+    __asm xchg barrier, eax;
+}
+#elif defined(__x86_64__) && defined(_MSC_VER)
+#pragma intrinsic(__faststorefence)
+#define MemoryBarrier __faststorefence
+#endif
+
 #include <guiddef.h>
 
 typedef struct _OBJECT_TYPE_LIST {
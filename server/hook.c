@@ -48,6 +48,7 @@ struct hook
     struct thread      *thread;   /* thread the hook is set to */
     struct thread      *owner;    /* owner of the out of context hook */
     struct hook_table  *table;    /* hook table that contains this hook */
+    struct desktop     *desktop;  /* desktop the hook is set on */
     int                 index;    /* hook table index */
     int                 event_min;
     int                 event_max;
@@ -148,8 +149,11 @@ static struct hook *add_hook( struct desktop *desktop, struct thread *thread, in
     hook->thread = thread ? (struct thread *)grab_object( thread ) : NULL;
     hook->table  = table;
     hook->index  = index;
+    /* global hooks are owned by the desktop, so they can't hold a reference to it */
+    hook->desktop = global ? desktop : get_thread_desktop( thread, 0 );
     list_add_head( &table->hooks[index], &hook->chain );
     if (thread) thread->desktop_users++;
+    if (hook->desktop) update_desktop_hooks( hook->desktop, index, 1 );
     return hook;
 }
 
@@ -158,6 +162,11 @@ static void free_hook( struct hook *hook )
 {
     free_user_handle( hook->handle );
     free( hook->module );
+    if (hook->desktop)
+    {
+        update_desktop_hooks( hook->desktop, hook->index, -1 );
+        if (hook->table != hook->desktop->global_hooks) release_object( hook->desktop );
+    }
     if (hook->thread)
     {
         assert( hook->thread->desktop_users > 0 );
@@ -294,6 +303,7 @@ static void hook_table_destroy( struct object *obj )
 /* remove a hook, freeing it if the chain is not in use */
 static void remove_hook( struct hook *hook )
 {
+    if (hook->desktop) update_desktop_hooks( hook->desktop, hook->index, 0 );
     if (hook->table->counts[hook->index])
         hook->proc = 0; /* chain is in use, just mark it and return */
     else
@@ -917,6 +917,30 @@ int get_page_size(void)
     return page_mask + 1;
 }
 
+/* create an anonymous mapping that also stays mapped writable in the server */
+struct mapping *create_shared_mapping( mem_size_t size, void **ptr )
+{
+    struct mapping *mapping;
+    void *shared;
+    int unix_fd;
+
+    if (!(mapping = (struct mapping *)create_mapping( NULL, NULL, 0, size, SEC_COMMIT, 0, 0, NULL )))
+        return NULL;
+
+    if ((unix_fd = get_unix_fd( mapping->fd )) == -1) goto error;
+    if ((shared = mmap( NULL, mapping->size, PROT_READ | PROT_WRITE, MAP_SHARED, unix_fd, 0 )) == MAP_FAILED)
+    {
+        file_set_error();
+        goto error;
+    }
+    *ptr = shared;
+    return mapping;
+
+ error:
+    release_object( mapping );
+    return NULL;
+}
+
 /* create a file mapping */
 DECL_HANDLER(create_mapping)
 {
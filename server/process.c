@@ -539,6 +539,8 @@ struct thread *create_process( int fd, struct thread *parent_thread, int inherit
     process->rawinput_mouse  = NULL;
     process->rawinput_kbd    = NULL;
     process->esync_fd        = -1;
+    process->request_calls   = 0;
+    process->request_time    = 0;
     list_init( &process->thread_list );
     list_init( &process->locks );
     list_init( &process->asyncs );
@@ -1104,6 +1106,83 @@ struct process_snapshot *process_snap( int *count )
     return snapshot;
 }
 
+/* get the size of the list_processes information for a process, or 0 to skip it */
+static data_size_t get_process_info_size( struct process *process, int *thread_count )
+{
+    struct process_dll *exe_module = get_process_exe_module( process );
+    data_size_t name_len = exe_module && exe_module->filename ? exe_module->namelen : 0;
+    struct thread *thread;
+
+    *thread_count = 0;
+    if (!process->running_threads) return 0;
+    LIST_FOR_EACH_ENTRY( thread, &process->thread_list, struct thread, proc_entry )
+        if (thread->state != TERMINATED) (*thread_count)++;
+
+    return sizeof(struct process_info) + ((name_len + 3) & ~3) +
+           *thread_count * sizeof(struct thread_info);
+}
+
+/* retrieve information about all the processes and their threads */
+DECL_HANDLER(list_processes)
+{
+    struct process *process;
+    struct thread *thread;
+    data_size_t size, total = 0;
+    int thread_count;
+    char *buffer, *ptr;
+
+    reply->process_count = 0;
+    LIST_FOR_EACH_ENTRY( process, &process_list, struct process, entry )
+    {
+        if (!(size = get_process_info_size( process, &thread_count ))) continue;
+        total += size;
+        reply->process_count++;
+    }
+    reply->info_size = total;
+
+    if (total > get_reply_max_size())
+    {
+        set_error( STATUS_INFO_LENGTH_MISMATCH );
+        return;
+    }
+    if (!(buffer = set_reply_data_size( total ))) return;
+
+    ptr = buffer;
+    LIST_FOR_EACH_ENTRY( process, &process_list, struct process, entry )
+    {
+        struct process_info *info = (struct process_info *)ptr;
+        struct thread_info *thread_info;
+        struct process_dll *exe_module;
+
+        if (!(size = get_process_info_size( process, &thread_count ))) continue;
+
+        memset( ptr, 0, size );
+        info->pid          = get_process_id( process );
+        info->parent_pid   = process->parent_id;
+        info->thread_count = thread_count;
+        info->priority     = process->priority;
+        info->handle_count = get_handle_table_count( process );
+        info->unix_pid     = process->unix_pid;
+        if ((exe_module = get_process_exe_module( process )) && exe_module->filename)
+        {
+            info->name_len = exe_module->namelen;
+            memcpy( info + 1, exe_module->filename, exe_module->namelen );
+        }
+
+        thread_info = (struct thread_info *)(ptr + sizeof(*info) + ((info->name_len + 3) & ~3));
+        LIST_FOR_EACH_ENTRY( thread, &process->thread_list, struct thread, proc_entry )
+        {
+            if (thread->state == TERMINATED) continue;
+            thread_info->tid              = get_thread_id( thread );
+            thread_info->base_priority    = thread->priority;
+            thread_info->current_priority = thread->priority;
+            thread_info->unix_tid         = thread->unix_tid;
+            thread_info++;
+        }
+        ptr += size;
+    }
+}
+
 /* create a new process */
 DECL_HANDLER(new_process)
 {
@@ -96,6 +96,8 @@ struct process
     const struct rawinput_device *rawinput_mouse; /* rawinput mouse device, if any */
     const struct rawinput_device *rawinput_kbd;   /* rawinput keyboard device, if any */
     int                  esync_fd;        /* esync file descriptor (signaled on exit) */
+    unsigned int         request_calls;   /* number of requests counted by the request profiler */
+    unsigned __int64     request_time;    /* time spent handling them, in nanoseconds */
 };
 
 struct process_snapshot
@@ -28,6 +28,7 @@
 #ifdef HAVE_POLL_H
 # include <poll.h>
 #endif
+#include <sys/mman.h>
 
 #include "ntstatus.h"
 #define WIN32_NO_STATUS
@@ -114,7 +115,10 @@ struct thread_input
     user_handle_t          cursor;        /* current cursor */
     int                    cursor_count;  /* cursor show count */
     struct list            msg_list;      /* list of hardware messages */
-    unsigned char          keystate[256]; /* state of each key */
+    unsigned char         *keystate;      /* state of each key, in the shared memory once created */
+    unsigned char          local_keystate[256]; /* key state until the shared memory is created */
+    struct mapping        *shared_mapping; /* mapping of the state shared with the clients */
+    volatile struct input_shared_memory *shared; /* server-side view of the shared mapping */
 };
 
 struct msg_queue
@@ -261,9 +265,12 @@ static struct thread_input *create_thread_input( struct thread *thread )
         input->move_size    = 0;
         input->cursor       = 0;
         input->cursor_count = 0;
+        input->shared_mapping = NULL;
+        input->shared       = NULL;
         list_init( &input->msg_list );
         set_caret_window( input, 0 );
-        memset( input->keystate, 0, sizeof(input->keystate) );
+        memset( input->local_keystate, 0, sizeof(input->local_keystate) );
+        input->keystate     = input->local_keystate;
 
         if (!(input->desktop = get_thread_desktop( thread, 0 /* FIXME: access rights */ )))
         {
@@ -342,6 +349,8 @@ static int assign_thread_input( struct thread *thread, struct thread_input *new_
     if (queue->input)
     {
         queue->input->cursor_count -= queue->cursor_count;
+        /* make clients of the thread look up their new input state */
+        if (queue->input->shared) queue->input->shared->attach_serial++;
         release_object( queue->input );
     }
     queue->input = (struct thread_input *)grab_object( new_input );
@@ -349,6 +358,29 @@ static int assign_thread_input( struct thread *thread, struct thread_input *new_
     return 1;
 }
 
+static inline void write_barrier(void)
+{
+#ifdef __GNUC__
+    __sync_synchronize();
+#endif
+}
+
+/* publish the cursor position in the desktop state shared with the clients */
+static void update_shared_cursor( struct desktop *desktop )
+{
+    volatile struct desktop_shared_memory *shared = desktop->shared;
+
+    /* the odd sequence must be visible before the new position, and the new */
+    /* position before the even sequence, see get_shared_cursor_pos in user32 */
+    shared->seq++;
+    write_barrier();
+    shared->cursor_x = desktop->cursor.x;
+    shared->cursor_y = desktop->cursor.y;
+    shared->cursor_last_change = desktop->cursor.last_change;
+    write_barrier();
+    shared->seq++;
+}
+
 /* set the cursor position and queue the corresponding mouse message */
 static void set_cursor_pos( struct desktop *desktop, int x, int y )
 {
@@ -515,12 +547,49 @@ static inline unsigned int get_unique_id(void)
     return id;
 }
 
+/* check whether a message is a raw mouse message carrying only relative motion */
+static inline int is_rawinput_motion( const struct message *msg )
+{
+    const struct hardware_msg_data *data = msg->data;
+
+    if (msg->msg != WM_INPUT || msg->type != MSG_HARDWARE || !data) return 0;
+    if (data->rawinput.type != RIM_TYPEMOUSE) return 0;
+    return !(data->flags & ~(MOUSEEVENTF_MOVE | MOUSEEVENTF_ABSOLUTE));
+}
+
+/* try to merge a raw mouse motion with the last one in the list; return 1 if successful */
+static int merge_rawinput_message( struct thread_input *input, const struct message *msg )
+{
+    struct hardware_msg_data *prev_data, *msg_data = msg->data;
+    struct message *prev;
+    struct list *ptr;
+
+    for (ptr = list_tail( &input->msg_list ); ptr; ptr = list_prev( &input->msg_list, ptr ))
+    {
+        prev = LIST_ENTRY( ptr, struct message, entry );
+        if (prev->msg != WM_MOUSEMOVE) break;
+    }
+    if (!ptr) return 0;
+    if (!is_rawinput_motion( prev )) return 0;
+    if (prev->unique_id) return 0;  /* already returned to the app */
+    if (prev->result) return 0;
+    if (prev->win != msg->win) return 0;
+    /* now we can accumulate the motion into it */
+    prev_data = prev->data;
+    prev_data->info = msg_data->info;
+    prev_data->rawinput.mouse.x += msg_data->rawinput.mouse.x;
+    prev_data->rawinput.mouse.y += msg_data->rawinput.mouse.y;
+    prev->time = msg->time;
+    return 1;
+}
+
 /* try to merge a message with the last in the list; return 1 if successful */
 static int merge_message( struct thread_input *input, const struct message *msg )
 {
     struct message *prev;
     struct list *ptr;
 
+    if (is_rawinput_motion( msg )) return merge_rawinput_message( input, msg );
     if (msg->msg != WM_MOUSEMOVE) return 0;
     for (ptr = list_tail( &input->msg_list ); ptr; ptr = list_prev( &input->msg_list, ptr ))
     {
@@ -1046,6 +1115,8 @@ static void thread_input_destroy( struct object *obj )
     struct thread_input *input = (struct thread_input *)obj;
 
     empty_msg_list( &input->msg_list );
+    if (input->shared) munmap( (void *)input->shared, sizeof(*input->shared) );
+    if (input->shared_mapping) release_object( input->shared_mapping );
     if (input->desktop)
     {
         if (input->desktop->foreground_input == input) set_foreground_input( input->desktop, NULL );
@@ -1118,7 +1189,7 @@ int attach_thread_input( struct thread *thread_from, struct thread *thread_to )
     }
 
     ret = assign_thread_input( thread_from, input );
-    if (ret) memset( input->keystate, 0, sizeof(input->keystate) );
+    if (ret) memset( input->keystate, 0, sizeof(input->local_keystate) );
     release_object( input );
     return ret;
 }
@@ -1522,6 +1593,7 @@ static void queue_hardware_message( struct desktop *desktop, struct message *msg
             desktop->cursor.x = x;
             desktop->cursor.y = y;
             desktop->cursor.last_change = get_tick_count();
+            update_shared_cursor( desktop );
         }
         if (desktop->keystate[VK_LBUTTON] & 0x80)  msg->wparam |= MK_LBUTTON;
         if (desktop->keystate[VK_MBUTTON] & 0x80)  msg->wparam |= MK_MBUTTON;
@@ -1638,6 +1710,7 @@ static int queue_mouse_message( struct desktop *desktop, user_handle_t win, cons
     };
 
     desktop->cursor.last_change = get_tick_count();
+    update_shared_cursor( desktop );
     flags = input->mouse.flags;
     time  = input->mouse.time;
     if (!time) time = desktop->cursor.last_change;
@@ -2969,6 +3042,27 @@ DECL_HANDLER(set_key_state)
 }
 
 
+/* get a handle to the shared memory of the current thread input */
+DECL_HANDLER(get_input_shared_memory)
+{
+    struct thread_input *input;
+
+    if (!current->queue) return;
+    input = current->queue->input;
+
+    if (!input->shared_mapping)
+    {
+        if (!(input->shared_mapping = create_shared_mapping( sizeof(*input->shared),
+                                                             (void **)&input->shared ))) return;
+        memcpy( (void *)input->shared->keystate, input->local_keystate, sizeof(input->local_keystate) );
+        input->keystate = (unsigned char *)input->shared->keystate;
+    }
+    reply->handle = alloc_handle( current->process, input->shared_mapping,
+                                  SECTION_QUERY | SECTION_MAP_READ, 0 );
+    reply->attach_serial = input->shared->attach_serial;
+}
+
+
 /* set the system foreground window */
 DECL_HANDLER(set_foreground_window)
 {
@@ -3192,6 +3286,68 @@ DECL_HANDLER(update_rawinput_devices)
     current->process->rawinput_kbd   = e ? &e->device : NULL;
 }
 
+/* retrieve and remove the queued raw input messages of the current thread */
+DECL_HANDLER(get_rawinput_buffer)
+{
+    struct msg_queue *queue = get_current_queue();
+    struct thread_input *input;
+    struct hardware_msg_data *buf = NULL;
+    struct thread *win_thread;
+    struct message *msg, *next;
+    unsigned int msg_code, count = 0, max_count;
+    data_size_t size = 0, next_size = 0, msg_size;
+    int remaining = 0;
+
+    if (!queue) return;
+    input = queue->input;
+
+    max_count = get_reply_max_size() / sizeof(*buf);
+    if (max_count && !(buf = mem_alloc( max_count * sizeof(*buf) ))) return;
+
+    LIST_FOR_EACH_ENTRY_SAFE( msg, next, &input->msg_list, struct message, entry )
+    {
+        struct hardware_msg_data *data = msg->data;
+
+        if (msg->msg != WM_INPUT)
+        {
+            if (get_hardware_msg_bit( msg ) == QS_RAWINPUT) remaining = 1;
+            continue;
+        }
+        if (!find_hardware_message_window( input->desktop, input, msg, &msg_code, &win_thread ) ||
+            !win_thread)
+        {
+            /* left in the queue, so QS_RAWINPUT must stay set */
+            remaining = 1;
+            continue;
+        }
+        release_object( win_thread );
+        if (win_thread != current)
+        {
+            remaining = 1;
+            continue;
+        }
+
+        msg_size = data->rawinput.type == RIM_TYPEMOUSE ? req->mouse_size : req->kbd_size;
+        if (next_size || count == max_count || size + msg_size > req->buffer_size)
+        {
+            if (!next_size) next_size = msg_size;
+            remaining = 1;
+            continue;
+        }
+
+        buf[count++] = *data;
+        size += msg_size;
+        list_remove( &msg->entry );
+        free_message( msg );
+    }
+    if (!remaining) clear_queue_bits( queue, QS_RAWINPUT );
+
+    reply->next_size = next_size;
+    reply->count     = count;
+    if (count) set_reply_data_ptr( buf, count * sizeof(*buf) );
+    else free( buf );
+}
+
 DECL_HANDLER(esync_msgwait)
 {
     struct msg_queue *queue = get_current_queue();
@@ -287,11 +287,106 @@ static void send_reply( union generic_reply *reply )
         fatal_protocol_error( current, "reply write: %s\n", strerror( errno ));
 }
 
+/* request profiler */
+static int stats_enabled;
+static timeout_t stats_start_time;
+static struct request_stats request_stats[REQ_NB_REQUESTS];
+
+/* get a high resolution monotonic timestamp in nanoseconds */
+static unsigned __int64 get_stats_time(void)
+{
+#ifdef __APPLE__
+    static mach_timebase_info_data_t timebase;
+
+    if (!timebase.denom) mach_timebase_info( &timebase );
+    return mach_absolute_time() * timebase.numer / timebase.denom;
+#else
+#ifdef HAVE_CLOCK_GETTIME
+    struct timespec ts;
+
+    if (!clock_gettime( CLOCK_MONOTONIC, &ts ))
+        return (unsigned __int64)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+    {
+        struct timeval now;
+
+        gettimeofday( &now, NULL );
+        return (unsigned __int64)now.tv_sec * 1000000000 + now.tv_usec * 1000;
+    }
+#endif
+}
+
+static int reset_process_request_stats( struct process *process, void *arg )
+{
+    process->request_calls = 0;
+    process->request_time = 0;
+    return 0;
+}
+
+static void reset_request_stats(void)
+{
+    memset( request_stats, 0, sizeof(request_stats) );
+    enum_processes( reset_process_request_stats, NULL );
+    stats_start_time = current_time;
+}
+
+static int dump_process_request_stats( struct process *process, void *arg )
+{
+    if (process->request_calls)
+        fprintf( stderr, "%04x %10u %12.0f %8.0f\n", process->id, process->request_calls,
+                 (double)process->request_time / 1000,
+                 (double)process->request_time / process->request_calls );
+    return 0;
+}
+
+/* dump the request statistics to stderr and reset them, or start collecting them */
+/* the statistics of processes that exited since the last dump are only part of the request totals */
+void dump_request_stats(void)
+{
+    if (!stats_enabled)
+    {
+        reset_request_stats();
+        stats_enabled = 1;
+        fprintf( stderr, "wineserver: request statistics enabled\n" );
+        return;
+    }
+    trace_request_stats( request_stats, current_time - stats_start_time );
+    fprintf( stderr, "%-4s %10s %12s %8s\n", "pid", "calls", "total(us)", "avg(ns)" );
+    enum_processes( dump_process_request_stats, NULL );
+    reset_request_stats();
+}
+
+/* update the statistics of a request once its handler has returned */
+static void update_request_stats( enum request req, struct thread *thread, unsigned __int64 start )
+{
+    struct request_stats *stats = &request_stats[req];
+    unsigned __int64 time = get_stats_time() - start;
+
+    stats->calls++;
+    stats->total_time += time;
+    if (time > stats->max_time) stats->max_time = min( time, ~0u );
+    stats->bytes_in += thread->req.request_header.request_size;
+    if (thread == current) stats->bytes_out += thread->reply_size;
+    thread->process->request_calls++;
+    thread->process->request_time += time;
+}
+
+/* retrieve the server request statistics */
+/* they can only be enabled and reset through "wineserver --stats", so that a client can't */
+/* disturb the measurements of another one */
+DECL_HANDLER(get_server_stats)
+{
+    reply->elapsed = stats_enabled ? current_time - stats_start_time : 0;
+    reply->enabled = stats_enabled;
+    if (stats_enabled) set_reply_data( request_stats, min( sizeof(request_stats), get_reply_max_size() ));
+}
+
 /* call a request handler */
 static void call_req_handler( struct thread *thread )
 {
     union generic_reply reply;
     enum request req = thread->req.request_header.req;
+    unsigned __int64 start = 0;
 
     current = thread;
     current->reply_size = 0;
@@ -301,7 +396,15 @@ static void call_req_handler( struct thread *thread )
     if (debug_level) trace_request();
 
     if (req < REQ_NB_REQUESTS)
-        req_handlers[req]( &current->req, &reply );
+    {
+        if (stats_enabled)
+        {
+            start = get_stats_time();
+            req_handlers[req]( &current->req, &reply );
+            update_request_stats( req, thread, start );
+        }
+        else req_handlers[req]( &current->req, &reply );
+    }
     else
         set_error( STATUS_NOT_IMPLEMENTED );
 
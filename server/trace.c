@@ -24,6 +24,7 @@
 #include <ctype.h>
 #include <stdarg.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <sys/types.h>
 
 #ifdef HAVE_SYS_UIO_H
@@ -870,6 +871,49 @@ static void dump_varargs_rectangles( const char *prefix, data_size_t size )
     remove_data( size );
 }
 
+static void dump_varargs_process_info( const char *prefix, data_size_t size )
+{
+    data_size_t pos = 0;
+    unsigned int i;
+
+    fprintf( stderr, "%s{", prefix );
+    while (size - pos >= sizeof(struct process_info))
+    {
+        const struct process_info *process = (const struct process_info *)((const char *)cur_data + pos);
+        const struct thread_info *thread;
+
+        if (pos) fputc( ',', stderr );
+        fprintf( stderr, "{pid=%04x,parent_pid=%04x,priority=%d,handles=%d,unix_pid=%d,name=L\"",
+                 process->pid, process->parent_pid, process->priority, process->handle_count,
+                 process->unix_pid );
+        pos += sizeof(*process);
+        dump_strW( (const WCHAR *)((const char *)cur_data + pos),
+                   min( process->name_len, size - pos ) / sizeof(WCHAR), stderr, "\"\"" );
+        fprintf( stderr, "\",threads={" );
+        pos += (process->name_len + 3) & ~3;
+        for (i = 0; i < process->thread_count && size - pos >= sizeof(*thread); i++)
+        {
+            thread = (const struct thread_info *)((const char *)cur_data + pos);
+            if (i) fputc( ',', stderr );
+            fprintf( stderr, "{tid=%04x,base_priority=%d,current_priority=%d,unix_tid=%d}",
+                     thread->tid, thread->base_priority, thread->current_priority, thread->unix_tid );
+            pos += sizeof(*thread);
+        }
+        fprintf( stderr, "}}" );
+    }
+    fputc( '}', stderr );
+    remove_data( size );
+}
+
+static void dump_varargs_request_stats( const char *prefix, data_size_t size )
+{
+    const struct request_stats *stats = cur_data;
+    data_size_t len = size / sizeof(*stats);
+
+    fprintf( stderr, "%s%u entries", prefix, len );
+    remove_data( size );
+}
+
 static void dump_varargs_message_data( const char *prefix, data_size_t size )
 {
     /* FIXME: dump the structured data */
@@ -2370,6 +2414,17 @@ static void dump_next_thread_reply( const struct next_thread_reply *req )
     fprintf( stderr, ", delta_pri=%d", req->delta_pri );
 }
 
+static void dump_list_processes_request( const struct list_processes_request *req )
+{
+}
+
+static void dump_list_processes_reply( const struct list_processes_reply *req )
+{
+    fprintf( stderr, " info_size=%u", req->info_size );
+    fprintf( stderr, ", process_count=%d", req->process_count );
+    dump_varargs_process_info( ", data=", cur_size );
+}
+
 static void dump_wait_debug_event_request( const struct wait_debug_event_request *req )
 {
     fprintf( stderr, " get_handle=%d", req->get_handle );
@@ -3488,6 +3543,15 @@ static void dump_set_thread_desktop_request( const struct set_thread_desktop_req
     fprintf( stderr, " handle=%04x", req->handle );
 }
 
+static void dump_get_desktop_shared_memory_request( const struct get_desktop_shared_memory_request *req )
+{
+}
+
+static void dump_get_desktop_shared_memory_reply( const struct get_desktop_shared_memory_reply *req )
+{
+    fprintf( stderr, " handle=%04x", req->handle );
+}
+
 static void dump_enum_desktop_request( const struct enum_desktop_request *req )
 {
     fprintf( stderr, " winstation=%04x", req->winstation );
@@ -3595,6 +3659,16 @@ static void dump_set_key_state_request( const struct set_key_state_request *req
     dump_varargs_bytes( ", keystate=", cur_size );
 }
 
+static void dump_get_input_shared_memory_request( const struct get_input_shared_memory_request *req )
+{
+}
+
+static void dump_get_input_shared_memory_reply( const struct get_input_shared_memory_reply *req )
+{
+    fprintf( stderr, " handle=%04x", req->handle );
+    fprintf( stderr, ", attach_serial=%08x", req->attach_serial );
+}
+
 static void dump_set_foreground_window_request( const struct set_foreground_window_request *req )
 {
     fprintf( stderr, " handle=%08x", req->handle );
@@ -4468,6 +4542,20 @@ static void dump_update_rawinput_devices_request( const struct update_rawinput_d
     dump_varargs_rawinput_devices( " devices=", cur_size );
 }
 
+static void dump_get_rawinput_buffer_request( const struct get_rawinput_buffer_request *req )
+{
+    fprintf( stderr, " mouse_size=%u", req->mouse_size );
+    fprintf( stderr, ", kbd_size=%u", req->kbd_size );
+    fprintf( stderr, ", buffer_size=%u", req->buffer_size );
+}
+
+static void dump_get_rawinput_buffer_reply( const struct get_rawinput_buffer_reply *req )
+{
+    fprintf( stderr, " next_size=%u", req->next_size );
+    fprintf( stderr, ", count=%08x", req->count );
+    dump_varargs_bytes( ", data=", cur_size );
+}
+
 static void dump_get_suspend_context_request( const struct get_suspend_context_request *req )
 {
 }
@@ -4589,6 +4677,17 @@ static void dump_esync_msgwait_request( const struct esync_msgwait_request *req
     fprintf( stderr, " in_msgwait=%d", req->in_msgwait );
 }
 
+static void dump_get_server_stats_request( const struct get_server_stats_request *req )
+{
+}
+
+static void dump_get_server_stats_reply( const struct get_server_stats_reply *req )
+{
+    dump_timeout( " elapsed=", &req->elapsed );
+    fprintf( stderr, ", enabled=%d", req->enabled );
+    dump_varargs_request_stats( ", stats=", cur_size );
+}
+
 static const dump_func req_dumpers[REQ_NB_REQUESTS] = {
     (dump_func)dump_new_process_request,
     (dump_func)dump_get_new_process_info_request,
@@ -4685,6 +4784,7 @@ static const dump_func req_dumpers[REQ_NB_REQUESTS] = {
     (dump_func)dump_create_snapshot_request,
     (dump_func)dump_next_process_request,
     (dump_func)dump_next_thread_request,
+    (dump_func)dump_list_processes_request,
     (dump_func)dump_wait_debug_event_request,
     (dump_func)dump_queue_exception_event_request,
     (dump_func)dump_get_exception_status_request,
@@ -4787,6 +4887,7 @@ static const dump_func req_dumpers[REQ_NB_REQUESTS] = {
     (dump_func)dump_close_desktop_request,
     (dump_func)dump_get_thread_desktop_request,
     (dump_func)dump_set_thread_desktop_request,
+    (dump_func)dump_get_desktop_shared_memory_request,
     (dump_func)dump_enum_desktop_request,
     (dump_func)dump_set_user_object_info_request,
     (dump_func)dump_register_hotkey_request,
@@ -4796,6 +4897,7 @@ static const dump_func req_dumpers[REQ_NB_REQUESTS] = {
     (dump_func)dump_get_last_input_time_request,
     (dump_func)dump_get_key_state_request,
     (dump_func)dump_set_key_state_request,
+    (dump_func)dump_get_input_shared_memory_request,
     (dump_func)dump_set_foreground_window_request,
     (dump_func)dump_set_focus_window_request,
     (dump_func)dump_set_active_window_request,
@@ -4871,6 +4973,7 @@ static const dump_func req_dumpers[REQ_NB_REQUESTS] = {
     (dump_func)dump_free_user_handle_request,
     (dump_func)dump_set_cursor_request,
     (dump_func)dump_update_rawinput_devices_request,
+    (dump_func)dump_get_rawinput_buffer_request,
     (dump_func)dump_get_suspend_context_request,
     (dump_func)dump_set_suspend_context_request,
     (dump_func)dump_create_job_request,
@@ -4885,6 +4988,7 @@ static const dump_func req_dumpers[REQ_NB_REQUESTS] = {
     (dump_func)dump_get_esync_fd_request,
     (dump_func)dump_get_esync_apc_fd_request,
     (dump_func)dump_esync_msgwait_request,
+    (dump_func)dump_get_server_stats_request,
 };
 
 static const dump_func reply_dumpers[REQ_NB_REQUESTS] = {
@@ -4983,6 +5087,7 @@ static const dump_func reply_dumpers[REQ_NB_REQUESTS] = {
     (dump_func)dump_create_snapshot_reply,
     (dump_func)dump_next_process_reply,
     (dump_func)dump_next_thread_reply,
+    (dump_func)dump_list_processes_reply,
     (dump_func)dump_wait_debug_event_reply,
     (dump_func)dump_queue_exception_event_reply,
     (dump_func)dump_get_exception_status_reply,
@@ -5085,6 +5190,7 @@ static const dump_func reply_dumpers[REQ_NB_REQUESTS] = {
     NULL,
     (dump_func)dump_get_thread_desktop_reply,
     NULL,
+    (dump_func)dump_get_desktop_shared_memory_reply,
     (dump_func)dump_enum_desktop_reply,
     (dump_func)dump_set_user_object_info_reply,
     (dump_func)dump_register_hotkey_reply,
@@ -5094,6 +5200,7 @@ static const dump_func reply_dumpers[REQ_NB_REQUESTS] = {
     (dump_func)dump_get_last_input_time_reply,
     (dump_func)dump_get_key_state_reply,
     NULL,
+    (dump_func)dump_get_input_shared_memory_reply,
     (dump_func)dump_set_foreground_window_reply,
     (dump_func)dump_set_focus_window_reply,
     (dump_func)dump_set_active_window_reply,
@@ -5169,6 +5276,7 @@ static const dump_func reply_dumpers[REQ_NB_REQUESTS] = {
     NULL,
     (dump_func)dump_set_cursor_reply,
     NULL,
+    (dump_func)dump_get_rawinput_buffer_reply,
     (dump_func)dump_get_suspend_context_reply,
     NULL,
     (dump_func)dump_create_job_reply,
@@ -5183,6 +5291,7 @@ static const dump_func reply_dumpers[REQ_NB_REQUESTS] = {
     (dump_func)dump_get_esync_fd_reply,
     NULL,
     NULL,
+    (dump_func)dump_get_server_stats_reply,
 };
 
 static const char * const req_names[REQ_NB_REQUESTS] = {
@@ -5281,6 +5390,7 @@ static const char * const req_names[REQ_NB_REQUESTS] = {
     "create_snapshot",
     "next_process",
     "next_thread",
+    "list_processes",
     "wait_debug_event",
     "queue_exception_event",
     "get_exception_status",
@@ -5383,6 +5493,7 @@ static const char * const req_names[REQ_NB_REQUESTS] = {
     "close_desktop",
     "get_thread_desktop",
     "set_thread_desktop",
+    "get_desktop_shared_memory",
     "enum_desktop",
     "set_user_object_info",
     "register_hotkey",
@@ -5392,6 +5503,7 @@ static const char * const req_names[REQ_NB_REQUESTS] = {
     "get_last_input_time",
     "get_key_state",
     "set_key_state",
+    "get_input_shared_memory",
     "set_foreground_window",
     "set_focus_window",
     "set_active_window",
@@ -5467,6 +5579,7 @@ static const char * const req_names[REQ_NB_REQUESTS] = {
     "free_user_handle",
     "set_cursor",
     "update_rawinput_devices",
+    "get_rawinput_buffer",
     "get_suspend_context",
     "set_suspend_context",
     "create_job",
@@ -5481,6 +5594,7 @@ static const char * const req_names[REQ_NB_REQUESTS] = {
     "get_esync_fd",
     "get_esync_apc_fd",
     "esync_msgwait",
+    "get_server_stats",
 };
 
 static const struct
@@ -5665,3 +5779,40 @@ void trace_reply( enum request req, const union generic_reply *reply )
     else fprintf( stderr, "%04x: %d() = %s\n",
                   current->id, req, get_status_name(current->error) );
 }
+
+static int compare_request_stats( const void *p1, const void *p2 )
+{
+    const struct request_stats *stats1 = *(const struct request_stats * const *)p1;
+    const struct request_stats *stats2 = *(const struct request_stats * const *)p2;
+
+    if (stats1->total_time > stats2->total_time) return -1;
+    if (stats1->total_time < stats2->total_time) return 1;
+    return 0;
+}
+
+/* dump the request profiler statistics, busiest requests first */
+void trace_request_stats( const struct request_stats *stats, timeout_t elapsed )
+{
+    const struct request_stats *order[REQ_NB_REQUESTS];
+    double total_calls = 0, total_time = 0;
+    unsigned int i, count = 0;
+
+    for (i = 0; i < REQ_NB_REQUESTS; i++)
+    {
+        if (!stats[i].calls) continue;
+        order[count++] = &stats[i];
+        total_calls += stats[i].calls;
+        total_time += stats[i].total_time;
+    }
+    qsort( order, count, sizeof(order[0]), compare_request_stats );
+
+    fprintf( stderr, "wineserver: %.0f requests in %.3f s, %.3f ms spent in handlers\n",
+             total_calls, (double)elapsed / TICKS_PER_SEC, total_time / 1000000 );
+    fprintf( stderr, "%-32s %10s %12s %8s %10s %14s %14s\n",
+             "request", "calls", "total(us)", "avg(ns)", "max(us)", "bytes in", "bytes out" );
+    for (i = 0; i < count; i++)
+        fprintf( stderr, "%-32s %10u %12.0f %8.0f %10.1f %14.0f %14.0f\n",
+                 req_names[order[i] - stats], order[i]->calls, (double)order[i]->total_time / 1000,
+                 (double)order[i]->total_time / order[i]->calls, (double)order[i]->max_time / 1000,
+                 (double)order[i]->bytes_in, (double)order[i]->bytes_out );
+}
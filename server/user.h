@@ -76,7 +76,10 @@ struct desktop
     struct thread_input *foreground_input; /* thread input of foreground thread */
     unsigned int         users;            /* processes and threads using this desktop */
     struct global_cursor cursor;           /* global cursor information */
-    unsigned char        keystate[256];    /* asynchronous key state */
+    unsigned char       *keystate;         /* asynchronous key state, stored in the shared memory */
+    struct mapping      *shared_mapping;   /* mapping of the state shared with the clients */
+    volatile struct desktop_shared_memory *shared; /* server-side view of the shared mapping */
+    unsigned int         hook_counts[32];  /* number of hooks of each kind set on the desktop */
 };
 
 /* user handles functions */
@@ -183,6 +186,7 @@ extern client_ptr_t get_class_client_ptr( struct window_class *class );
 extern struct desktop *get_desktop_obj( struct process *process, obj_handle_t handle, unsigned int access );
 extern struct winstation *get_process_winstation( struct process *process, unsigned int access );
 extern struct desktop *get_thread_desktop( struct thread *thread, unsigned int access );
+extern void update_desktop_hooks( struct desktop *desktop, int index, int incr );
 extern void connect_process_winstation( struct process *process, struct thread *parent );
 extern void set_process_default_desktop( struct process *process, struct desktop *desktop,
                                          obj_handle_t handle );
@@ -23,6 +23,9 @@
 
 #include <stdio.h>
 #include <stdarg.h>
+#ifdef HAVE_SYS_MMAN_H
+# include <sys/mman.h>
+#endif
 
 #include "ntstatus.h"
 #define WIN32_NO_STATUS
@@ -203,6 +206,16 @@ struct winstation *get_process_winstation( struct process *process, unsigned int
                                                 access, &winstation_ops );
 }
 
+/* update the hooks published to the desktop clients when a hook is added, removed or freed */
+/* the clients will then refresh the active hooks bitmaps they cached */
+void update_desktop_hooks( struct desktop *desktop, int index, int incr )
+{
+    desktop->hook_counts[index] += incr;
+    if (desktop->hook_counts[index]) desktop->shared->active_hooks |= 1u << index;
+    else desktop->shared->active_hooks &= ~(1u << index);
+    desktop->shared->hooks_serial++;
+}
+
 /* retrieve a pointer to a desktop object */
 struct desktop *get_desktop_obj( struct process *process, obj_handle_t handle, unsigned int access )
 {
@@ -228,10 +241,18 @@ static struct desktop *create_desktop( const struct unicode_str *name, unsigned
             desktop->close_timeout = NULL;
             desktop->foreground_input = NULL;
             desktop->users = 0;
+            desktop->shared = NULL;
+            memset( desktop->hook_counts, 0, sizeof(desktop->hook_counts) );
             memset( &desktop->cursor, 0, sizeof(desktop->cursor) );
-            memset( desktop->keystate, 0, sizeof(desktop->keystate) );
             list_add_tail( &winstation->desktops, &desktop->entry );
             list_init( &desktop->hotkeys );
+            if (!(desktop->shared_mapping = create_shared_mapping( sizeof(*desktop->shared),
+                                                                   (void **)&desktop->shared )))
+            {
+                release_object( desktop );
+                return NULL;
+            }
+            desktop->keystate = (unsigned char *)desktop->shared->keystate;
         }
         else clear_error();
     }
@@ -291,6 +312,8 @@ static void desktop_destroy( struct object *obj )
     if (desktop->msg_window) destroy_window( desktop->msg_window );
     if (desktop->global_hooks) release_object( desktop->global_hooks );
     if (desktop->close_timeout) remove_timeout_user( desktop->close_timeout );
+    if (desktop->shared) munmap( (void *)desktop->shared, sizeof(*desktop->shared) );
+    if (desktop->shared_mapping) release_object( desktop->shared_mapping );
     list_remove( &desktop->entry );
     release_object( desktop->winstation );
 }
@@ -635,6 +658,18 @@ DECL_HANDLER(set_thread_desktop)
 }
 
 
+/* get a handle to the shared memory of the thread desktop */
+DECL_HANDLER(get_desktop_shared_memory)
+{
+    struct desktop *desktop;
+
+    if (!(desktop = get_thread_desktop( current, 0 ))) return;
+    reply->handle = alloc_handle( current->process, desktop->shared_mapping,
+                                  SECTION_QUERY | SECTION_MAP_READ, 0 );
+    release_object( desktop );
+}
+
+
 /* get/set information about a user object (window station or desktop) */
 DECL_HANDLER(set_user_object_info)
 {